@@ -979,6 +979,54 @@ CsmaNetDevice::Send (Ptr<Packet> packet,const Address& dest, uint16_t protocolNu
   return SendFrom (packet, m_address, dest, protocolNumber);
 }
 
+uint32_t
+CsmaNetDevice::SendBurst (std::vector<Ptr<Packet> > const &packets, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (packets.size () << dest << protocolNumber);
+
+  NS_ASSERT (IsLinkUp ());
+
+  if (IsSendEnabled () == false)
+    {
+      for (std::vector<Ptr<Packet> >::const_iterator i = packets.begin (); i != packets.end (); ++i)
+        {
+          m_macTxDropTrace (*i);
+        }
+      return 0;
+    }
+
+  Mac48Address destination = Mac48Address::ConvertFrom (dest);
+  uint32_t accepted = 0;
+  for (std::vector<Ptr<Packet> >::const_iterator i = packets.begin (); i != packets.end (); ++i)
+    {
+      Ptr<Packet> packet = *i;
+      AddHeader (packet, m_address, destination, protocolNumber);
+      m_macTxTrace (packet);
+      if (m_queue->Enqueue (packet))
+        {
+          accepted++;
+          //
+          // As in SendFrom, an idle transmitter starts on the first packet
+          // right away, so that the burst drops the same packets as the
+          // same sequence of Send calls; the rest of the queue is drained
+          // by TransmitReadyEvent as usual.
+          //
+          if (m_txMachineState == READY)
+            {
+              m_currentPkt = m_queue->Dequeue ();
+              m_promiscSnifferTrace (m_currentPkt);
+              m_snifferTrace (m_currentPkt);
+              TransmitStart ();
+            }
+        }
+      else
+        {
+          m_macTxDropTrace (packet);
+        }
+    }
+  return accepted;
+}
+
 bool
 CsmaNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& dest, uint16_t protocolNumber)
 {
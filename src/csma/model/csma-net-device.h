@@ -274,6 +274,20 @@ public:
   virtual bool Send (Ptr<Packet> packet, const Address& dest, 
                      uint16_t protocolNumber);
 
+  /**
+   * Start sending a burst of packets down the channel.
+   *
+   * The device state is checked once for the whole burst; each packet is
+   * then framed and queued as by Send.  See NetDevice::SendBurst.
+   *
+   * \param packets packets to send, in order
+   * \param dest layer 2 destination address
+   * \param protocolNumber protocol number
+   * \return the number of packets queued for transmission
+   */
+  virtual uint32_t SendBurst (std::vector<Ptr<Packet> > const &packets, const Address& dest,
+                              uint16_t protocolNumber);
+
   /**
    * Start sending a packet down the channel, with MAC spoofing
    * \param packet packet to send
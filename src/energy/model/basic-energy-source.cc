@@ -187,6 +187,21 @@ BasicEnergySource::UpdateEnergySource (void)
                                              this);
 }
 
+bool
+BasicEnergySource::IsBatteryThresholdCrossed (void)
+{
+  NS_LOG_FUNCTION (this);
+  // same computation as CalculateRemainingEnergy, without updating
+  Time duration = Simulator::Now () - m_lastUpdateTime;
+  double energyToDecreaseJ = (CalculateTotalCurrent () * m_supplyVoltageV * duration.GetNanoSeconds ()) / 1e9;
+  double remainingEnergyJ = m_remainingEnergyJ - energyToDecreaseJ;
+  if (m_depleted)
+    {
+      return remainingEnergyJ > m_highBatteryTh * m_initialEnergyJ;
+    }
+  return remainingEnergyJ <= m_lowBatteryTh * m_initialEnergyJ;
+}
+
 /*
  * Private functions start here.
  */
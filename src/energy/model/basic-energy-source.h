@@ -74,6 +74,15 @@ public:
    */
   virtual void UpdateEnergySource (void);
 
+  /**
+   * \returns True if updating the energy source now would notify the
+   * device energy models that the energy is depleted or recharged.
+   *
+   * Device energy models which leave the energy source alone while their
+   * current is unchanged use this to not delay these notifications.
+   */
+  bool IsBatteryThresholdCrossed (void);
+
   /**
    * \param initialEnergyJ Initial energy, in Joules
    *
@@ -35,6 +35,21 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+/// Shared pcapng file used by PcapHelper::CreateFile, if enabled
+static Ptr<PcapNgFile> g_mergedPcapNg;
+/// Whether a close of the merged pcapng file is already scheduled with Simulator::ScheduleDestroy
+static bool g_mergedPcapNgDestroyScheduled = false;
+
+/**
+ * Close the merged pcapng file on Simulator::Destroy
+ */
+static void
+DestroyMergedPcapNg (void)
+{
+  g_mergedPcapNgDestroyScheduled = false;
+  PcapHelper::DisableMergedPcapNg ();
+}
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -53,9 +68,44 @@ PcapHelper::CreateFile (
   uint32_t    snapLen, 
   int32_t     tzCorrection)
 {
-  NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
+  return CreateFile (filename, filemode, dataLinkType, 0, snapLen, tzCorrection);
+}
+
+Ptr<PcapFileWrapper>
+PcapHelper::CreateFile (
+  std::string filename,
+  std::ios::openmode filemode,
+  DataLinkType dataLinkType,
+  Ptr<NetDevice> device,
+  uint32_t    snapLen,
+  int32_t     tzCorrection)
+{
+  NS_LOG_FUNCTION (filename << filemode << dataLinkType << device << snapLen << tzCorrection);
 
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  if (g_mergedPcapNg)
+    {
+      NS_ABORT_MSG_UNLESS (filemode == std::ios::out, "Merged pcapng traces can only be written");
+      std::string name = filename;
+      std::string::size_type pos = name.rfind (".pcap");
+      if (pos != std::string::npos && pos + 5 == name.size ())
+        {
+          name.erase (pos);
+        }
+      if (device && device->GetNode ())
+        {
+          file->Attach (g_mergedPcapNg, name, "ns-3 trace " + filename,
+                        device->GetNode ()->GetId (), device->GetIfIndex ());
+        }
+      else
+        {
+          file->Attach (g_mergedPcapNg, name, "ns-3 trace " + filename);
+        }
+      file->Init (dataLinkType, snapLen, tzCorrection);
+      NS_ABORT_MSG_IF (file->Fail (), "Unable to add " << name << " to the merged pcapng file");
+      return file;
+    }
+
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -76,6 +126,33 @@ PcapHelper::CreateFile (
   return file;
 }
 
+void
+PcapHelper::EnableMergedPcapNg (std::string filename, PcapAsyncWriter::Compression compression)
+{
+  NS_LOG_FUNCTION (filename << compression);
+  DisableMergedPcapNg ();
+  g_mergedPcapNg = Create<PcapNgFile> ();
+  bool ok = g_mergedPcapNg->Open (filename, compression);
+  NS_ABORT_MSG_UNLESS (ok, "Unable to Open " << filename);
+  if (!g_mergedPcapNgDestroyScheduled)
+    {
+      Simulator::ScheduleDestroy (&DestroyMergedPcapNg);
+      g_mergedPcapNgDestroyScheduled = true;
+    }
+}
+
+void
+PcapHelper::DisableMergedPcapNg (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  if (g_mergedPcapNg)
+    {
+      // Wrappers still referencing the file only keep an inert object alive
+      g_mergedPcapNg->Close ();
+      g_mergedPcapNg = 0;
+    }
+}
+
 std::string
 PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -109,6 +109,27 @@ public:
                                    DataLinkType dataLinkType,
                                    uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
                                    int32_t tzCorrection = 0);
+
+  /**
+   * @brief Create and initialize a pcap file for the trace of a device.
+   *
+   * If the merged pcapng file is enabled, its interface for this trace
+   * carries the node and device IDs of the device.
+   *
+   * @param filename file name
+   * @param filemode file mode
+   * @param dataLinkType data link type of packet data
+   * @param device the traced device
+   * @param snapLen maximum length of packet data stored in records
+   * @param tzCorrection time zone correction to be applied to timestamps of packets
+   * @returns a smart pointer to the Pcap file
+   */
+  Ptr<PcapFileWrapper> CreateFile (std::string filename,
+                                   std::ios::openmode filemode,
+                                   DataLinkType dataLinkType,
+                                   Ptr<NetDevice> device,
+                                   uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
+                                   int32_t tzCorrection = 0);
   /**
    * @brief Hook a trace source to the default trace sink
    * 
@@ -118,6 +139,29 @@ public:
    */
   template <typename T> void HookDefaultSink (Ptr<T> object, std::string traceName, Ptr<PcapFileWrapper> file);
 
+  /**
+   * @brief Merge all subsequently created pcap traces into one pcapng file
+   *
+   * Once enabled, CreateFile no longer opens a file per trace.  Instead,
+   * every trace becomes an interface of a single shared pcapng file, named
+   * after the file name the trace would otherwise have had (by default
+   * prefix-node-device), and its packets are written as Enhanced Packet
+   * Blocks referring to that interface.  Traces created for a device
+   * also carry the node and device IDs in every Enhanced Packet Block.  The file is closed on
+   * Simulator::Destroy, or by DisableMergedPcapNg.
+   *
+   * @param filename name of the merged pcapng file
+   * @param compression output compression
+   */
+  static void EnableMergedPcapNg (std::string filename,
+                                  PcapAsyncWriter::Compression compression = PcapAsyncWriter::NONE);
+
+  /**
+   * @brief Close the merged pcapng file, if any, and return to one pcap
+   * file per trace
+   */
+  static void DisableMergedPcapNg (void);
+
 private:
   /**
    * The basic default trace sink.
@@ -41,4 +41,19 @@ NetDevice::~NetDevice ()
   NS_LOG_FUNCTION (this);
 }
 
+uint32_t
+NetDevice::SendBurst (std::vector<Ptr<Packet> > const &packets, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packets.size () << dest << protocolNumber);
+  uint32_t accepted = 0;
+  for (std::vector<Ptr<Packet> >::const_iterator i = packets.begin (); i != packets.end (); ++i)
+    {
+      if (Send (*i, dest, protocolNumber))
+        {
+          accepted++;
+        }
+    }
+  return accepted;
+}
+
 } // namespace ns3
@@ -22,6 +22,7 @@
 #define NET_DEVICE_H
 
 #include <stdint.h>
+#include <vector>
 #include "ns3/callback.h"
 #include "ns3/object.h"
 #include "ns3/ptr.h"
@@ -246,6 +247,22 @@ public:
    * \return whether the Send operation succeeded 
    */
   virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber) = 0;
+  /**
+   * \param packets packets sent from above down to Network Device, in order
+   * \param dest mac address of the destination (already resolved)
+   * \param protocolNumber identifies the type of payload contained in
+   *        these packets.
+   *
+   *  Called by code that sends several packets to the same destination
+   *  directly to the device, such as traffic generators.  The traffic
+   *  control layer does not use it: it hands packets over one at a time,
+   *  as its queue discs check flow control per packet.  The default
+   *  implementation calls Send for each packet; devices may override it
+   *  to check the link state once per burst.
+   *
+   * \return the number of packets accepted by the device
+   */
+  virtual uint32_t SendBurst (std::vector<Ptr<Packet> > const &packets, const Address& dest, uint16_t protocolNumber);
   /**
    * \param packet packet sent from above down to Network Device
    * \param source source mac address (so called "MAC spoofing")
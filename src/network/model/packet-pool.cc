@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include <new>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "packet-pool.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketPool");
+
+namespace {
+
+/// Block size classes, in bytes
+const uint32_t g_sizeClasses[PacketPool::N_SIZE_CLASSES] = { 64, 256, 1600, PacketPool::MAX_BLOCK_SIZE };
+
+/**
+ * \brief The free lists of one thread
+ */
+struct Cache
+{
+  Cache () : packetSize (0) {}
+  std::size_t packetSize;                                   //!< size of a Packet object
+  std::vector<void *> packets;                              //!< free Packet objects
+  std::vector<void *> blocks[PacketPool::N_SIZE_CLASSES];   //!< free blocks of each size class
+};
+
+/**
+ * \brief Frees the cache of a thread when the thread exits
+ */
+struct CacheDestructor
+{
+  ~CacheDestructor ();
+};
+
+/*
+ * The cache pointer has three states, like the buffer free list it
+ * replaces: null until the thread first needs it, a valid pointer, or
+ * DESTROYED once the thread-local destructors have run.  Memory released
+ * after that point (e.g., by static destructors) goes straight back to the
+ * heap instead of re-creating the cache.
+ */
+#define DESTROYED ((Cache *) ~(uintptr_t) 0)
+
+thread_local Cache *g_cache = 0;                     //!< the free lists of this thread
+thread_local CacheDestructor g_cacheDestructor;      //!< frees g_cache at thread exit
+thread_local PacketPool::Stats g_stats;              //!< the counters of this thread
+
+CacheDestructor::~CacheDestructor ()
+{
+  if (g_cache != 0 && g_cache != DESTROYED)
+    {
+      for (std::vector<void *>::iterator i = g_cache->packets.begin (); i != g_cache->packets.end (); ++i)
+        {
+          ::operator delete (*i);
+        }
+      for (uint32_t c = 0; c < PacketPool::N_SIZE_CLASSES; c++)
+        {
+          for (std::vector<void *>::iterator i = g_cache->blocks[c].begin (); i != g_cache->blocks[c].end (); ++i)
+            {
+              ::operator delete (*i);
+            }
+        }
+      delete g_cache;
+    }
+  g_cache = DESTROYED;
+}
+
+/**
+ * \return the cache of the calling thread, or null if it was destroyed
+ */
+inline Cache *
+GetCache (void)
+{
+  if (g_cache == 0)
+    {
+      g_cache = new Cache ();
+      // First use of the thread-local guard registers its destructor.
+      (void) &g_cacheDestructor;
+    }
+  return g_cache == DESTROYED ? 0 : g_cache;
+}
+
+} // unnamed namespace
+
+uint32_t
+PacketPool::GetSizeClass (uint32_t size)
+{
+  uint32_t c = 0;
+  while (c < N_SIZE_CLASSES && g_sizeClasses[c] < size)
+    {
+      c++;
+    }
+  return c;
+}
+
+uint32_t
+PacketPool::GetBlockSize (uint32_t size)
+{
+  uint32_t c = GetSizeClass (size);
+  return c < N_SIZE_CLASSES ? g_sizeClasses[c] : size;
+}
+
+void *
+PacketPool::Allocate (uint32_t size)
+{
+  NS_LOG_FUNCTION (size);
+  g_stats.nBlockAllocs++;
+  uint32_t c = GetSizeClass (size);
+  if (c < N_SIZE_CLASSES)
+    {
+      Cache *cache = GetCache ();
+      if (cache != 0 && !cache->blocks[c].empty ())
+        {
+          void *p = cache->blocks[c].back ();
+          cache->blocks[c].pop_back ();
+          return p;
+        }
+      size = g_sizeClasses[c];
+    }
+  g_stats.nBlockHeapAllocs++;
+  return ::operator new (size);
+}
+
+void
+PacketPool::Release (void *p, uint32_t size)
+{
+  NS_LOG_FUNCTION (p << size);
+  uint32_t c = GetSizeClass (size);
+  if (c < N_SIZE_CLASSES)
+    {
+      Cache *cache = GetCache ();
+      if (cache != 0 && cache->blocks[c].size () < MAX_FREE)
+        {
+          cache->blocks[c].push_back (p);
+          return;
+        }
+    }
+  g_stats.nHeapFrees++;
+  ::operator delete (p);
+}
+
+void *
+PacketPool::AllocatePacket (std::size_t size)
+{
+  NS_LOG_FUNCTION (size);
+  g_stats.nPacketAllocs++;
+  Cache *cache = GetCache ();
+  if (cache != 0)
+    {
+      NS_ASSERT (cache->packetSize == 0 || cache->packetSize == size);
+      cache->packetSize = size;
+      if (!cache->packets.empty ())
+        {
+          void *p = cache->packets.back ();
+          cache->packets.pop_back ();
+          return p;
+        }
+    }
+  g_stats.nPacketHeapAllocs++;
+  return ::operator new (size);
+}
+
+void
+PacketPool::ReleasePacket (void *p, std::size_t size)
+{
+  NS_LOG_FUNCTION (p << size);
+  Cache *cache = GetCache ();
+  if (cache != 0 && cache->packets.size () < MAX_FREE)
+    {
+      NS_ASSERT (cache->packetSize == 0 || cache->packetSize == size);
+      cache->packetSize = size;
+      cache->packets.push_back (p);
+      return;
+    }
+  g_stats.nHeapFrees++;
+  ::operator delete (p);
+}
+
+PacketPool::Stats
+PacketPool::GetStats (void)
+{
+  return g_stats;
+}
+
+void
+PacketPool::ResetStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_stats = Stats ();
+}
+
+} // namespace ns3
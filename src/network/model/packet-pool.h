@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Per-thread free lists for packet memory
+ *
+ * Packet objects, Buffer data areas and packet tag nodes are allocated
+ * and released at a very high rate.  Instead of returning them to the
+ * heap, this class keeps released memory on free lists private to the
+ * releasing thread: one list for Packet objects, and one list for each
+ * of the 64, 256, 1600 and 9000 byte block size classes.  Requests larger
+ * than the largest size class are served by the heap directly.
+ *
+ * Each list caches at most MAX_FREE entries.  Cached memory is returned to
+ * the heap when the thread exits.
+ */
+class PacketPool
+{
+public:
+  /**
+   * \brief Allocation counters of the calling thread
+   */
+  struct Stats
+  {
+    uint64_t nPacketAllocs;      //!< Packet objects allocated
+    uint64_t nPacketHeapAllocs;  //!< Packet objects not found on the free list
+    uint64_t nBlockAllocs;       //!< blocks allocated
+    uint64_t nBlockHeapAllocs;   //!< blocks not found on a free list
+    uint64_t nHeapFrees;         //!< Packet objects and blocks given back to the heap
+  };
+
+  /// Number of block size classes
+  static const uint32_t N_SIZE_CLASSES = 4;
+  /// Size of the largest block size class
+  static const uint32_t MAX_BLOCK_SIZE = 9000;
+  /// Maximum number of entries cached on each free list
+  static const uint32_t MAX_FREE = 1024;
+
+  /**
+   * \param size the requested size in bytes
+   * \return the usable size of the block Allocate (size) returns
+   */
+  static uint32_t GetBlockSize (uint32_t size);
+
+  /**
+   * \brief Allocate a block of at least size bytes
+   * \param size the requested size in bytes
+   * \return the block
+   */
+  static void * Allocate (uint32_t size);
+
+  /**
+   * \brief Release a block obtained from Allocate
+   * \param p the block
+   * \param size the size passed to Allocate, or the value returned by
+   *        GetBlockSize for it
+   */
+  static void Release (void *p, uint32_t size);
+
+  /**
+   * \brief Allocate memory for a Packet object
+   * \param size the size of the object, which must be the same for all calls
+   * \return the memory
+   */
+  static void * AllocatePacket (std::size_t size);
+
+  /**
+   * \brief Release memory obtained from AllocatePacket
+   * \param p the memory
+   * \param size the size of the object
+   */
+  static void ReleasePacket (void *p, std::size_t size);
+
+  /**
+   * \return the allocation counters of the calling thread
+   */
+  static Stats GetStats (void);
+
+  /**
+   * \brief Reset the allocation counters of the calling thread
+   */
+  static void ResetStats (void);
+
+private:
+  /**
+   * \param size the requested size in bytes
+   * \return the index of the smallest size class that fits size, or
+   *         N_SIZE_CLASSES if there is none
+   */
+  static uint32_t GetSizeClass (uint32_t size);
+};
+
+} // namespace ns3
+
+#endif /* PACKET_POOL_H */
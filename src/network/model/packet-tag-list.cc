@@ -43,8 +43,8 @@ PacketTagList::CreateTagData (size_t dataSize)
                  << " exceeds maximum "
                  << std::numeric_limits<decltype(TagData::size)>::max () );
 
-  void * p = std::malloc (sizeof (TagData) + dataSize - 1);
-  // The matching frees are in RemoveAll and RemoveWriter
+  void * p = PacketPool::Allocate (sizeof (TagData) + dataSize - 1);
+  // The matching releases are in RemoveAll and RemoveWriter
 
   TagData * tag = new (p) TagData;
   tag->size = dataSize;
@@ -194,8 +194,9 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
   if (preMerge)
     {
       // found tid before first merge, so delete cur
+      uint32_t size = cur->size;
       cur->~TagData ();
-      std::free (cur);
+      PacketPool::Release (cur, sizeof (TagData) + size - 1);
     }
   else
     {
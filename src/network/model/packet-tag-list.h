@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include <ostream>
 #include "ns3/type-id.h"
+#include "packet-pool.h"
 
 namespace ns3 {
 
@@ -341,15 +342,17 @@ PacketTagList::RemoveAll (void)
         }
       if (prev != 0) 
         {
+          uint32_t size = prev->size;
           prev->~TagData ();
-          std::free (prev);
+          PacketPool::Release (prev, sizeof (TagData) + size - 1);
         }
       prev = cur;
     }
   if (prev != 0) 
     {
+      uint32_t size = prev->size;
       prev->~TagData ();
-      std::free (prev);
+      PacketPool::Release (prev, sizeof (TagData) + size - 1);
     }
   m_next = 0;
 }
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "packet.h"
+#include "packet-pool.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -152,6 +153,18 @@ Packet::Packet (const Packet &o)
     : m_nixVector = 0;
 }
 
+void *
+Packet::operator new (size_t size)
+{
+  return PacketPool::AllocatePacket (size);
+}
+
+void
+Packet::operator delete (void *p, size_t size)
+{
+  PacketPool::ReleasePacket (p, size);
+}
+
 Packet &
 Packet::operator = (const Packet &o)
 {
@@ -248,6 +248,18 @@ public:
    * \return the copied object
    */
   Packet &operator = (const Packet &o);
+  /**
+   * \brief Allocate a packet object from the PacketPool
+   * \param size the object size
+   * \return the memory for the object
+   */
+  static void * operator new (size_t size);
+  /**
+   * \brief Give a packet object back to the PacketPool
+   * \param p the object memory
+   * \param size the object size
+   */
+  static void operator delete (void *p, size_t size);
   /**
    * \brief Create a packet with a zero-filled payload.
    *
@@ -83,6 +83,52 @@ DropTailQueueTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ ((packet == 0), true, "There are really no packets in there");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * DropTailQueue burst dequeue test.
+ */
+class DropTailQueueBurstTestCase : public TestCase
+{
+public:
+  DropTailQueueBurstTestCase ();
+  virtual void DoRun (void);
+};
+
+DropTailQueueBurstTestCase::DropTailQueueBurstTestCase ()
+  : TestCase ("Check DequeueBurst on the drop tail queue")
+{
+}
+void
+DropTailQueueBurstTestCase::DoRun (void)
+{
+  Ptr<DropTailQueue<Packet> > queue = CreateObject<DropTailQueue<Packet> > ();
+  Ptr<Packet> p[5];
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      p[i] = Create<Packet> (100);
+      queue->Enqueue (p[i]);
+    }
+
+  std::vector<Ptr<Packet> > burst;
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueBurst (burst, 3), 3, "Three packets should have been dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 2, "There should be two packets left");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 200, "There should be 200 bytes left");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalReceivedPackets () - queue->GetNPackets (), 3,
+                         "The dequeued packets should be accounted for");
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (burst[i]->GetUid (), p[i]->GetUid (), "Packets should come out in FIFO order");
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueBurst (burst, 10), 2, "Only two packets should be left to dequeue");
+  NS_TEST_EXPECT_MSG_EQ (burst.size (), 5, "The packets should be appended to the vector");
+  NS_TEST_EXPECT_MSG_EQ (burst[4]->GetUid (), p[4]->GetUid (), "Was this the last packet ?");
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueBurst (burst, 10), 0, "Nothing should be dequeued from an empty queue");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -96,6 +142,7 @@ public:
     : TestSuite ("drop-tail-queue", UNIT)
   {
     AddTestCase (new DropTailQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new DropTailQueueBurstTestCase (), TestCase::QUICK);
   }
 };
 
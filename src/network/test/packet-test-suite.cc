@@ -19,6 +19,7 @@
  */
 #include "ns3/packet.h"
 #include "ns3/packet-tag-list.h"
+#include "ns3/packet-pool.h"
 #include "ns3/test.h"
 #include "ns3/unused.h"
 #include <limits>     // std:numeric_limits
@@ -1035,6 +1036,61 @@ PacketTagListTest::DoRun (void)
     
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * PacketPool unit test.
+ */
+class PacketPoolTest : public TestCase
+{
+public:
+  PacketPoolTest ();
+  virtual void DoRun (void);
+};
+
+PacketPoolTest::PacketPoolTest ()
+  : TestCase ("PacketPool")
+{
+}
+
+void
+PacketPoolTest::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (PacketPool::GetBlockSize (1), 64, "Small blocks should use the 64 byte class");
+  NS_TEST_EXPECT_MSG_EQ (PacketPool::GetBlockSize (257), 1600, "Blocks should be rounded up to a size class");
+  NS_TEST_EXPECT_MSG_EQ (PacketPool::GetBlockSize (20000), 20000, "Large blocks should not be pooled");
+
+  // A released block is handed out again without touching the heap
+  void *block = PacketPool::Allocate (200);
+  PacketPool::Release (block, 200);
+  PacketPool::ResetStats ();
+  void *again = PacketPool::Allocate (256);
+  NS_TEST_EXPECT_MSG_EQ (again, block, "The released block should be reused");
+  NS_TEST_EXPECT_MSG_EQ (PacketPool::GetStats ().nBlockHeapAllocs, 0, "No heap allocation expected");
+  PacketPool::Release (again, 256);
+
+  // Steady-state packet processing should not allocate from the heap
+  ATestHeader<10> header;
+  ATestTag<4> tag;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      p->AddHeader (header);
+      p->AddPacketTag (tag);
+      Ptr<Packet> copy = p->Copy ();
+      copy->RemoveHeader (header);
+      if (i == 4)
+        {
+          PacketPool::ResetStats ();
+        }
+    }
+  PacketPool::Stats stats = PacketPool::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.nPacketAllocs, 10, "Two packets per iteration expected");
+  NS_TEST_EXPECT_MSG_EQ (stats.nPacketHeapAllocs, 0, "Packet objects should come from the pool");
+  NS_TEST_EXPECT_MSG_EQ (stats.nBlockHeapAllocs, 0, "Buffers and tags should come from the pool");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1052,6 +1108,7 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketPoolTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
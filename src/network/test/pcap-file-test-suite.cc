@@ -20,11 +20,16 @@
 #include <cstdio>
 #include <cstdlib>
 #include <sstream>
+#include <fstream>
+#include <iterator>
 #include <cstring>
+#include <vector>
 
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/pcap-file-reader.h"
+#include "ns3/pcapng-file.h"
 
 using namespace ns3;
 
@@ -1142,6 +1147,335 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (diff, true, "PcapDiff(file, file2) must be true");
   NS_TEST_EXPECT_MSG_EQ (sec,  2, "Files are different from 2.3696 seconds");
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
+
+  //
+  // Check that a file which cannot be read is reported apart from a difference
+  //
+  bool fail (true);
+  packets = 0;
+  diff = PcapFile::Diff (filename, filename2, sec, usec, packets, fail);
+  NS_TEST_EXPECT_MSG_EQ (diff, true, "PcapDiff(file, file2) must be true");
+  NS_TEST_EXPECT_MSG_EQ (fail, false, "Both files can be read");
+
+  packets = 0;
+  diff = PcapFile::Diff (filename, "does-not-exist.pcap", sec, usec, packets, fail);
+  NS_TEST_EXPECT_MSG_EQ (diff, true, "PcapDiff(file, missing) must be true");
+  NS_TEST_EXPECT_MSG_EQ (fail, true, "A missing file cannot be read");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that buffered (asynchronous) writing
+ * produces exactly the same file as the unbuffered path.
+ */
+class BufferedWriteTestCase : public TestCase
+{
+public:
+  BufferedWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BufferedWriteTestCase::BufferedWriteTestCase ()
+  : TestCase ("Check that buffered PcapFile output matches unbuffered output")
+{
+}
+
+void
+BufferedWriteTestCase::DoRun (void)
+{
+  std::string plainName = CreateTempDirFilename ("unbuffered.pcap");
+  std::string bufferedName = CreateTempDirFilename ("buffered.pcap");
+  const uint32_t nRecords = 2000;
+  const uint32_t snapLen = 1500;
+  uint8_t data[2048];
+  for (uint32_t i = 0; i < sizeof (data); ++i)
+    {
+      data[i] = i & 0xff;
+    }
+
+  PcapFile plain;
+  PcapFile buffered;
+  // A small buffer forces many hand-overs and records larger than a buffer
+  buffered.SetWriteBufferSize (512);
+
+  plain.Open (plainName, std::ios::out);
+  buffered.Open (bufferedName, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (plain.Fail (), false, "Open (" << plainName << ") returns error");
+  NS_TEST_ASSERT_MSG_EQ (buffered.Fail (), false, "Open (" << bufferedName << ") returns error");
+  plain.Init (1, snapLen);
+  buffered.Init (1, snapLen);
+
+  for (uint32_t i = 0; i < nRecords; ++i)
+    {
+      // Record sizes cover tiny, buffer-sized and snaplen-truncated packets
+      uint32_t len = (i * 97) % sizeof (data);
+      plain.Write (i / 1000, i % 1000, data, len);
+      buffered.Write (i / 1000, i % 1000, data, len);
+      NS_TEST_ASSERT_MSG_EQ (buffered.Fail (), false, "Buffered Write must not fail");
+    }
+  plain.Close ();
+  buffered.Close ();
+  NS_TEST_ASSERT_MSG_EQ (buffered.Fail (), false, "Buffered Close must not fail");
+
+  uint32_t sec (0), usec (0), packets (0);
+  bool diff = PcapFile::Diff (plainName, bufferedName, sec, usec, packets, snapLen);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Buffered and unbuffered files differ");
+  NS_TEST_EXPECT_MSG_EQ (packets, nRecords, "Unexpected number of records");
+
+  FILE * p = std::fopen (plainName.c_str (), "rb");
+  std::fseek (p, 0, SEEK_END);
+  uint64_t plainSize = std::ftell (p);
+  std::fclose (p);
+  NS_TEST_EXPECT_MSG_EQ (CheckFileLength (bufferedName, plainSize), true,
+                         "Buffered file has a different length");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the memory-mapped reader indexes
+ * pcap and pcapng files correctly.
+ */
+class FileReaderTestCase : public TestCase
+{
+public:
+  FileReaderTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FileReaderTestCase::FileReaderTestCase ()
+  : TestCase ("Check that PcapFileReader reads pcap and pcapng files")
+{
+}
+
+/**
+ * Append a 32-bit value in host byte order
+ * \param v the buffer
+ * \param val the value
+ */
+static void
+Append32 (std::vector<uint8_t> &v, uint32_t val)
+{
+  uint8_t b[4];
+  std::memcpy (b, &val, 4);
+  v.insert (v.end (), b, b + 4);
+}
+
+void
+FileReaderTestCase::DoRun (void)
+{
+  //
+  // The known good pcap file, through the record index
+  //
+  PcapFileReader reader;
+  std::string filename = CreateDataDirFilename ("known.pcap");
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot map " << filename);
+  NS_TEST_ASSERT_MSG_EQ (reader.IsPcapNg (), false, "known.pcap is not a pcapng file");
+  NS_TEST_ASSERT_MSG_EQ (reader.IsTruncated (), false, "known.pcap is not truncated");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetNRecords (), N_KNOWN_PACKETS, "Wrong number of records");
+  uint32_t i = 0;
+  for (PcapFileReader::Iterator it = reader.Begin (); it != reader.End (); ++it, ++i)
+    {
+      PacketEntry const & p = knownPackets[i];
+      NS_TEST_EXPECT_MSG_EQ (it->tsSec, p.tsSec, "Wrong seconds timestamp in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (it->tsUsec, p.tsUsec, "Wrong microseconds timestamp in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (it->inclLen, p.inclLen, "Wrong included length in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (it->origLen, p.origLen, "Wrong original length in record " << i);
+      //
+      // knownPackets holds the 16 big-endian 16-bit words that follow the
+      // 14-byte Ethernet header of each frame.
+      //
+      bool same = it->inclLen >= 14 + 2 * N_PACKET_BYTES;
+      for (uint32_t j = 0; same && j < N_PACKET_BYTES; ++j)
+        {
+          same = ((it->data[14 + 2 * j] << 8) | it->data[15 + 2 * j]) == p.data[j];
+        }
+      NS_TEST_EXPECT_MSG_EQ (same, true, "Wrong data in record " << i);
+    }
+  reader.Close ();
+
+  //
+  // A pcapng file with one nanosecond-resolution interface and two
+  // Enhanced Packet Blocks, and the equivalent nanosecond pcap file
+  //
+  uint8_t payload[6] = { 1, 2, 3, 4, 5, 6 };
+  std::vector<uint8_t> ng;
+  Append32 (ng, 0x0a0d0d0a);    // SHB
+  Append32 (ng, 28);
+  Append32 (ng, 0x1a2b3c4d);
+  Append32 (ng, 0x00000001);    // version 1.0
+  Append32 (ng, 0xffffffff);    // unknown section length
+  Append32 (ng, 0xffffffff);
+  Append32 (ng, 28);
+  Append32 (ng, 1);             // IDB
+  Append32 (ng, 32);
+  Append32 (ng, 1);             // link type 1, reserved
+  Append32 (ng, 65535);         // snap length
+  Append32 (ng, 0x00010009);    // if_tsresol, length 1
+  Append32 (ng, 9);             // 10^-9
+  Append32 (ng, 0);             // opt_endofopt
+  Append32 (ng, 32);
+  for (uint32_t k = 0; k < 2; ++k)
+    {
+      uint64_t ts = (k + 2) * 1000000000ULL + 123456789;
+      Append32 (ng, 6);         // EPB
+      Append32 (ng, 40);
+      Append32 (ng, 0);         // interface
+      Append32 (ng, ts >> 32);
+      Append32 (ng, ts & 0xffffffff);
+      Append32 (ng, sizeof (payload));
+      Append32 (ng, sizeof (payload));
+      ng.insert (ng.end (), payload, payload + sizeof (payload));
+      ng.insert (ng.end (), 2, 0);
+      Append32 (ng, 40);
+    }
+  std::string ngName = CreateTempDirFilename ("reader.pcapng");
+  FILE * f = std::fopen (ngName.c_str (), "wb");
+  NS_TEST_ASSERT_MSG_NE (f, 0, "Cannot create " << ngName);
+  std::fwrite (&ng[0], 1, ng.size (), f);
+  std::fclose (f);
+
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (ngName), true, "Cannot map " << ngName);
+  NS_TEST_EXPECT_MSG_EQ (reader.IsPcapNg (), true, "File must be detected as pcapng");
+  NS_TEST_EXPECT_MSG_EQ (reader.IsNanoSecMode (), true, "Interface resolution is nanoseconds");
+  NS_TEST_EXPECT_MSG_EQ (reader.GetDataLinkType (), 1, "Wrong link type");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetNRecords (), 2, "Wrong number of records");
+  NS_TEST_EXPECT_MSG_EQ (reader.GetRecord (1).tsSec, 3, "Wrong seconds timestamp");
+  NS_TEST_EXPECT_MSG_EQ (reader.GetRecord (1).tsUsec, 123456789, "Wrong nanoseconds timestamp");
+  NS_TEST_EXPECT_MSG_EQ (reader.GetRecord (1).inclLen, sizeof (payload), "Wrong included length");
+  NS_TEST_EXPECT_MSG_EQ (std::memcmp (reader.GetRecord (1).data, payload, sizeof (payload)), 0, "Wrong data");
+  reader.Close ();
+
+  std::string pcapName = CreateTempDirFilename ("reader.pcap");
+  PcapFile pcap;
+  pcap.Open (pcapName, std::ios::out);
+  pcap.Init (1, 65535, PcapFile::ZONE_DEFAULT, false, true);
+  pcap.Write (2, 123456789, payload, sizeof (payload));
+  pcap.Write (3, 123456789, payload, sizeof (payload));
+  pcap.Close ();
+
+  uint32_t sec (0), usec (0), packets (0);
+  bool diff = PcapFile::Diff (pcapName, ngName, sec, usec, packets);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Equivalent pcap and pcapng files must not differ");
+  NS_TEST_EXPECT_MSG_EQ (packets, 2, "Both records must have been compared");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that a shared pcapng file written by
+ * PcapNgFile can be read back with one interface per traced device.
+ */
+class PcapNgWriteTestCase : public TestCase
+{
+public:
+  PcapNgWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapNgWriteTestCase::PcapNgWriteTestCase ()
+  : TestCase ("Check that PcapNgFile writes a readable multi-interface file")
+{
+}
+
+void
+PcapNgWriteTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("merged.pcapng");
+  uint8_t data[100];
+  for (uint32_t i = 0; i < sizeof (data); ++i)
+    {
+      data[i] = i;
+    }
+
+  {
+    PcapNgFile ng;
+    NS_TEST_ASSERT_MSG_EQ (ng.Open (filename), true, "Cannot create " << filename);
+    uint32_t if0 = ng.AddInterface (1, 65535, "trace-0-1", "node 0 device 1", 0, 0, 1);
+    uint32_t if1 = ng.AddInterface (105, 50, "trace-1-0", "node 1 device 0", -3600);
+    NS_TEST_EXPECT_MSG_EQ (if0, 0, "First interface must have ID 0");
+    NS_TEST_EXPECT_MSG_EQ (if1, 1, "Second interface must have ID 1");
+    ng.Write (if0, 1000000001ULL, data, 13);
+    ng.Write (if1, 2000000002ULL, data, sizeof (data));
+    ng.Write (if0, 3000000003ULL, data, 64);
+    ng.Close ();
+    NS_TEST_EXPECT_MSG_EQ (ng.Fail (), false, "Writing the pcapng file failed");
+  }
+
+  PcapFileReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot read back " << filename);
+  NS_TEST_EXPECT_MSG_EQ (reader.IsPcapNg (), true, "File must be pcapng");
+  NS_TEST_EXPECT_MSG_EQ (reader.IsTruncated (), false, "File must not be truncated");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetNInterfaces (), 2, "Wrong number of interfaces");
+  NS_TEST_EXPECT_MSG_EQ (reader.GetInterfaceDataLinkType (1), 105, "Wrong link type of interface 1");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetNRecords (), 3, "Wrong number of records");
+
+  PcapFileReader::Record const &r0 = reader.GetRecord (0);
+  NS_TEST_EXPECT_MSG_EQ (r0.interfaceId, 0, "Wrong interface of record 0");
+  NS_TEST_EXPECT_MSG_EQ (r0.tsSec, 1, "Wrong seconds timestamp of record 0");
+  NS_TEST_EXPECT_MSG_EQ (r0.tsUsec, 1, "Wrong nanoseconds timestamp of record 0");
+  NS_TEST_EXPECT_MSG_EQ (r0.inclLen, 13, "Wrong length of record 0");
+  NS_TEST_EXPECT_MSG_EQ (std::memcmp (r0.data, data, 13), 0, "Wrong data in record 0");
+
+  PcapFileReader::Record const &r1 = reader.GetRecord (1);
+  NS_TEST_EXPECT_MSG_EQ (r1.interfaceId, 1, "Wrong interface of record 1");
+  NS_TEST_EXPECT_MSG_EQ (r1.inclLen, 50, "Record 1 must be truncated to the interface snap length");
+  NS_TEST_EXPECT_MSG_EQ (r1.origLen, sizeof (data), "Wrong original length of record 1");
+
+  PcapFileReader::Record const &r2 = reader.GetRecord (2);
+  NS_TEST_EXPECT_MSG_EQ (r2.interfaceId, 0, "Wrong interface of record 2");
+  NS_TEST_EXPECT_MSG_EQ (r2.tsSec, 3, "Wrong seconds timestamp of record 2");
+  reader.Close ();
+
+  //
+  // The packets of interface 0 carry its node and device IDs in an
+  // opt_comment option; interface 1 has none, but a timestamp offset.
+  //
+  std::ifstream in (filename.c_str (), std::ios::binary);
+  std::string contents ((std::istreambuf_iterator<char> (in)), std::istreambuf_iterator<char> ());
+  std::string::size_type first = contents.find ("node=0 device=1");
+  NS_TEST_EXPECT_MSG_NE (first, std::string::npos, "Missing node/device option");
+  NS_TEST_EXPECT_MSG_NE (contents.find ("node=0 device=1", first + 1), std::string::npos,
+                         "Both packets of interface 0 must carry the node/device option");
+  int64_t offset = -3600;
+  NS_TEST_EXPECT_MSG_NE (contents.find (std::string (reinterpret_cast<char const *> (&offset), 8)),
+                         std::string::npos, "Missing if_tsoffset option");
+
+  if (PcapAsyncWriter::IsCompressionSupported (PcapAsyncWriter::GZIP))
+    {
+      std::string gzName = CreateTempDirFilename ("merged.pcapng.gz");
+      {
+        PcapNgFile ng;
+        NS_TEST_ASSERT_MSG_EQ (ng.Open (gzName, PcapAsyncWriter::GZIP), true, "Cannot create " << gzName);
+        uint32_t ifId = ng.AddInterface (1, 65535, "trace-0-0", "node 0 device 0");
+        for (uint32_t i = 0; i < 1000; ++i)
+          {
+            ng.Write (ifId, i * 1000ULL, data, sizeof (data));
+          }
+        ng.Close ();
+        NS_TEST_EXPECT_MSG_EQ (ng.Fail (), false, "Writing the compressed file failed");
+      }
+      FILE * f = std::fopen (gzName.c_str (), "rb");
+      NS_TEST_ASSERT_MSG_NE (f, 0, "Cannot open " << gzName);
+      uint8_t magic[2] = { 0, 0 };
+      size_t n = std::fread (magic, 1, 2, f);
+      std::fseek (f, 0, SEEK_END);
+      long size = std::ftell (f);
+      std::fclose (f);
+      NS_TEST_EXPECT_MSG_EQ (n, 2, "Compressed file is empty");
+      NS_TEST_EXPECT_MSG_EQ ((magic[0] == 0x1f && magic[1] == 0x8b), true, "Missing gzip magic");
+      NS_TEST_EXPECT_MSG_LT (size, 1000 * 32, "Compressed file is not smaller than its packet blocks");
+    }
 }
 
 /**
@@ -1167,6 +1501,9 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new BufferedWriteTestCase, TestCase::QUICK);
+  AddTestCase (new FileReaderTestCase, TestCase::QUICK);
+  AddTestCase (new PcapNgWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
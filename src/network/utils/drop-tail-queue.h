@@ -48,6 +48,7 @@ public:
 
   virtual bool Enqueue (Ptr<Item> item);
   virtual Ptr<Item> Dequeue (void);
+  virtual uint32_t DequeueBurst (std::vector<Ptr<Item> > &items, uint32_t maxItems);
   virtual Ptr<Item> Remove (void);
   virtual Ptr<const Item> Peek (void) const;
 
@@ -115,6 +116,24 @@ DropTailQueue<Item>::Dequeue (void)
   return item;
 }
 
+template <typename Item>
+uint32_t
+DropTailQueue<Item>::DequeueBurst (std::vector<Ptr<Item> > &items, uint32_t maxItems)
+{
+  NS_LOG_FUNCTION (this << maxItems);
+
+  uint32_t n = 0;
+  while (n < maxItems && !this->IsEmpty ())
+    {
+      items.push_back (DoDequeue (Head ()));
+      n++;
+    }
+
+  NS_LOG_LOGIC ("Popped " << n << " items");
+
+  return n;
+}
+
 template <typename Item>
 Ptr<Item>
 DropTailQueue<Item>::Remove (void)
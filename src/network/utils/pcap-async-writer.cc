@@ -0,0 +1,559 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/network-config.h"
+#include "pcap-async-writer.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif /* HAVE_ZSTD */
+
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#endif /* HAVE_PTHREAD_H */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapAsyncWriter");
+
+bool
+PcapAsyncWriter::IsCompressionSupported (Compression compression)
+{
+  switch (compression)
+    {
+    case NONE:
+      return true;
+    case GZIP:
+#ifdef HAVE_ZLIB
+      return true;
+#else /* HAVE_ZLIB */
+      return false;
+#endif /* HAVE_ZLIB */
+    case ZSTD:
+#ifdef HAVE_ZSTD
+      return true;
+#else /* HAVE_ZSTD */
+      return false;
+#endif /* HAVE_ZSTD */
+    }
+  return false;
+}
+
+PcapAsyncWriter::PcapAsyncWriter (uint32_t bufferSize, uint32_t nBuffers)
+  : m_fd (-1),
+    m_fail (false),
+    m_bufferSize (bufferSize),
+    m_bytesQueued (0),
+    m_current (0),
+    m_inFlight (0),
+    m_compression (NONE),
+    m_level (0),
+    m_stream (0)
+{
+  NS_LOG_FUNCTION (this << bufferSize << nBuffers);
+  NS_ASSERT (bufferSize > 0);
+#ifndef HAVE_PTHREAD_H
+  // Buffers are written synchronously, so a single one is enough.
+  nBuffers = 1;
+#endif /* HAVE_PTHREAD_H */
+  NS_ASSERT (nBuffers > 0);
+  for (uint32_t i = 0; i < nBuffers; ++i)
+    {
+      WriteBuffer *b = new WriteBuffer;
+      b->data.resize (bufferSize);
+      b->used = 0;
+      m_buffers.push_back (b);
+      m_free.push_back (b);
+    }
+  m_current = m_free.front ();
+  m_free.pop_front ();
+#ifdef HAVE_PTHREAD_H
+  m_stop = false;
+  m_mutex = new SystemMutex;
+  m_work = new SystemCondition;
+  m_done = new SystemCondition;
+#endif /* HAVE_PTHREAD_H */
+}
+
+PcapAsyncWriter::~PcapAsyncWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+  for (std::vector<WriteBuffer *>::iterator i = m_buffers.begin (); i != m_buffers.end (); ++i)
+    {
+      delete *i;
+    }
+  m_buffers.clear ();
+#ifdef HAVE_PTHREAD_H
+  delete m_mutex;
+  delete m_work;
+  delete m_done;
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+PcapAsyncWriter::SetCompression (Compression compression, int level)
+{
+  NS_LOG_FUNCTION (this << compression << level);
+  NS_ASSERT_MSG (m_fd < 0, "Compression must be selected before Open");
+  NS_ABORT_MSG_UNLESS (IsCompressionSupported (compression),
+                       "Compression " << compression << " is not supported by this build");
+  m_compression = compression;
+  m_level = level;
+}
+
+bool
+PcapAsyncWriter::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ASSERT (m_fd < 0);
+  m_fd = ::open (filename.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (m_fd < 0)
+    {
+      NS_LOG_WARN ("Cannot open " << filename << ": " << std::strerror (errno));
+      m_fail = true;
+      return false;
+    }
+#ifdef HAVE_ZLIB
+  if (m_compression == GZIP)
+    {
+      z_stream *z = new z_stream;
+      std::memset (z, 0, sizeof (*z));
+      // 15 window bits, +16 selects the gzip wrapper
+      if (deflateInit2 (z, m_level == 0 ? Z_DEFAULT_COMPRESSION : m_level,
+                        Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+          delete z;
+          ::close (m_fd);
+          m_fd = -1;
+          m_fail = true;
+          return false;
+        }
+      m_stream = z;
+    }
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+  if (m_compression == ZSTD)
+    {
+      ZSTD_CStream *z = ZSTD_createCStream ();
+      if (z == 0 || ZSTD_isError (ZSTD_initCStream (z, m_level == 0 ? ZSTD_CLEVEL_DEFAULT : m_level)))
+        {
+          ZSTD_freeCStream (z);
+          ::close (m_fd);
+          m_fd = -1;
+          m_fail = true;
+          return false;
+        }
+      m_stream = z;
+    }
+#endif /* HAVE_ZSTD */
+#ifdef HAVE_PTHREAD_H
+  m_stop = false;
+  m_thread = Create<SystemThread> (MakeCallback (&PcapAsyncWriter::Run, this));
+  m_thread->Start ();
+#endif /* HAVE_PTHREAD_H */
+  return true;
+}
+
+uint8_t *
+PcapAsyncWriter::Reserve (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  if (m_current->used + size > m_current->data.size ())
+    {
+      if (m_current->used > 0)
+        {
+          Submit ();
+        }
+      if (size > m_current->data.size ())
+        {
+          // A single record larger than the nominal buffer size
+          m_current->data.resize (size);
+        }
+    }
+  uint8_t *p = &m_current->data[m_current->used];
+  m_current->used += size;
+  m_bytesQueued += size;
+  return p;
+}
+
+void
+PcapAsyncWriter::Write (uint8_t const *data, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << &data << size);
+  if (size == 0)
+    {
+      return;
+    }
+  std::memcpy (Reserve (size), data, size);
+}
+
+void
+PcapAsyncWriter::Submit (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fd < 0)
+    {
+      // Closed (or never opened): data written now is discarded
+      m_current->used = 0;
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  m_mutex->Lock ();
+  m_pending.push_back (m_current);
+  m_work->SetCondition (true);
+  m_mutex->Unlock ();
+  m_work->Signal ();
+  m_current = GetFreeBuffer ();
+#else /* HAVE_PTHREAD_H */
+  std::vector<WriteBuffer *> batch (1, m_current);
+  WriteBatch (batch);
+  m_current->used = 0;
+#endif /* HAVE_PTHREAD_H */
+}
+
+PcapAsyncWriter::WriteBuffer *
+PcapAsyncWriter::GetFreeBuffer (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  m_mutex->Lock ();
+  while (m_free.empty ())
+    {
+      WaitFor (m_done);
+    }
+  WriteBuffer *b = m_free.front ();
+  m_free.pop_front ();
+  m_mutex->Unlock ();
+  return b;
+#else /* HAVE_PTHREAD_H */
+  NS_ASSERT (!m_free.empty ());
+  WriteBuffer *b = m_free.front ();
+  m_free.pop_front ();
+  return b;
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+PcapAsyncWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fd < 0)
+    {
+      return;
+    }
+  if (m_current->used > 0)
+    {
+      Submit ();
+    }
+#ifdef HAVE_PTHREAD_H
+  m_mutex->Lock ();
+  while (!m_pending.empty () || m_inFlight > 0)
+    {
+      WaitFor (m_done);
+    }
+  m_mutex->Unlock ();
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+PcapAsyncWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fd < 0)
+    {
+      return;
+    }
+  Flush ();
+#ifdef HAVE_PTHREAD_H
+  m_mutex->Lock ();
+  m_stop = true;
+  m_work->SetCondition (true);
+  m_mutex->Unlock ();
+  m_work->Signal ();
+  m_thread->Join ();
+  m_thread = 0;
+#endif /* HAVE_PTHREAD_H */
+  if (m_compression != NONE)
+    {
+      // The writer thread is gone, so the stream trailer is written here.
+      Compress (0, 0, true);
+      WriteAll (m_compressed.empty () ? 0 : &m_compressed[0], m_compressed.size ());
+      EndCompression ();
+    }
+  if (::close (m_fd) != 0)
+    {
+      m_fail = true;
+    }
+  m_fd = -1;
+}
+
+bool
+PcapAsyncWriter::Fail (void) const
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (*m_mutex);
+#endif /* HAVE_PTHREAD_H */
+  return m_fail;
+}
+
+uint64_t
+PcapAsyncWriter::GetBytesQueued (void) const
+{
+  return m_bytesQueued;
+}
+
+//
+// The functions below run on the writer thread.  The log macros prefix their
+// output with the simulator time and context, which are not thread-safe, so
+// these functions do not log: errors are reported through Fail ().
+//
+
+void
+PcapAsyncWriter::Compress (uint8_t const *data, std::size_t size, bool finish)
+{
+  m_compressed.clear ();
+#ifdef HAVE_ZLIB
+  if (m_compression == GZIP)
+    {
+      z_stream *z = static_cast<z_stream *> (m_stream);
+      z->next_in = const_cast<Bytef *> (data);
+      z->avail_in = size;
+      int ret;
+      do
+        {
+          std::size_t used = m_compressed.size ();
+          m_compressed.resize (used + deflateBound (z, size) + 64);
+          z->next_out = &m_compressed[used];
+          z->avail_out = m_compressed.size () - used;
+          ret = deflate (z, finish ? Z_FINISH : Z_NO_FLUSH);
+          m_compressed.resize (m_compressed.size () - z->avail_out);
+        }
+      while (ret == Z_OK && (z->avail_in > 0 || finish));
+      if (ret == Z_STREAM_ERROR)
+        {
+#ifdef HAVE_PTHREAD_H
+          CriticalSection cs (*m_mutex);
+#endif /* HAVE_PTHREAD_H */
+          m_fail = true;
+        }
+    }
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+  if (m_compression == ZSTD)
+    {
+      ZSTD_CStream *z = static_cast<ZSTD_CStream *> (m_stream);
+      ZSTD_inBuffer in = { data, size, 0 };
+      std::size_t pending;
+      do
+        {
+          std::size_t used = m_compressed.size ();
+          m_compressed.resize (used + ZSTD_CStreamOutSize ());
+          ZSTD_outBuffer out = { &m_compressed[used], m_compressed.size () - used, 0 };
+          pending = finish ? ZSTD_endStream (z, &out) : ZSTD_compressStream (z, &out, &in);
+          m_compressed.resize (used + out.pos);
+          if (ZSTD_isError (pending))
+            {
+#ifdef HAVE_PTHREAD_H
+              CriticalSection cs (*m_mutex);
+#endif /* HAVE_PTHREAD_H */
+              m_fail = true;
+              break;
+            }
+        }
+      while (finish ? pending > 0 : in.pos < in.size);
+    }
+#endif /* HAVE_ZSTD */
+}
+
+void
+PcapAsyncWriter::EndCompression (void)
+{
+#ifdef HAVE_ZLIB
+  if (m_compression == GZIP && m_stream != 0)
+    {
+      z_stream *z = static_cast<z_stream *> (m_stream);
+      deflateEnd (z);
+      delete z;
+    }
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+  if (m_compression == ZSTD && m_stream != 0)
+    {
+      ZSTD_freeCStream (static_cast<ZSTD_CStream *> (m_stream));
+    }
+#endif /* HAVE_ZSTD */
+  m_stream = 0;
+}
+
+void
+PcapAsyncWriter::WriteAll (uint8_t const *data, std::size_t size)
+{
+  while (size > 0)
+    {
+      ssize_t written = ::write (m_fd, data, size);
+      if (written < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+#ifdef HAVE_PTHREAD_H
+          CriticalSection cs (*m_mutex);
+#endif /* HAVE_PTHREAD_H */
+          m_fail = true;
+          return;
+        }
+      data += written;
+      size -= written;
+    }
+}
+
+void
+PcapAsyncWriter::WriteBatch (std::vector<WriteBuffer *> const &batch)
+{
+  if (m_compression != NONE)
+    {
+      for (std::vector<WriteBuffer *>::const_iterator i = batch.begin (); i != batch.end (); ++i)
+        {
+          if ((*i)->used > 0)
+            {
+              Compress (&(*i)->data[0], (*i)->used, false);
+              WriteAll (m_compressed.empty () ? 0 : &m_compressed[0], m_compressed.size ());
+            }
+        }
+      return;
+    }
+
+  std::vector<struct iovec> iov;
+  iov.reserve (batch.size ());
+  for (std::vector<WriteBuffer *>::const_iterator i = batch.begin (); i != batch.end (); ++i)
+    {
+      if ((*i)->used > 0)
+        {
+          struct iovec v;
+          v.iov_base = &(*i)->data[0];
+          v.iov_len = (*i)->used;
+          iov.push_back (v);
+        }
+    }
+
+  std::size_t first = 0;
+  while (first < iov.size ())
+    {
+      ssize_t written = ::writev (m_fd, &iov[first], iov.size () - first);
+      if (written < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+#ifdef HAVE_PTHREAD_H
+          CriticalSection cs (*m_mutex);
+#endif /* HAVE_PTHREAD_H */
+          m_fail = true;
+          return;
+        }
+      //
+      // Skip over the fully written vectors and adjust a partially written one.
+      //
+      std::size_t left = written;
+      while (first < iov.size () && left >= iov[first].iov_len)
+        {
+          left -= iov[first].iov_len;
+          ++first;
+        }
+      if (first < iov.size ())
+        {
+          iov[first].iov_base = static_cast<uint8_t *> (iov[first].iov_base) + left;
+          iov[first].iov_len -= left;
+        }
+    }
+}
+
+void
+PcapAsyncWriter::Run (void)
+{
+#ifdef HAVE_PTHREAD_H
+  for (;;)
+    {
+      std::vector<WriteBuffer *> batch;
+      m_mutex->Lock ();
+      while (m_pending.empty () && !m_stop)
+        {
+          WaitFor (m_work);
+        }
+      if (m_pending.empty ())
+        {
+          // Close flushed everything before setting m_stop
+          m_mutex->Unlock ();
+          break;
+        }
+      batch.assign (m_pending.begin (), m_pending.end ());
+      m_pending.clear ();
+      m_inFlight = batch.size ();
+      m_mutex->Unlock ();
+
+      WriteBatch (batch);
+
+      m_mutex->Lock ();
+      for (std::vector<WriteBuffer *>::iterator i = batch.begin (); i != batch.end (); ++i)
+        {
+          (*i)->used = 0;
+          m_free.push_back (*i);
+        }
+      m_inFlight = 0;
+      m_done->SetCondition (true);
+      m_mutex->Unlock ();
+      m_done->Signal ();
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+#ifdef HAVE_PTHREAD_H
+void
+PcapAsyncWriter::WaitFor (SystemCondition *condition)
+{
+  //
+  // The condition is cleared under m_mutex, after the caller checked its
+  // predicate, and the other side sets it under m_mutex when it changes the
+  // queues, so a Signal sent before this thread blocks is not lost:
+  // TimedWait, unlike Wait, does not clear the condition again and returns
+  // at once when it is already set.  A timeout just waits again.
+  //
+  condition->SetCondition (false);
+  m_mutex->Unlock ();
+  while (condition->TimedWait (1000000000))
+    {
+    }
+  m_mutex->Lock ();
+}
+#endif /* HAVE_PTHREAD_H */
+
+} // namespace ns3
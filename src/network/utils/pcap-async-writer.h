@@ -0,0 +1,211 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_ASYNC_WRITER_H
+#define PCAP_ASYNC_WRITER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <stdint.h>
+#include <cstddef>
+#include "ns3/core-config.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class SystemThread;
+class SystemMutex;
+class SystemCondition;
+
+/**
+ * \brief Buffered, write-behind output file used by PcapFile
+ *
+ * Records are assembled directly into large in-memory buffers.  When a
+ * buffer fills up it is handed over to a background thread, which writes
+ * every queued buffer with a single writev() call, while the simulation
+ * thread keeps filling the next buffer.  A small fixed number of buffers
+ * is used; if the writer falls behind, the simulation thread blocks until
+ * a buffer is released, so memory usage stays bounded.
+ *
+ * When ns-3 is built without threading support, full buffers are written
+ * synchronously with writev() from the calling thread instead.
+ *
+ * The output can optionally be compressed as a gzip (zlib) or zstd stream;
+ * compression runs on the writer thread as well.
+ */
+class PcapAsyncWriter
+{
+public:
+  /**
+   * \brief Output compression
+   */
+  enum Compression
+  {
+    NONE,  //!< plain output
+    GZIP,  //!< gzip stream (requires zlib)
+    ZSTD   //!< zstd stream (requires libzstd)
+  };
+
+  /**
+   * \param compression the compression
+   * \return true if this build supports the compression
+   */
+  static bool IsCompressionSupported (Compression compression);
+
+  /**
+   * \param bufferSize size in bytes of each write buffer
+   * \param nBuffers number of buffers cycling between producer and writer
+   */
+  PcapAsyncWriter (uint32_t bufferSize, uint32_t nBuffers = 4);
+  ~PcapAsyncWriter ();
+
+  /**
+   * \brief Create (or truncate) the output file and start the writer thread
+   * \param filename the file name
+   * \return true on success, false otherwise
+   */
+  bool Open (std::string const &filename);
+
+  /**
+   * \brief Select the output compression; must be called before Open
+   * \param compression the compression, which must be supported
+   * \param level compression level; zero selects the library default
+   */
+  void SetCompression (Compression compression, int level = 0);
+
+  /**
+   * \brief Reserve contiguous space at the end of the output
+   *
+   * The returned pointer is valid until the next call to Reserve, Write,
+   * Flush or Close; the caller is expected to fill all of the reserved bytes.
+   *
+   * \param size number of bytes to reserve
+   * \return a pointer to the reserved bytes
+   */
+  uint8_t * Reserve (uint32_t size);
+
+  /**
+   * \brief Append data to the output
+   * \param data the data
+   * \param size number of bytes in data
+   */
+  void Write (uint8_t const *data, uint32_t size);
+
+  /**
+   * \brief Write all buffered data to the file and wait for completion
+   */
+  void Flush (void);
+
+  /**
+   * \brief Flush, stop the writer thread and close the file
+   */
+  void Close (void);
+
+  /**
+   * \return true if the file could not be opened or a write failed
+   */
+  bool Fail (void) const;
+
+  /**
+   * \return the number of bytes handed to the writer so far, including
+   * those still buffered
+   */
+  uint64_t GetBytesQueued (void) const;
+
+private:
+  /**
+   * \brief A write buffer
+   */
+  struct WriteBuffer
+  {
+    std::vector<uint8_t> data; //!< storage
+    uint32_t used;             //!< number of bytes filled
+  };
+
+  /**
+   * \brief Queue the current buffer for writing and take a free one
+   */
+  void Submit (void);
+  /**
+   * \brief Take a free buffer, blocking until the writer releases one
+   * \return the buffer
+   */
+  WriteBuffer * GetFreeBuffer (void);
+  /**
+   * \brief Write a batch of buffers to the file with writev
+   * \param batch the buffers to write, in order
+   */
+  void WriteBatch (std::vector<WriteBuffer *> const &batch);
+  /**
+   * \brief Write a contiguous block to the file
+   * \param data the data
+   * \param size number of bytes
+   */
+  void WriteAll (uint8_t const *data, std::size_t size);
+  /**
+   * \brief Compress data into m_compressed
+   * \param data the data
+   * \param size number of bytes
+   * \param finish true to terminate the compressed stream
+   */
+  void Compress (uint8_t const *data, std::size_t size, bool finish);
+  /**
+   * \brief Release the compression stream
+   */
+  void EndCompression (void);
+  /**
+   * \brief Background writer thread body
+   */
+  void Run (void);
+#ifdef HAVE_PTHREAD_H
+  /**
+   * \brief Wait until a condition is signaled
+   *
+   * Must be called with m_mutex held, after checking the predicate the
+   * caller waits for.  The mutex is released while waiting and taken
+   * again before returning.
+   *
+   * \param condition the condition to wait on
+   */
+  void WaitFor (SystemCondition *condition);
+#endif /* HAVE_PTHREAD_H */
+
+  int m_fd;                                //!< output file descriptor
+  bool m_fail;                             //!< error flag
+  uint32_t m_bufferSize;                   //!< nominal size of each buffer
+  uint64_t m_bytesQueued;                  //!< total bytes appended
+  WriteBuffer *m_current;                  //!< buffer being filled
+  std::vector<WriteBuffer *> m_buffers;    //!< all buffers (for ownership)
+  std::deque<WriteBuffer *> m_pending;     //!< buffers waiting to be written
+  std::deque<WriteBuffer *> m_free;        //!< buffers ready to be filled
+  uint32_t m_inFlight;                     //!< buffers taken by the writer
+  Compression m_compression;               //!< output compression
+  int m_level;                             //!< compression level
+  void *m_stream;                          //!< compression stream state
+  std::vector<uint8_t> m_compressed;       //!< compression output
+#ifdef HAVE_PTHREAD_H
+  bool m_stop;                             //!< writer thread must exit
+  Ptr<SystemThread> m_thread;              //!< writer thread
+  SystemMutex *m_mutex;                    //!< protects the queues and flags
+  SystemCondition *m_work;                 //!< wakes up the writer thread
+  SystemCondition *m_done;                 //!< wakes up the producer
+#endif /* HAVE_PTHREAD_H */
+};
+
+} // namespace ns3
+
+#endif /* PCAP_ASYNC_WRITER_H */
@@ -0,0 +1,496 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "pcap-file-reader.h"
+
+//
+// Like pcap-file.cc, this file is used as part of the ns-3 test framework,
+// so please refrain from adding any ns-3 specific constructs to it.
+//
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapFileReader");
+
+namespace {
+
+const uint32_t MAGIC = 0xa1b2c3d4;            //!< standard pcap magic number
+const uint32_t SWAPPED_MAGIC = 0xd4c3b2a1;    //!< byte swapped standard magic
+const uint32_t NS_MAGIC = 0xa1b23c4d;         //!< nanosecond pcap magic number
+const uint32_t NS_SWAPPED_MAGIC = 0x4d3cb2a1; //!< byte swapped nanosecond magic
+
+const uint32_t PCAP_FILE_HEADER_SIZE = 24;    //!< pcap global header size
+const uint32_t PCAP_RECORD_HEADER_SIZE = 16;  //!< pcap record header size
+
+const uint32_t NG_SECTION_HEADER_BLOCK = 0x0a0d0d0a;    //!< pcapng SHB type
+const uint32_t NG_INTERFACE_DESCRIPTION_BLOCK = 1;      //!< pcapng IDB type
+const uint32_t NG_PACKET_BLOCK = 2;                     //!< pcapng obsolete PB type
+const uint32_t NG_SIMPLE_PACKET_BLOCK = 3;              //!< pcapng SPB type
+const uint32_t NG_ENHANCED_PACKET_BLOCK = 6;            //!< pcapng EPB type
+const uint32_t NG_BYTE_ORDER_MAGIC = 0x1a2b3c4d;        //!< pcapng byte order magic
+const uint32_t NG_SWAPPED_BYTE_ORDER_MAGIC = 0x4d3c2b1a; //!< byte swapped BOM
+const uint16_t NG_OPT_END = 0;                          //!< end of options
+const uint16_t NG_IF_TSRESOL = 9;                       //!< if_tsresol option
+
+const uint64_t USEC_PER_SEC = 1000000;                  //!< microseconds per second
+const uint64_t NSEC_PER_SEC = 1000000000;               //!< nanoseconds per second
+
+/**
+ * \param v a 32-bit value
+ * \return the value rounded up to a multiple of four
+ */
+inline uint32_t
+Pad4 (uint32_t v)
+{
+  return (v + 3) & ~3U;
+}
+
+} // unnamed namespace
+
+PcapFileReader::PcapFileReader ()
+  : m_base (0),
+    m_size (0),
+    m_fail (false),
+    m_truncated (false),
+    m_pcapng (false),
+    m_swapMode (false),
+    m_nanosecMode (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapFileReader::~PcapFileReader ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+PcapFileReader::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  m_fail = true;
+
+  int fd = ::open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_LOGIC ("Cannot open " << filename);
+      return false;
+    }
+  struct stat st;
+  if (::fstat (fd, &st) != 0 || st.st_size < 4)
+    {
+      ::close (fd);
+      return false;
+    }
+  void *map = ::mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close (fd);
+  if (map == MAP_FAILED)
+    {
+      NS_LOG_LOGIC ("Cannot map " << filename);
+      return false;
+    }
+  m_base = static_cast<uint8_t const *> (map);
+  m_size = st.st_size;
+#ifdef MADV_SEQUENTIAL
+  ::madvise (map, m_size, MADV_SEQUENTIAL);
+#endif
+
+  uint32_t magic;
+  std::memcpy (&magic, m_base, sizeof (magic));
+  bool ok = false;
+  if (magic == NG_SECTION_HEADER_BLOCK)
+    {
+      m_pcapng = true;
+      ok = IndexPcapNg ();
+    }
+  else
+    {
+      ok = IndexPcap ();
+    }
+  if (!ok)
+    {
+      Close ();
+      m_fail = true;
+      return false;
+    }
+  m_fail = false;
+  return true;
+}
+
+void
+PcapFileReader::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_base != 0)
+    {
+      ::munmap (const_cast<uint8_t *> (m_base), m_size);
+    }
+  m_base = 0;
+  m_size = 0;
+  m_fail = false;
+  m_truncated = false;
+  m_pcapng = false;
+  m_swapMode = false;
+  m_nanosecMode = false;
+  m_interfaces.clear ();
+  m_records.clear ();
+}
+
+uint16_t
+PcapFileReader::Read16 (uint8_t const *p) const
+{
+  uint16_t v;
+  std::memcpy (&v, p, sizeof (v));
+  if (m_swapMode)
+    {
+      v = ((v >> 8) & 0x00ff) | ((v << 8) & 0xff00);
+    }
+  return v;
+}
+
+uint32_t
+PcapFileReader::Read32 (uint8_t const *p) const
+{
+  uint32_t v;
+  std::memcpy (&v, p, sizeof (v));
+  if (m_swapMode)
+    {
+      v = ((v >> 24) & 0x000000ff) | ((v >> 8) & 0x0000ff00) | ((v << 8) & 0x00ff0000) | ((v << 24) & 0xff000000);
+    }
+  return v;
+}
+
+bool
+PcapFileReader::IndexPcap (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_size < PCAP_FILE_HEADER_SIZE)
+    {
+      return false;
+    }
+  uint32_t magic;
+  std::memcpy (&magic, m_base, sizeof (magic));
+  if (magic != MAGIC && magic != SWAPPED_MAGIC && magic != NS_MAGIC && magic != NS_SWAPPED_MAGIC)
+    {
+      return false;
+    }
+  m_swapMode = (magic == SWAPPED_MAGIC || magic == NS_SWAPPED_MAGIC);
+  m_nanosecMode = (magic == NS_MAGIC || magic == NS_SWAPPED_MAGIC);
+  if (Read16 (m_base + 4) != 2 || Read16 (m_base + 6) != 4)
+    {
+      return false;
+    }
+
+  Interface iface;
+  iface.snapLen = Read32 (m_base + 16);
+  iface.linkType = Read32 (m_base + 20);
+  iface.unitsPerSec = m_nanosecMode ? NSEC_PER_SEC : USEC_PER_SEC;
+  m_interfaces.push_back (iface);
+
+  //
+  // Records are variable length, so a first pass over the headers is
+  // needed anyway; reserve using a typical small record size.
+  //
+  m_records.reserve ((m_size - PCAP_FILE_HEADER_SIZE) / 128);
+  std::size_t offset = PCAP_FILE_HEADER_SIZE;
+  while (offset + PCAP_RECORD_HEADER_SIZE <= m_size)
+    {
+      uint8_t const *p = m_base + offset;
+      Record r;
+      r.tsSec = Read32 (p);
+      r.tsUsec = Read32 (p + 4);
+      r.inclLen = Read32 (p + 8);
+      r.origLen = Read32 (p + 12);
+      r.interfaceId = 0;
+      r.data = p + PCAP_RECORD_HEADER_SIZE;
+      offset += PCAP_RECORD_HEADER_SIZE;
+      if (r.inclLen > m_size - offset)
+        {
+          m_truncated = true;
+          return true;
+        }
+      offset += r.inclLen;
+      m_records.push_back (r);
+    }
+  m_truncated = (offset != m_size);
+  return true;
+}
+
+void
+PcapFileReader::ParseInterfaceOptions (uint8_t const *p, uint8_t const *end, Interface &iface) const
+{
+  while (p + 4 <= end)
+    {
+      uint16_t code = Read16 (p);
+      uint16_t len = Read16 (p + 2);
+      p += 4;
+      if (code == NG_OPT_END || p + len > end)
+        {
+          break;
+        }
+      if (code == NG_IF_TSRESOL && len >= 1)
+        {
+          uint8_t v = p[0];
+          uint64_t base = (v & 0x80) ? 2 : 10;
+          uint64_t units = 1;
+          for (uint8_t i = 0; i < (v & 0x7f) && units < NSEC_PER_SEC * 1000; ++i)
+            {
+              units *= base;
+            }
+          iface.unitsPerSec = units;
+        }
+      p += Pad4 (len);
+    }
+}
+
+bool
+PcapFileReader::IndexPcapNg (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  //
+  // Timestamps are collected in nanoseconds first, since whether the whole
+  // file is reported with micro- or nanosecond resolution is only known
+  // once all interfaces have been seen.
+  //
+  std::vector<uint64_t> tsNs;
+  std::size_t sectionFirstInterface = 0;
+  std::size_t offset = 0;
+  bool haveSection = false;
+
+  while (offset + 12 <= m_size)
+    {
+      uint8_t const *block = m_base + offset;
+      uint32_t type;
+      std::memcpy (&type, block, sizeof (type));
+      if (type == NG_SECTION_HEADER_BLOCK)
+        {
+          // The byte order of the section follows from its own magic.
+          uint32_t bom;
+          std::memcpy (&bom, block + 8, sizeof (bom));
+          if (bom == NG_BYTE_ORDER_MAGIC)
+            {
+              m_swapMode = false;
+            }
+          else if (bom == NG_SWAPPED_BYTE_ORDER_MAGIC)
+            {
+              m_swapMode = true;
+            }
+          else
+            {
+              return false;
+            }
+          sectionFirstInterface = m_interfaces.size ();
+          haveSection = true;
+        }
+      else if (!haveSection)
+        {
+          return false;
+        }
+
+      uint32_t length = Read32 (block + 4);
+      if (length < 12 || (length & 3) != 0)
+        {
+          NS_LOG_LOGIC ("Malformed block at offset " << offset);
+          m_truncated = true;
+          break;
+        }
+      if (length > m_size - offset)
+        {
+          m_truncated = true;
+          break;
+        }
+      uint8_t const *body = block + 8;
+      uint8_t const *bodyEnd = block + length - 4;
+
+      if (type == NG_INTERFACE_DESCRIPTION_BLOCK && body + 8 <= bodyEnd)
+        {
+          Interface iface;
+          iface.linkType = Read16 (body);
+          iface.snapLen = Read32 (body + 4);
+          iface.unitsPerSec = USEC_PER_SEC;
+          ParseInterfaceOptions (body + 8, bodyEnd, iface);
+          if (iface.unitsPerSec > USEC_PER_SEC)
+            {
+              m_nanosecMode = true;
+            }
+          m_interfaces.push_back (iface);
+        }
+      else if ((type == NG_ENHANCED_PACKET_BLOCK || type == NG_PACKET_BLOCK) && body + 20 <= bodyEnd)
+        {
+          Record r;
+          if (type == NG_ENHANCED_PACKET_BLOCK)
+            {
+              r.interfaceId = Read32 (body);
+            }
+          else
+            {
+              r.interfaceId = Read16 (body);
+            }
+          uint64_t ts = (static_cast<uint64_t> (Read32 (body + 4)) << 32) | Read32 (body + 8);
+          r.inclLen = Read32 (body + 12);
+          r.origLen = Read32 (body + 16);
+          r.data = body + 20;
+          std::size_t iface = sectionFirstInterface + r.interfaceId;
+          if (iface >= m_interfaces.size () || r.data + r.inclLen > bodyEnd)
+            {
+              NS_LOG_LOGIC ("Invalid packet block at offset " << offset);
+              return false;
+            }
+          r.interfaceId = iface;
+          uint64_t units = m_interfaces[iface].unitsPerSec;
+          uint64_t sec = ts / units;
+          uint64_t frac = ts % units;
+          tsNs.push_back (sec * NSEC_PER_SEC
+                          + static_cast<uint64_t> (static_cast<long double> (frac) * NSEC_PER_SEC / units));
+          m_records.push_back (r);
+        }
+      else if (type == NG_SIMPLE_PACKET_BLOCK && body + 4 <= bodyEnd)
+        {
+          std::size_t iface = sectionFirstInterface;
+          if (iface >= m_interfaces.size ())
+            {
+              return false;
+            }
+          Record r;
+          r.interfaceId = iface;
+          r.origLen = Read32 (body);
+          r.data = body + 4;
+          uint32_t avail = bodyEnd - r.data;
+          uint32_t snapLen = m_interfaces[iface].snapLen;
+          r.inclLen = r.origLen;
+          if (snapLen != 0 && r.inclLen > snapLen)
+            {
+              r.inclLen = snapLen;
+            }
+          if (r.inclLen > avail)
+            {
+              r.inclLen = avail;
+            }
+          tsNs.push_back (0);
+          m_records.push_back (r);
+        }
+      offset += length;
+    }
+
+  if (!haveSection)
+    {
+      return false;
+    }
+  if (offset != m_size)
+    {
+      m_truncated = true;
+    }
+
+  uint64_t unit = m_nanosecMode ? 1 : NSEC_PER_SEC / USEC_PER_SEC;
+  for (std::size_t i = 0; i < m_records.size (); ++i)
+    {
+      m_records[i].tsSec = tsNs[i] / NSEC_PER_SEC;
+      m_records[i].tsUsec = (tsNs[i] % NSEC_PER_SEC) / unit;
+    }
+  return true;
+}
+
+bool
+PcapFileReader::Fail (void) const
+{
+  return m_fail;
+}
+
+bool
+PcapFileReader::IsTruncated (void) const
+{
+  return m_truncated;
+}
+
+bool
+PcapFileReader::IsPcapNg (void) const
+{
+  return m_pcapng;
+}
+
+bool
+PcapFileReader::IsNanoSecMode (void) const
+{
+  return m_nanosecMode;
+}
+
+bool
+PcapFileReader::GetSwapMode (void) const
+{
+  return m_swapMode;
+}
+
+uint32_t
+PcapFileReader::GetDataLinkType (void) const
+{
+  return m_interfaces.empty () ? 0 : m_interfaces[0].linkType;
+}
+
+uint32_t
+PcapFileReader::GetSnapLen (void) const
+{
+  return m_interfaces.empty () ? 0 : m_interfaces[0].snapLen;
+}
+
+uint32_t
+PcapFileReader::GetNInterfaces (void) const
+{
+  return m_interfaces.size ();
+}
+
+uint32_t
+PcapFileReader::GetInterfaceDataLinkType (uint32_t interfaceId) const
+{
+  NS_ASSERT (interfaceId < m_interfaces.size ());
+  return m_interfaces[interfaceId].linkType;
+}
+
+std::size_t
+PcapFileReader::GetNRecords (void) const
+{
+  return m_records.size ();
+}
+
+PcapFileReader::Record const &
+PcapFileReader::GetRecord (std::size_t i) const
+{
+  NS_ASSERT (i < m_records.size ());
+  return m_records[i];
+}
+
+PcapFileReader::Iterator
+PcapFileReader::Begin (void) const
+{
+  return m_records.begin ();
+}
+
+PcapFileReader::Iterator
+PcapFileReader::End (void) const
+{
+  return m_records.end ();
+}
+
+} // namespace ns3
@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_FILE_READER_H
+#define PCAP_FILE_READER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <cstddef>
+
+namespace ns3 {
+
+/**
+ * \brief Read-only, memory-mapped access to pcap and pcapng files
+ *
+ * The whole file is mapped into memory on Open and an index of all packet
+ * records is built in a single pass, so records can afterwards be accessed
+ * randomly or iterated over without any copy or further system call.
+ * Packet data pointers point straight into the mapping and stay valid
+ * until Close.
+ *
+ * Both the classic libpcap format (micro- or nanosecond timestamps, either
+ * byte order) and pcapng are supported.  For pcapng files, Enhanced,
+ * Simple and (obsolete) Packet Blocks are indexed, Interface Description
+ * Blocks provide link type, snap length and timestamp resolution, and all
+ * other blocks are skipped.  Timestamps of pcapng files are reported in
+ * microseconds, unless an interface uses a finer resolution, in which
+ * case nanoseconds are used for the whole file.
+ */
+class PcapFileReader
+{
+public:
+  /**
+   * \brief A packet record, as indexed from the file
+   */
+  struct Record
+  {
+    uint32_t tsSec;          //!< timestamp, seconds part
+    uint32_t tsUsec;         //!< timestamp, micro- (or nano-) seconds part
+    uint32_t inclLen;        //!< number of octets of packet saved in file
+    uint32_t origLen;        //!< actual length of original packet
+    uint32_t interfaceId;    //!< pcapng interface index (0 for pcap files)
+    uint8_t const *data;     //!< packet data, inclLen bytes long
+  };
+
+  /// Record iterator
+  typedef std::vector<Record>::const_iterator Iterator;
+
+  PcapFileReader ();
+  ~PcapFileReader ();
+
+  /**
+   * \brief Map a file and index its records
+   * \param filename the file name
+   * \return true on success, false if the file cannot be mapped or is
+   * neither a valid pcap nor pcapng file
+   */
+  bool Open (std::string const &filename);
+
+  /**
+   * \brief Unmap the file; all Record data pointers become invalid
+   */
+  void Close (void);
+
+  /**
+   * \return true if the last Open failed
+   */
+  bool Fail (void) const;
+
+  /**
+   * \return true if the file ends in the middle of a record.  All complete
+   * records before that point are still indexed.
+   */
+  bool IsTruncated (void) const;
+
+  /**
+   * \return true if the file is in pcapng format
+   */
+  bool IsPcapNg (void) const;
+
+  /**
+   * \return true if the timestamp sub-second field holds nanoseconds
+   */
+  bool IsNanoSecMode (void) const;
+
+  /**
+   * \return true if the file was written in the opposite byte order
+   */
+  bool GetSwapMode (void) const;
+
+  /**
+   * \return the data link type of the file (of the first interface for
+   * pcapng files)
+   */
+  uint32_t GetDataLinkType (void) const;
+
+  /**
+   * \return the snap length of the file (of the first interface for
+   * pcapng files)
+   */
+  uint32_t GetSnapLen (void) const;
+
+  /**
+   * \return the number of pcapng interfaces (1 for pcap files)
+   */
+  uint32_t GetNInterfaces (void) const;
+
+  /**
+   * \param interfaceId the interface index
+   * \return the data link type of the interface
+   */
+  uint32_t GetInterfaceDataLinkType (uint32_t interfaceId) const;
+
+  /**
+   * \return the number of packet records
+   */
+  std::size_t GetNRecords (void) const;
+
+  /**
+   * \param i the record index
+   * \return the i-th record
+   */
+  Record const & GetRecord (std::size_t i) const;
+
+  /**
+   * \return an iterator to the first record
+   */
+  Iterator Begin (void) const;
+
+  /**
+   * \return an iterator past the last record
+   */
+  Iterator End (void) const;
+
+private:
+  /**
+   * \brief pcapng interface state
+   */
+  struct Interface
+  {
+    uint32_t linkType;       //!< data link type
+    uint32_t snapLen;        //!< snap length
+    uint64_t unitsPerSec;    //!< timestamp units per second
+  };
+
+  /**
+   * \brief Index a classic pcap file
+   * \return true on success
+   */
+  bool IndexPcap (void);
+  /**
+   * \brief Index a pcapng file
+   * \return true on success
+   */
+  bool IndexPcapNg (void);
+  /**
+   * \brief Parse the options of an Interface Description Block
+   * \param p first option
+   * \param end end of the options
+   * \param iface interface to update
+   */
+  void ParseInterfaceOptions (uint8_t const *p, uint8_t const *end, Interface &iface) const;
+
+  /**
+   * \param p pointer into the mapping
+   * \return the 16-bit value at p, in host byte order
+   */
+  uint16_t Read16 (uint8_t const *p) const;
+  /**
+   * \param p pointer into the mapping
+   * \return the 32-bit value at p, in host byte order
+   */
+  uint32_t Read32 (uint8_t const *p) const;
+
+  uint8_t const *m_base;                //!< start of the mapping
+  std::size_t m_size;                   //!< size of the mapping
+  bool m_fail;                          //!< open failed
+  bool m_truncated;                     //!< file ends within a record
+  bool m_pcapng;                        //!< pcapng format
+  bool m_swapMode;                      //!< byte-swapped file
+  bool m_nanosecMode;                   //!< nanosecond timestamps
+  std::vector<Interface> m_interfaces;  //!< interfaces (one for pcap)
+  std::vector<Record> m_records;        //!< record index
+};
+
+} // namespace ns3
+
+#endif /* PCAP_FILE_READER_H */
@@ -46,12 +46,21 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("WriteBufferSize",
+                   "Size in bytes of the buffers used to write the file from a background "
+                   "thread. Zero writes every record synchronously.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_writeBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_ngInterface (0),
+    m_ngNodeId (PcapNgFile::NO_DEVICE),
+    m_ngDeviceId (PcapNgFile::NO_DEVICE)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,6 +75,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile)
+    {
+      return m_ngFile->Fail ();
+    }
   return m_file.Fail ();
 }
 
@@ -73,6 +86,10 @@ bool
 PcapFileWrapper::Eof (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile)
+    {
+      return false;
+    }
   return m_file.Eof ();
 }
 void 
@@ -86,6 +103,8 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  // The shared pcapng file is closed when its last user releases it
+  m_ngFile = 0;
   m_file.Close ();
 }
 
@@ -93,9 +112,22 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  m_file.SetWriteBufferSize (m_writeBufferSize);
   m_file.Open (filename, mode);
 }
 
+void
+PcapFileWrapper::Attach (Ptr<PcapNgFile> file, std::string const &name, std::string const &description,
+                         uint32_t nodeId, uint32_t deviceId)
+{
+  NS_LOG_FUNCTION (this << file << name << description << nodeId << deviceId);
+  m_ngFile = file;
+  m_ngName = name;
+  m_ngDescription = description;
+  m_ngNodeId = nodeId;
+  m_ngDeviceId = deviceId;
+}
+
 void
 PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrection)
 {
@@ -105,6 +137,13 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
   // a snaplen, we use the one provided.
   //
   NS_LOG_FUNCTION (this << dataLinkType << snapLen << tzCorrection);
+  if (m_ngFile)
+    {
+      uint32_t len = snapLen != std::numeric_limits<uint32_t>::max () ? snapLen : m_snapLen;
+      m_ngInterface = m_ngFile->AddInterface (dataLinkType, len, m_ngName, m_ngDescription,
+                                              tzCorrection, m_ngNodeId, m_ngDeviceId);
+      return;
+    }
   if (snapLen != std::numeric_limits<uint32_t>::max ())
     {
       m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
@@ -119,6 +158,11 @@ void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_ngFile)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -139,6 +183,11 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_ngFile)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), header, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -159,6 +208,11 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_ngFile)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), buffer, length);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -184,6 +238,7 @@ PcapFileWrapper::Read (Time &t)
   uint32_t origLen;
   uint32_t readLen;
 
+  NS_ASSERT_MSG (!m_ngFile, "Shared pcapng files cannot be read back");
   uint32_t maxBytes=65536;
   uint8_t  datbuf[maxBytes];
 
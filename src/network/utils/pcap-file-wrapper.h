@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcapng-file.h"
 
 namespace ns3 {
 
@@ -77,6 +78,21 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Write to a new interface of a shared pcapng file instead of a pcap file
+   * of this wrapper's own.  Used instead of Open; the interface is
+   * registered by the following call to Init.  Timestamps are always
+   * written with nanosecond resolution and reading is not supported.
+   *
+   * \param file the shared pcapng file
+   * \param name the interface name
+   * \param description the interface description
+   * \param nodeId the ID of the node of the traced device, if known
+   * \param deviceId the index of the traced device on its node, if known
+   */
+  void Attach (Ptr<PcapNgFile> file, std::string const &name, std::string const &description,
+               uint32_t nodeId = PcapNgFile::NO_DEVICE, uint32_t deviceId = PcapNgFile::NO_DEVICE);
+
   /**
    * Close the underlying pcap file.
    */
@@ -224,6 +240,13 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  uint32_t m_writeBufferSize; //!< asynchronous write buffer size (0 = unbuffered)
+  Ptr<PcapNgFile> m_ngFile; //!< shared pcapng file, if attached
+  uint32_t m_ngInterface; //!< interface ID in the shared pcapng file
+  std::string m_ngName; //!< pcapng interface name
+  std::string m_ngDescription; //!< pcapng interface description
+  uint32_t m_ngNodeId; //!< node ID of the traced device, for the shared pcapng file
+  uint32_t m_ngDeviceId; //!< index of the traced device, for the shared pcapng file
 };
 
 } // namespace ns3
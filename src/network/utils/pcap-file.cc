@@ -27,6 +27,8 @@
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "pcap-file.h"
+#include "pcap-async-writer.h"
+#include "pcap-file-reader.h"
 #include "ns3/log.h"
 #include "ns3/build-profile.h"
 //
@@ -50,7 +52,9 @@ const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pc
 PcapFile::PcapFile ()
   : m_file (),
     m_swapMode (false),
-    m_nanosecMode (false)
+    m_nanosecMode (false),
+    m_writeBufferSize (0),
+    m_writer (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file); 
@@ -61,6 +65,7 @@ PcapFile::~PcapFile ()
   NS_LOG_FUNCTION (this);
   FatalImpl::UnregisterStream (&m_file);
   Close ();
+  delete m_writer;
 }
 
 
@@ -68,7 +73,7 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_file.fail ();
+  return m_file.fail () || (m_writer != 0 && m_writer->Fail ());
 }
 bool 
 PcapFile::Eof (void) const
@@ -88,9 +93,28 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      m_writer->Close ();
+      return;
+    }
   m_file.close ();
 }
 
+void
+PcapFile::SetWriteBufferSize (uint32_t bufferSize)
+{
+  NS_LOG_FUNCTION (this << bufferSize);
+  m_writeBufferSize = bufferSize;
+}
+
+uint32_t
+PcapFile::GetWriteBufferSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_writeBufferSize;
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -202,12 +226,6 @@ void
 PcapFile::WriteFileHeader (void)
 {
   NS_LOG_FUNCTION (this);
-  //
-  // If we're initializing the file, we need to write the pcap file header
-  // at the start of the file.
-  //
-  m_file.seekp (0, std::ios::beg);
- 
   //
   // We have the ability to write out the pcap file header in a foreign endian
   // format, so we need a temp place to swap on the way out.
@@ -230,6 +248,27 @@ PcapFile::WriteFileHeader (void)
       headerOut = &header;
     }
 
+  if (m_writer != 0)
+    {
+      NS_ASSERT_MSG (m_writer->GetBytesQueued () == 0,
+                     "Buffered pcap files can only be initialized right after Open");
+      m_writer->Write ((uint8_t const *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+      m_writer->Write ((uint8_t const *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+      m_writer->Write ((uint8_t const *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+      m_writer->Write ((uint8_t const *)&headerOut->m_zone, sizeof(headerOut->m_zone));
+      m_writer->Write ((uint8_t const *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+      m_writer->Write ((uint8_t const *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+      m_writer->Write ((uint8_t const *)&headerOut->m_type, sizeof(headerOut->m_type));
+      return;
+    }
+
+  //
+  // If we're initializing the file, we need to write the pcap file header
+  // at the start of the file.  (The stream of a buffered file is never
+  // opened, and seeking it would set its fail bit.)
+  //
+  m_file.seekp (0, std::ios::beg);
+
   //
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
@@ -333,6 +372,23 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
   mode |= std::ios::binary;
 
   m_filename=filename;
+
+  delete m_writer;
+  m_writer = 0;
+  if (m_writeBufferSize > 0 && (mode & std::ios::out) && !(mode & std::ios::in))
+    {
+      //
+      // Records go through the buffered writer; the stream is left closed
+      // and only carries the fail bit if the file cannot be created.
+      //
+      m_writer = new PcapAsyncWriter (m_writeBufferSize);
+      if (!m_writer->Open (filename))
+        {
+          m_file.setstate (std::ios::failbit);
+        }
+      return;
+    }
+
   m_file.open (filename.c_str (), mode);
   if (mode & std::ios::in)
     {
@@ -418,6 +474,16 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
       Swap (&header, &header);
     }
 
+  if (m_writer != 0)
+    {
+      uint8_t *buf = m_writer->Reserve (16);
+      std::memcpy (buf, &header.m_tsSec, 4);
+      std::memcpy (buf + 4, &header.m_tsUsec, 4);
+      std::memcpy (buf + 8, &header.m_inclLen, 4);
+      std::memcpy (buf + 12, &header.m_origLen, 4);
+      return inclLen;
+    }
+
   //
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
@@ -435,6 +501,11 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
+  if (m_writer != 0)
+    {
+      m_writer->Write (data, inclLen);
+      return;
+    }
   m_file.write ((const char *)data, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
 }
@@ -444,6 +515,12 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
+  if (m_writer != 0)
+    {
+      // Copy (at most snaplen bytes) straight into the write buffer
+      p->CopyData (m_writer->Reserve (inclLen), inclLen);
+      return;
+    }
   p->CopyData (&m_file, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
 }
@@ -460,6 +537,13 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
+  if (m_writer != 0)
+    {
+      uint8_t *buf = m_writer->Reserve (inclLen);
+      headerBuffer.CopyData (buf, toCopy);
+      p->CopyData (buf + toCopy, inclLen - toCopy);
+      return;
+    }
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
   p->CopyData (&m_file, inclLen);
@@ -528,79 +612,82 @@ bool
 PcapFile::Diff (std::string const & f1, std::string const & f2, 
                 uint32_t & sec, uint32_t & usec, uint32_t & packets,
                 uint32_t snapLen)
+{
+  bool fail;
+  return Diff (f1, f2, sec, usec, packets, fail, snapLen);
+}
+
+bool
+PcapFile::Diff (std::string const & f1, std::string const & f2,
+                uint32_t & sec, uint32_t & usec, uint32_t & packets,
+                bool & fail, uint32_t snapLen)
 {
   NS_LOG_FUNCTION (f1 << f2 << sec << usec << snapLen);
-  PcapFile pcap1, pcap2;
-  pcap1.Open (f1, std::ios::in);
-  pcap2.Open (f2, std::ios::in);
-  bool bad = pcap1.Fail () || pcap2.Fail ();
-  if (bad)
+  //
+  // Both files are memory-mapped and indexed up front, so the comparison
+  // below works on pointers into the mappings without any copy.
+  //
+  PcapFileReader pcap1, pcap2;
+  pcap1.Open (f1);
+  pcap2.Open (f2);
+  fail = pcap1.Fail () || pcap2.Fail ();
+  if (fail)
     {
       return true;
     }
 
-  uint8_t *data1 = new uint8_t [snapLen] ();
-  uint8_t *data2 = new uint8_t [snapLen] ();
-  uint32_t tsSec1 = 0;
-  uint32_t tsSec2 = 0;
-  uint32_t tsUsec1 = 0;
-  uint32_t tsUsec2 = 0;
-  uint32_t inclLen1 = 0;
-  uint32_t inclLen2 = 0;
-  uint32_t origLen1 = 0;
-  uint32_t origLen2 = 0;
-  uint32_t readLen1 = 0;
-  uint32_t readLen2 = 0;
+  std::size_t n1 = pcap1.GetNRecords ();
+  std::size_t n2 = pcap2.GetNRecords ();
+  std::size_t n = std::min (n1, n2);
   bool diff = false;
-
-  while (!pcap1.Eof () && !pcap2.Eof ())
+  std::size_t i = 0;
+  for (; i < n; ++i)
     {
-      pcap1.Read (data1, snapLen, tsSec1, tsUsec1, inclLen1, origLen1, readLen1);
-      pcap2.Read (data2, snapLen, tsSec2, tsUsec2, inclLen2, origLen2, readLen2);
-
-      bool same = pcap1.Fail () == pcap2.Fail ();
-      if (!same)
-        {
-          diff = true;
-          break;
-        }
-      if (pcap1.Eof ())
-        {
-          break;
-        }
-
+      PcapFileReader::Record const &r1 = pcap1.GetRecord (i);
+      PcapFileReader::Record const &r2 = pcap2.GetRecord (i);
       ++packets;
-      
-      if (tsSec1 != tsSec2 || tsUsec1 != tsUsec2)
+
+      if (r1.tsSec != r2.tsSec || r1.tsUsec != r2.tsUsec)
         {
           diff = true; // Next packet timestamps do not match
           break;
         }
 
+      uint32_t readLen1 = std::min (snapLen, r1.inclLen);
+      uint32_t readLen2 = std::min (snapLen, r2.inclLen);
       if (readLen1 != readLen2)
         {
           diff = true; // Packet lengths do not match
           break;
         }
 
-      if (std::memcmp (data1, data2, readLen1) != 0)
+      if (std::memcmp (r1.data, r2.data, readLen1) != 0)
         {
           diff = true; // Packet data do not match
           break;
         }
     }
-  sec = tsSec1;
-  usec = tsUsec1;
 
-  bad = pcap1.Fail () || pcap2.Fail ();
-  bool eof = pcap1.Eof () && pcap2.Eof ();
-  if (bad && !eof)
+  if (!diff && (n1 != n2 || pcap1.IsTruncated () != pcap2.IsTruncated ()))
     {
-      diff = true;
+      diff = true; // One of the files has more records
     }
 
-  delete[] data1;
-  delete[] data2;
+  if (i < n1)
+    {
+      sec = pcap1.GetRecord (i).tsSec;
+      usec = pcap1.GetRecord (i).tsUsec;
+    }
+  else if (n1 > 0)
+    {
+      sec = pcap1.GetRecord (n1 - 1).tsSec;
+      usec = pcap1.GetRecord (n1 - 1).tsUsec;
+    }
+  else
+    {
+      sec = 0;
+      usec = 0;
+    }
 
   return diff;
 }
@@ -30,6 +30,7 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class PcapAsyncWriter;
 
 
 /**
@@ -62,6 +63,25 @@ public:
    */
   void Clear (void);
 
+  /**
+   * \brief Enable buffered, asynchronous writing
+   *
+   * When a non-zero size is set, files subsequently opened for writing
+   * (and not for reading) are written through a PcapAsyncWriter: records
+   * are assembled in buffers of the given size and flushed to disk by a
+   * background thread.  Data is guaranteed to be on disk only after Close.
+   * Must be called before Open.
+   *
+   * \param bufferSize size in bytes of each write buffer; zero (the
+   * default) selects the unbuffered std::fstream output path.
+   */
+  void SetWriteBufferSize (uint32_t bufferSize);
+
+  /**
+   * \return the write buffer size; zero if buffered writing is disabled
+   */
+  uint32_t GetWriteBufferSize (void) const;
+
   /**
    * Create a new pcap file or open an existing pcap file.  Semantics are
    * similar to the stdc++ io stream classes, but differ in that
@@ -289,6 +309,23 @@ public:
                     uint32_t & sec, uint32_t & usec, uint32_t & packets,
                     uint32_t snapLen = SNAPLEN_DEFAULT);
 
+  /**
+   * \brief Compare two PCAP files packet-by-packet
+   *
+   * \return true if files are different or cannot be read, false otherwise
+   *
+   * \param  f1         First PCAP file name
+   * \param  f2         Second PCAP file name
+   * \param  sec        [out] Time stamp of first different packet, seconds. Undefined if files doesn't differ.
+   * \param  usec       [out] Time stamp of first different packet, microseconds. Undefined if files doesn't differ.
+   * \param  packets    [out] Number of first different packet. Total number of parsed packets if files doesn't differ.
+   * \param  fail       [out] true if either file cannot be read, false otherwise
+   * \param  snapLen    Snap length (if used)
+   */
+  static bool Diff (std::string const & f1, std::string const & f2,
+                    uint32_t & sec, uint32_t & usec, uint32_t & packets,
+                    bool & fail, uint32_t snapLen = SNAPLEN_DEFAULT);
+
 private:
   /**
    * \brief Pcap file header
@@ -371,6 +408,8 @@ private:
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
+  uint32_t m_writeBufferSize;   //!< write buffer size, zero if unbuffered
+  PcapAsyncWriter *m_writer;    //!< buffered writer, if enabled for this file
 };
 
 } // namespace ns3
@@ -30,7 +30,10 @@
 /**
  * \brief Test that a pair of reference/new pcap files are equal
  *
- * The filename is interpreted as a stream.
+ * The filename is interpreted as a stream.  Both files are compared with
+ * PcapFile::Diff, which memory-maps them, so either may be in pcap or
+ * pcapng format.  A trace that cannot be read at all is reported
+ * separately from a trace whose contents differ.
  *
  * \param filename The name of the file to read in the reference/temporary
  *        directories
@@ -42,9 +45,13 @@
     std::string expected = CreateDataDirFilename (oss.str());           \
     std::string got = CreateTempDirFilename (oss.str());                \
     uint32_t sec(0), usec(0), packets(0);				\
+    bool fail(false);                                                   \
     /** \todo support default PcapWriter snap length here */		\
-    bool diff = PcapFile::Diff (got, expected, sec, usec, packets);	\
-    NS_TEST_EXPECT_MSG_EQ (diff, false,                                 \
+    bool diff = PcapFile::Diff (got, expected, sec, usec, packets, fail); \
+    NS_TEST_EXPECT_MSG_EQ (fail, false,                                 \
+                           "PCAP trace " << got << " or " << expected   \
+                           << " cannot be read");                       \
+    NS_TEST_EXPECT_MSG_EQ (diff && !fail, false,                        \
                            "PCAP traces "				\
 			   << got << " and " << expected		\
                            << " differ starting from packet "		\
@@ -0,0 +1,294 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/packet.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "pcapng-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapNgFile");
+
+namespace {
+
+const uint32_t SECTION_HEADER_BLOCK = 0x0a0d0d0a;       //!< SHB type
+const uint32_t INTERFACE_DESCRIPTION_BLOCK = 1;         //!< IDB type
+const uint32_t ENHANCED_PACKET_BLOCK = 6;               //!< EPB type
+const uint32_t BYTE_ORDER_MAGIC = 0x1a2b3c4d;           //!< byte order magic
+const uint16_t OPT_END = 0;                             //!< opt_endofopt
+const uint16_t OPT_COMMENT = 1;                         //!< opt_comment option
+const uint16_t IF_NAME = 2;                             //!< if_name option
+const uint16_t IF_DESCRIPTION = 3;                      //!< if_description option
+const uint16_t IF_TSRESOL = 9;                          //!< if_tsresol option
+const uint16_t IF_TSOFFSET = 14;                        //!< if_tsoffset option
+const uint32_t EPB_FIXED_SIZE = 32;                     //!< EPB size without data
+
+/**
+ * \param v a length
+ * \return the length rounded up to a multiple of four
+ */
+inline uint32_t
+Pad4 (uint32_t v)
+{
+  return (v + 3) & ~3U;
+}
+
+/**
+ * \brief Store a 16-bit value and advance
+ * \param p the output pointer
+ * \param v the value
+ */
+inline void
+Put16 (uint8_t *&p, uint16_t v)
+{
+  std::memcpy (p, &v, 2);
+  p += 2;
+}
+
+/**
+ * \brief Store a 32-bit value and advance
+ * \param p the output pointer
+ * \param v the value
+ */
+inline void
+Put32 (uint8_t *&p, uint32_t v)
+{
+  std::memcpy (p, &v, 4);
+  p += 4;
+}
+
+/**
+ * \brief Store a 64-bit value and advance
+ * \param p the output pointer
+ * \param v the value
+ */
+inline void
+Put64 (uint8_t *&p, uint64_t v)
+{
+  std::memcpy (p, &v, 8);
+  p += 8;
+}
+
+/**
+ * \brief Store a string option (padded to 32 bits) and advance
+ * \param p the output pointer
+ * \param code the option code
+ * \param s the option value
+ */
+void
+PutStringOption (uint8_t *&p, uint16_t code, std::string const &s)
+{
+  Put16 (p, code);
+  Put16 (p, s.size ());
+  std::memcpy (p, s.data (), s.size ());
+  std::memset (p + s.size (), 0, Pad4 (s.size ()) - s.size ());
+  p += Pad4 (s.size ());
+}
+
+} // unnamed namespace
+
+PcapNgFile::PcapNgFile ()
+  : m_writer (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapNgFile::~PcapNgFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+  delete m_writer;
+}
+
+bool
+PcapNgFile::Open (std::string const &filename, PcapAsyncWriter::Compression compression,
+                  uint32_t bufferSize)
+{
+  NS_LOG_FUNCTION (this << filename << compression << bufferSize);
+  NS_ASSERT_MSG (m_writer == 0, "PcapNgFile already open");
+  m_writer = new PcapAsyncWriter (bufferSize);
+  m_writer->SetCompression (compression);
+  if (!m_writer->Open (filename))
+    {
+      return false;
+    }
+
+  //
+  // Section Header Block, without options and with an unspecified
+  // section length since the file is written sequentially.
+  //
+  uint8_t *p = m_writer->Reserve (28);
+  Put32 (p, SECTION_HEADER_BLOCK);
+  Put32 (p, 28);
+  Put32 (p, BYTE_ORDER_MAGIC);
+  Put16 (p, 1);
+  Put16 (p, 0);
+  Put32 (p, 0xffffffff);
+  Put32 (p, 0xffffffff);
+  Put32 (p, 28);
+  return true;
+}
+
+void
+PcapNgFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      m_writer->Close ();
+    }
+}
+
+bool
+PcapNgFile::Fail (void) const
+{
+  return m_writer == 0 || m_writer->Fail ();
+}
+
+const uint32_t PcapNgFile::NO_DEVICE;
+
+uint32_t
+PcapNgFile::AddInterface (uint32_t dataLinkType, uint32_t snapLen,
+                          std::string const &name, std::string const &description,
+                          int32_t tzCorrection, uint32_t nodeId, uint32_t deviceId)
+{
+  NS_LOG_FUNCTION (this << dataLinkType << snapLen << name << description <<
+                   tzCorrection << nodeId << deviceId);
+  NS_ASSERT (m_writer != 0);
+  NS_ASSERT (name.size () < 0xffff && description.size () < 0xffff);
+
+  uint32_t length = 8 + 8                              // block header, link type, snap length
+    + 4 + Pad4 (name.size ())                          // if_name
+    + 4 + Pad4 (description.size ())                   // if_description
+    + 4 + 4                                            // if_tsresol
+    + (tzCorrection != 0 ? 4 + 8 : 0)                  // if_tsoffset
+    + 4                                                // opt_endofopt
+    + 4;                                               // block trailer
+  uint8_t *p = m_writer->Reserve (length);
+  Put32 (p, INTERFACE_DESCRIPTION_BLOCK);
+  Put32 (p, length);
+  Put16 (p, dataLinkType);
+  Put16 (p, 0);
+  Put32 (p, snapLen);
+  PutStringOption (p, IF_NAME, name);
+  PutStringOption (p, IF_DESCRIPTION, description);
+  Put16 (p, IF_TSRESOL);
+  Put16 (p, 1);
+  Put32 (p, 9);                                        // 10^-9 s, padded
+  if (tzCorrection != 0)
+    {
+      Put16 (p, IF_TSOFFSET);
+      Put16 (p, 8);
+      Put64 (p, static_cast<int64_t> (tzCorrection));
+    }
+  Put16 (p, OPT_END);
+  Put16 (p, 0);
+  Put32 (p, length);
+
+  std::string comment;
+  if (nodeId != NO_DEVICE && deviceId != NO_DEVICE)
+    {
+      std::ostringstream oss;
+      oss << "node=" << nodeId << " device=" << deviceId;
+      comment = oss.str ();
+    }
+  m_snapLen.push_back (snapLen);
+  m_packetComment.push_back (comment);
+  return m_snapLen.size () - 1;
+}
+
+uint32_t
+PcapNgFile::GetNInterfaces (void) const
+{
+  return m_snapLen.size ();
+}
+
+uint8_t *
+PcapNgFile::BeginPacketBlock (uint32_t interfaceId, uint64_t tsNs, uint32_t totalLen, uint32_t &inclLen)
+{
+  NS_ASSERT_MSG (interfaceId < m_snapLen.size (), "Unknown pcapng interface " << interfaceId);
+  inclLen = std::min (totalLen, m_snapLen[interfaceId]);
+  uint32_t padded = Pad4 (inclLen);
+  std::string const &comment = m_packetComment[interfaceId];
+  uint32_t options = comment.empty () ? 0 : 4 + Pad4 (comment.size ()) + 4;
+  uint32_t length = EPB_FIXED_SIZE + padded + options;
+
+  //
+  // The whole block is reserved at once, so the packet bytes are copied
+  // exactly once, straight into the shared write buffer.
+  //
+  uint8_t *p = m_writer->Reserve (length);
+  Put32 (p, ENHANCED_PACKET_BLOCK);
+  Put32 (p, length);
+  Put32 (p, interfaceId);
+  Put32 (p, tsNs >> 32);
+  Put32 (p, tsNs & 0xffffffff);
+  Put32 (p, inclLen);
+  Put32 (p, totalLen);
+  uint8_t *data = p;
+  p += padded;
+  std::memset (p - (padded - inclLen), 0, padded - inclLen);
+  if (!comment.empty ())
+    {
+      PutStringOption (p, OPT_COMMENT, comment);
+      Put16 (p, OPT_END);
+      Put16 (p, 0);
+    }
+  Put32 (p, length);
+  return data;
+}
+
+void
+PcapNgFile::Write (uint32_t interfaceId, uint64_t tsNs, uint8_t const *data, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << interfaceId << tsNs << &data << totalLen);
+  uint32_t inclLen;
+  uint8_t *out = BeginPacketBlock (interfaceId, tsNs, totalLen, inclLen);
+  std::memcpy (out, data, inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interfaceId, uint64_t tsNs, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interfaceId << tsNs << p);
+  uint32_t inclLen;
+  uint8_t *out = BeginPacketBlock (interfaceId, tsNs, p->GetSize (), inclLen);
+  p->CopyData (out, inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interfaceId, uint64_t tsNs, const Header &header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interfaceId << tsNs << &header << p);
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t inclLen;
+  uint8_t *out = BeginPacketBlock (interfaceId, tsNs, headerSize + p->GetSize (), inclLen);
+
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (out, toCopy);
+  p->CopyData (out + toCopy, inclLen - toCopy);
+}
+
+} // namespace ns3
@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_H
+#define PCAPNG_FILE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "pcap-async-writer.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+
+/**
+ * \brief A pcapng capture file shared by many traced devices
+ *
+ * Each traced device is registered as a pcapng interface with its own
+ * Interface Description Block (link type, snap length, name and
+ * description), and every packet is written as an Enhanced Packet Block
+ * whose interface ID identifies the device it was captured on.  All
+ * interfaces share a single PcapAsyncWriter, so a simulation with
+ * hundreds of traced devices uses a single file descriptor and large
+ * sequential writes, optionally compressed.
+ *
+ * When the node and device of an interface are known, each of its
+ * Enhanced Packet Blocks also carries them in an opt_comment option
+ * ("node=N device=D"), so they survive tools that renumber interfaces.
+ *
+ * Timestamps are written with nanosecond resolution.  Blocks are written
+ * in host byte order, as allowed by the format.
+ */
+class PcapNgFile : public SimpleRefCount<PcapNgFile>
+{
+public:
+  /// Node or device ID of an interface that is not bound to a device
+  static const uint32_t NO_DEVICE = 0xffffffff;
+
+  PcapNgFile ();
+  ~PcapNgFile ();
+
+  /**
+   * \brief Create the file and write the Section Header Block
+   * \param filename the file name
+   * \param compression output compression
+   * \param bufferSize size in bytes of each shared write buffer
+   * \return true on success
+   */
+  bool Open (std::string const &filename,
+             PcapAsyncWriter::Compression compression = PcapAsyncWriter::NONE,
+             uint32_t bufferSize = 1 << 20);
+
+  /**
+   * \brief Flush all buffered blocks and close the file
+   */
+  void Close (void);
+
+  /**
+   * \return true if the file could not be created or a write failed
+   */
+  bool Fail (void) const;
+
+  /**
+   * \brief Register an interface by writing its Interface Description Block
+   * \param dataLinkType the data link type of packets on this interface
+   * \param snapLen maximum number of bytes stored per packet
+   * \param name the interface name (if_name option)
+   * \param description the interface description (if_description option)
+   * \param tzCorrection correction in seconds to add to the timestamps to
+   *        obtain GMT (if_tsoffset option, omitted when zero)
+   * \param nodeId the ID of the node of the traced device, or NO_DEVICE
+   * \param deviceId the index of the traced device on its node, or NO_DEVICE
+   * \return the interface ID to pass to Write
+   */
+  uint32_t AddInterface (uint32_t dataLinkType, uint32_t snapLen,
+                         std::string const &name, std::string const &description,
+                         int32_t tzCorrection = 0,
+                         uint32_t nodeId = NO_DEVICE, uint32_t deviceId = NO_DEVICE);
+
+  /**
+   * \return the number of registered interfaces
+   */
+  uint32_t GetNInterfaces (void) const;
+
+  /**
+   * \brief Write a packet as an Enhanced Packet Block
+   * \param interfaceId the interface the packet was captured on
+   * \param tsNs timestamp in nanoseconds
+   * \param data the packet data
+   * \param totalLen the packet length
+   */
+  void Write (uint32_t interfaceId, uint64_t tsNs, uint8_t const *data, uint32_t totalLen);
+
+  /**
+   * \brief Write a packet as an Enhanced Packet Block
+   * \param interfaceId the interface the packet was captured on
+   * \param tsNs timestamp in nanoseconds
+   * \param p the packet
+   */
+  void Write (uint32_t interfaceId, uint64_t tsNs, Ptr<const Packet> p);
+
+  /**
+   * \brief Write a header and a packet as an Enhanced Packet Block
+   * \param interfaceId the interface the packet was captured on
+   * \param tsNs timestamp in nanoseconds
+   * \param header the header to write in front of the packet
+   * \param p the packet
+   */
+  void Write (uint32_t interfaceId, uint64_t tsNs, const Header &header, Ptr<const Packet> p);
+
+private:
+  /**
+   * \brief Reserve an Enhanced Packet Block and fill in everything but
+   * the packet data
+   * \param interfaceId the interface ID
+   * \param tsNs timestamp in nanoseconds
+   * \param totalLen the original packet length
+   * \param inclLen [out] number of packet bytes to copy
+   * \return pointer to the packet data area of the block
+   */
+  uint8_t * BeginPacketBlock (uint32_t interfaceId, uint64_t tsNs, uint32_t totalLen, uint32_t &inclLen);
+
+  PcapAsyncWriter *m_writer;         //!< shared buffered writer
+  std::vector<uint32_t> m_snapLen;   //!< snap length of each interface
+  std::vector<std::string> m_packetComment; //!< EPB comment of each interface (may be empty)
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_H */
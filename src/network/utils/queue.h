@@ -33,6 +33,7 @@
 #include <string>
 #include <sstream>
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -272,6 +273,17 @@ public:
    */
   virtual Ptr<Item> Dequeue (void) = 0;
 
+  /**
+   * Remove up to maxItems items from the Queue, in the order they would be
+   * returned by successive calls to Dequeue, and append them to items.
+   * The default implementation simply calls Dequeue repeatedly; subclasses
+   * may override it to avoid the per-item virtual call.
+   * \param items the vector to append the dequeued items to
+   * \param maxItems the maximum number of items to dequeue
+   * \return the number of items dequeued
+   */
+  virtual uint32_t DequeueBurst (std::vector<Ptr<Item> > &items, uint32_t maxItems);
+
   /**
    * Remove an item from the Queue (each subclass defines the position),
    * counting it as dropped
@@ -525,6 +537,26 @@ Queue<Item>::DoRemove (ConstIterator pos)
   return item;
 }
 
+template <typename Item>
+uint32_t
+Queue<Item>::DequeueBurst (std::vector<Ptr<Item> > &items, uint32_t maxItems)
+{
+  NS_LOG_FUNCTION (this << maxItems);
+
+  uint32_t n = 0;
+  while (n < maxItems)
+    {
+      Ptr<Item> item = Dequeue ();
+      if (item == 0)
+        {
+          break;
+        }
+      items.push_back (item);
+      n++;
+    }
+  return n;
+}
+
 template <typename Item>
 void
 Queue<Item>::Flush (void)
@@ -458,6 +458,53 @@ SimpleNetDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protoco
   return SendFrom (packet, m_address, dest, protocolNumber);
 }
 
+uint32_t
+SimpleNetDevice::SendBurst (std::vector<Ptr<Packet> > const &packets, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packets.size () << dest << protocolNumber);
+
+  Mac48Address to = Mac48Address::ConvertFrom (dest);
+  SimpleTag tag;
+  tag.SetSrc (m_address);
+  tag.SetDst (to);
+  tag.SetProto (protocolNumber);
+
+  uint32_t accepted = 0;
+  for (std::vector<Ptr<Packet> >::const_iterator i = packets.begin (); i != packets.end (); ++i)
+    {
+      Ptr<Packet> p = *i;
+      if (p->GetSize () > GetMtu ())
+        {
+          continue;
+        }
+      accepted++;
+      Ptr<Packet> packet = p->Copy ();
+      p->AddPacketTag (tag);
+      if (!m_queue->Enqueue (p))
+        {
+          m_channel->Send (packet, protocolNumber, to, m_address, this);
+        }
+      //
+      // As in SendFrom, an idle transmitter starts on the first packet right
+      // away; TransmitComplete drains the rest of the burst.
+      //
+      else if (!TransmitCompleteEvent.IsRunning ())
+        {
+          p = m_queue->Dequeue ();
+          SimpleTag head;
+          p->RemovePacketTag (head);
+          Time txTime = Time (0);
+          if (m_bps > DataRate (0))
+            {
+              txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
+            }
+          m_channel->Send (p, head.GetProto (), head.GetDst (), head.GetSrc (), this);
+          TransmitCompleteEvent = Simulator::Schedule (txTime, &SimpleNetDevice::TransmitComplete, this);
+        }
+    }
+  return accepted;
+}
+
 bool
 SimpleNetDevice::SendFrom (Ptr<Packet> p, const Address& source, const Address& dest, uint16_t protocolNumber)
 {
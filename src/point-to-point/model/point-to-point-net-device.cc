@@ -592,6 +592,55 @@ PointToPointNetDevice::Send (
   return false;
 }
 
+uint32_t
+PointToPointNetDevice::SendBurst (
+  std::vector<Ptr<Packet> > const &packets,
+  const Address &dest,
+  uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packets.size () << dest << protocolNumber);
+
+  if (IsLinkUp () == false)
+    {
+      for (std::vector<Ptr<Packet> >::const_iterator i = packets.begin (); i != packets.end (); ++i)
+        {
+          m_macTxDropTrace (*i);
+        }
+      return 0;
+    }
+
+  //
+  // The link is checked once for the whole burst.  As in Send, an idle
+  // transmitter takes the first packet off the queue as soon as it is
+  // queued, so that a burst larger than the queue drops exactly the
+  // packets that the same sequence of Send calls would drop; the
+  // remaining packets are picked up by TransmitComplete.
+  //
+  uint32_t accepted = 0;
+  for (std::vector<Ptr<Packet> >::const_iterator i = packets.begin (); i != packets.end (); ++i)
+    {
+      Ptr<Packet> packet = *i;
+      AddHeader (packet, protocolNumber);
+      m_macTxTrace (packet);
+      if (m_queue->Enqueue (packet))
+        {
+          accepted++;
+          if (m_txMachineState == READY)
+            {
+              packet = m_queue->Dequeue ();
+              m_snifferTrace (packet);
+              m_promiscSnifferTrace (packet);
+              TransmitStart (packet);
+            }
+        }
+      else
+        {
+          m_macTxDropTrace (packet);
+        }
+    }
+  return accepted;
+}
+
 bool
 PointToPointNetDevice::SendFrom (Ptr<Packet> packet, 
                                  const Address &source, 
@@ -21,6 +21,7 @@
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/net-device-queue-interface.h"
@@ -101,6 +102,169 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for PointToPoint burst transmission
+ *
+ * It sends a burst of packets with SendBurst on one link and the same
+ * packets with one Send call each on another link, and checks that both
+ * devices accept and deliver the same packets, in order.  With a queue
+ * smaller than the burst, this checks that SendBurst drops the same
+ * packets as the sequential Send calls.
+ */
+class PointToPointBurstTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   *
+   * \param maxSize the maximum size of the transmit queues
+   * \param expected the number of packets expected to be accepted
+   */
+  PointToPointBurstTest (std::string maxSize, uint32_t expected);
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \return the packets of the burst
+   */
+  std::vector<Ptr<Packet> > MakeBurst (void) const;
+
+  /**
+   * \brief Send a burst of packets with SendBurst on the device specified
+   *
+   * \param device NetDevice to send on
+   */
+  void SendBurst (Ptr<PointToPointNetDevice> device);
+
+  /**
+   * \brief Send a burst of packets with Send on the device specified
+   *
+   * \param device NetDevice to send on
+   */
+  void SendEach (Ptr<PointToPointNetDevice> device);
+
+  /**
+   * \brief Receive callback
+   *
+   * \param device the receiving NetDevice
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  std::string m_maxSize;                   //!< maximum size of the transmit queues
+  uint32_t m_expected;                     //!< expected number of accepted packets
+  Ptr<NetDevice> m_burstReceiver;          //!< receiver of the SendBurst link
+  std::vector<uint32_t> m_receivedBurst;   //!< sizes of the packets received with SendBurst
+  std::vector<uint32_t> m_receivedEach;    //!< sizes of the packets received with Send
+  uint32_t m_acceptedBurst;                //!< value returned by SendBurst
+  uint32_t m_acceptedEach;                 //!< number of Send calls that returned true
+};
+
+PointToPointBurstTest::PointToPointBurstTest (std::string maxSize, uint32_t expected)
+  : TestCase ("PointToPoint burst with queue size " + maxSize),
+    m_maxSize (maxSize),
+    m_expected (expected),
+    m_acceptedBurst (0),
+    m_acceptedEach (0)
+{
+}
+
+std::vector<Ptr<Packet> >
+PointToPointBurstTest::MakeBurst (void) const
+{
+  std::vector<Ptr<Packet> > burst;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      burst.push_back (Create<Packet> (100 + i));
+    }
+  return burst;
+}
+
+void
+PointToPointBurstTest::SendBurst (Ptr<PointToPointNetDevice> device)
+{
+  m_acceptedBurst = device->SendBurst (MakeBurst (), device->GetBroadcast (), 0x800);
+}
+
+void
+PointToPointBurstTest::SendEach (Ptr<PointToPointNetDevice> device)
+{
+  std::vector<Ptr<Packet> > burst = MakeBurst ();
+  for (std::vector<Ptr<Packet> >::const_iterator i = burst.begin (); i != burst.end (); ++i)
+    {
+      if (device->Send (*i, device->GetBroadcast (), 0x800))
+        {
+          m_acceptedEach++;
+        }
+    }
+}
+
+bool
+PointToPointBurstTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  if (device == m_burstReceiver)
+    {
+      m_receivedBurst.push_back (p->GetSize ());
+    }
+  else
+    {
+      m_receivedEach.push_back (p->GetSize ());
+    }
+  return true;
+}
+
+void
+PointToPointBurstTest::DoRun (void)
+{
+  Ptr<PointToPointNetDevice> tx[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<Node> a = CreateObject<Node> ();
+      Ptr<Node> b = CreateObject<Node> ();
+      Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+      Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+      Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+      devA->Attach (channel);
+      devA->SetAddress (Mac48Address::Allocate ());
+      devA->SetQueue (CreateObjectWithAttributes<DropTailQueue<Packet> > ("MaxSize", StringValue (m_maxSize)));
+      devB->Attach (channel);
+      devB->SetAddress (Mac48Address::Allocate ());
+      devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+      a->AddDevice (devA);
+      b->AddDevice (devB);
+      // Node::AddDevice installs its own receive callback
+      devB->SetReceiveCallback (MakeCallback (&PointToPointBurstTest::Receive, this));
+      tx[i] = devA;
+      if (i == 0)
+        {
+          m_burstReceiver = devB;
+        }
+    }
+
+  Simulator::Schedule (Seconds (1.0), &PointToPointBurstTest::SendBurst, this, tx[0]);
+  Simulator::Schedule (Seconds (1.0), &PointToPointBurstTest::SendEach, this, tx[1]);
+
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_acceptedBurst, m_expected, "Wrong number of packets accepted by SendBurst");
+  NS_TEST_EXPECT_MSG_EQ (m_acceptedEach, m_expected, "Wrong number of packets accepted by Send");
+  NS_TEST_EXPECT_MSG_EQ (m_receivedBurst.size (), m_expected, "Wrong number of packets received");
+  NS_TEST_EXPECT_MSG_EQ ((m_receivedBurst == m_receivedEach), true,
+                         "SendBurst and Send must deliver the same packets, in order");
+
+  m_burstReceiver = 0;
+  Simulator::Destroy ();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -117,6 +281,9 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointBurstTest ("100p", 10), TestCase::QUICK);
+  // One packet is transmitted at once, five more are queued
+  AddTestCase (new PointToPointBurstTest ("5p", 6), TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
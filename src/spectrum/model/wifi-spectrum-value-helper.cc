@@ -131,9 +131,129 @@ WifiSpectrumValueHelper::GetSpectrumModel (uint32_t centerFrequency, uint16_t ch
   return ret;
 }
 
-// Power allocated to 71 center subbands out of 135 total subbands in the band
+///< Key of a cached power spectral density or RF filter
+struct WifiSpectrumValueId
+{
+  /**
+   * Constructor
+   * \param t the kind of spectrum value
+   * \param f the frequency (in MHz)
+   * \param w the channel width (in MHz)
+   * \param b the width of each band (in Hz)
+   * \param g the guard band width (in MHz)
+   */
+  WifiSpectrumValueId (uint8_t t, uint32_t f, uint16_t w, double b, uint16_t g);
+  uint8_t m_type;             ///< kind of spectrum value
+  WifiSpectrumModelId m_model; ///< parameters of the spectrum model
+};
+
+WifiSpectrumValueId::WifiSpectrumValueId (uint8_t t, uint32_t f, uint16_t w, double b, uint16_t g)
+  : m_type (t),
+    m_model (f, w, b, g)
+{
+}
+
+/**
+ * Less than operator
+ * \param a the first spectrum value key to compare
+ * \param b the second spectrum value key to compare
+ * \returns true if the first key is less than the second key
+ */
+bool
+operator < (const WifiSpectrumValueId& a, const WifiSpectrumValueId& b)
+{
+  return (a.m_type < b.m_type)
+         || ((a.m_type == b.m_type) && (a.m_model < b.m_model));
+}
+
+static std::map<WifiSpectrumValueId, Ptr<const SpectrumValue> > g_wifiSpectrumValueMap; ///< transmit PSDs of 1 W and RF filters, built on first use
+
+Ptr<const SpectrumValue>
+WifiSpectrumValueHelper::GetSpectrumValue (SpectrumValueType type, uint32_t centerFrequency, uint16_t channelWidth,
+                                           double bandBandwidth, uint16_t guardBandwidth)
+{
+  WifiSpectrumValueId key (type, centerFrequency, channelWidth, bandBandwidth, guardBandwidth);
+  std::map<WifiSpectrumValueId, Ptr<const SpectrumValue> >::const_iterator it = g_wifiSpectrumValueMap.find (key);
+  if (it != g_wifiSpectrumValueMap.end ())
+    {
+      return it->second;
+    }
+  NS_LOG_LOGIC ("building spectrum value " << +type << " for " << centerFrequency << " MHz, " << channelWidth << " MHz wide");
+  Ptr<const SpectrumValue> value;
+  switch (type)
+    {
+    case DSSS_PSD:
+      value = DoCreateDsssTxPowerSpectralDensity (centerFrequency, 1.0, guardBandwidth);
+      break;
+    case OFDM_PSD:
+      value = DoCreateOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, 1.0, guardBandwidth);
+      break;
+    case HT_OFDM_PSD:
+      value = DoCreateHtOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, 1.0, guardBandwidth);
+      break;
+    case HE_OFDM_PSD:
+      value = DoCreateHeOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, 1.0, guardBandwidth);
+      break;
+    case RF_FILTER:
+      value = DoCreateRfFilter (centerFrequency, channelWidth, bandBandwidth, guardBandwidth);
+      break;
+    }
+  g_wifiSpectrumValueMap.insert (std::make_pair (key, value));
+  return value;
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::Scale (Ptr<const SpectrumValue> psd, double txPowerW)
+{
+  Ptr<SpectrumValue> c = psd->Copy ();
+  (*c) *= txPowerW;
+  return c;
+}
+
 Ptr<SpectrumValue>
 WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << txPowerW << +guardBandwidth);
+  return Scale (GetSpectrumValue (DSSS_PSD, centerFrequency, 22, 0, guardBandwidth), txPowerW);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
+  return Scale (GetSpectrumValue (OFDM_PSD, centerFrequency, channelWidth, 0, guardBandwidth), txPowerW);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
+  return Scale (GetSpectrumValue (HT_OFDM_PSD, centerFrequency, channelWidth, 0, guardBandwidth), txPowerW);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
+  return Scale (GetSpectrumValue (HE_OFDM_PSD, centerFrequency, channelWidth, 0, guardBandwidth), txPowerW);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateRfFilter (uint32_t centerFrequency, uint16_t channelWidth, double bandBandwidth, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << bandBandwidth << guardBandwidth);
+  return GetRfFilter (centerFrequency, channelWidth, bandBandwidth, guardBandwidth)->Copy ();
+}
+
+Ptr<const SpectrumValue>
+WifiSpectrumValueHelper::GetRfFilter (uint32_t centerFrequency, uint16_t channelWidth, double bandBandwidth, uint16_t guardBandwidth)
+{
+  return GetSpectrumValue (RF_FILTER, centerFrequency, channelWidth, bandBandwidth, guardBandwidth);
+}
+
+// Power allocated to 71 center subbands out of 135 total subbands in the band
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::DoCreateDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth)
 {
   NS_LOG_FUNCTION (centerFrequency << txPowerW << +guardBandwidth);
   uint16_t channelWidth = 22;  // DSSS channels are 22 MHz wide
@@ -157,7 +277,7 @@ WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (uint32_t centerFreque
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+WifiSpectrumValueHelper::DoCreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
   double bandBandwidth = 0;
@@ -210,7 +330,7 @@ WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (uint32_t centerFreque
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+WifiSpectrumValueHelper::DoCreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
   double bandBandwidth = 312500;
@@ -327,7 +447,7 @@ WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (uint32_t centerFreq
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+WifiSpectrumValueHelper::DoCreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
   double bandBandwidth = 78125;
@@ -449,7 +569,7 @@ WifiSpectrumValueHelper::CreateNoisePowerSpectralDensity (double noiseFigureDb,
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateRfFilter (uint32_t centerFrequency, uint16_t channelWidth, double bandGranularity, uint16_t guardBandwidth)
+WifiSpectrumValueHelper::DoCreateRfFilter (uint32_t centerFrequency, uint16_t channelWidth, double bandGranularity, uint16_t guardBandwidth)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << bandGranularity << guardBandwidth);
   Ptr<SpectrumValue> c = Create <SpectrumValue> (GetSpectrumModel (centerFrequency, channelWidth, bandGranularity, guardBandwidth));
@@ -34,6 +34,11 @@ namespace ns3 {
  *  This class defines all functions to create a spectrum model for
  *  Wi-Fi based on a a spectral model aligned with an OFDM subcarrier
  *  spacing of 312.5 KHz (model also reused for DSSS modulations)
+ *
+ *  Transmit power spectral densities and RF filters are built once per
+ *  set of parameters and kept for the rest of the simulation: a transmit
+ *  power spectral density is then a copy of the cached one for 1 W,
+ *  scaled to the requested power.
  */
 class WifiSpectrumValueHelper
 {
@@ -146,6 +151,17 @@ public:
    * to an received power spectral density
    */
   static Ptr<SpectrumValue> CreateRfFilter (uint32_t centerFrequency, uint16_t channelWidth, double bandBandwidth, uint16_t guardBandwidth);
+  /**
+   * Return the RF filter CreateRfFilter would create.  The filter is built
+   * on the first call with the given parameters and shared by all the
+   * callers, so it must not be modified.
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param bandBandwidth width of each band (Hz)
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return a pointer to the shared SpectrumValue representing the RF filter
+   */
+  static Ptr<const SpectrumValue> GetRfFilter (uint32_t centerFrequency, uint16_t channelWidth, double bandBandwidth, uint16_t guardBandwidth);
 
   /**
    * typedef for a pair of start and stop sub-band indexes
@@ -210,6 +226,80 @@ public:
    * \return the equivalent Watts for the given dBm
    */
   static double DbmToW (double dbm);
+
+private:
+  /// The kinds of cached spectrum values
+  enum SpectrumValueType
+  {
+    DSSS_PSD,
+    OFDM_PSD,
+    HT_OFDM_PSD,
+    HE_OFDM_PSD,
+    RF_FILTER
+  };
+
+  /**
+   * Return a transmit power spectral density of 1 W, or an RF filter,
+   * building it on the first call with the given parameters.
+   * \param type the kind of spectrum value
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param bandBandwidth width of each band (Hz), only used by RF filters
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return the shared spectrum value
+   */
+  static Ptr<const SpectrumValue> GetSpectrumValue (SpectrumValueType type, uint32_t centerFrequency, uint16_t channelWidth,
+                                                    double bandBandwidth, uint16_t guardBandwidth);
+  /**
+   * \param psd a transmit power spectral density of 1 W
+   * \param txPowerW transmit power (W) to allocate
+   * \return a newly allocated copy of psd, scaled to txPowerW
+   */
+  static Ptr<SpectrumValue> Scale (Ptr<const SpectrumValue> psd, double txPowerW);
+  /**
+   * Build the DSSS transmit power spectral density
+   * \param centerFrequency center frequency (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \returns a pointer to a newly allocated SpectrumValue
+   */
+  static Ptr<SpectrumValue> DoCreateDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Build the OFDM transmit power spectral density
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return a pointer to a newly allocated SpectrumValue
+   */
+  static Ptr<SpectrumValue> DoCreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Build the HT OFDM transmit power spectral density
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return a pointer to a newly allocated SpectrumValue
+   */
+  static Ptr<SpectrumValue> DoCreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Build the HE OFDM transmit power spectral density
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return a pointer to a newly allocated SpectrumValue
+   */
+  static Ptr<SpectrumValue> DoCreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Build the RF filter
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param bandBandwidth width of each band (Hz)
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return a pointer to a newly allocated SpectrumValue
+   */
+  static Ptr<SpectrumValue> DoCreateRfFilter (uint32_t centerFrequency, uint16_t channelWidth, double bandBandwidth, uint16_t guardBandwidth);
 };
 
 /**
@@ -0,0 +1,133 @@
+## -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+# Merge the binary files written by AthstatsHelper::EnableAthstatsBinary
+# in several runs into a single binary file, or convert them to CSV.
+#
+# The files must have been written with the same reporting interval.  The
+# records are copied as they are, so that they keep the run number of the
+# simulation that wrote them; with --renumber, the run number of a record
+# is replaced by the position of its file on the command line, for runs
+# that differ by their parameters rather than by their RngRun.
+#
+# Sample usage:
+#   python athstats-merge.py -o sweep.athstats run-*.athstats
+#   python athstats-merge.py --csv sweep.athstats > sweep.csv
+
+from __future__ import print_function
+import sys
+import struct
+import argparse
+
+MAGIC = b'NS3ATHST'
+VERSION = 1
+HEADER = struct.Struct('<8sIIQ')
+FIELDS = ['run', 'node', 'device', 'report', 'tx', 'rx', 'short_retry', 'long_retry',
+          'exceeded_retry', 'phy_rx_ok', 'phy_rx_error', 'phy_tx']
+RECORD = struct.Struct('<%dI' % len(FIELDS))
+
+
+## Read the header of a file
+# @param f the file
+# @param name the file name
+# @return the reporting interval in nanoseconds
+def read_header(f, name):
+    data = f.read(HEADER.size)
+    if len(data) != HEADER.size:
+        raise ValueError('%s: truncated header' % name)
+    magic, version, record_size, interval = HEADER.unpack(data)
+    if magic != MAGIC or version != VERSION or record_size != RECORD.size:
+        raise ValueError('%s: not an athstats binary file (version %d)' % (name, VERSION))
+    return interval
+
+
+## Iterate over the records of a file, in blocks
+# @param f the file, positioned after the header
+# @param name the file name
+# @return the blocks of raw records
+def read_blocks(f, name):
+    block_size = RECORD.size * 4096
+    while True:
+        data = f.read(block_size)
+        if not data:
+            return
+        if len(data) % RECORD.size != 0:
+            raise ValueError('%s: truncated record' % name)
+        yield data
+
+
+## Open the input files and check that their intervals match
+# @param names the file names
+# @return the list of open files and the reporting interval
+def open_inputs(names):
+    files = []
+    interval = None
+    for name in names:
+        f = open(name, 'rb')
+        file_interval = read_header(f, name)
+        if interval is None:
+            interval = file_interval
+        elif file_interval != interval:
+            raise ValueError('%s: interval %d ns differs from %d ns' % (name, file_interval, interval))
+        files.append(f)
+    return files, interval
+
+
+## Renumber the records of a block
+# @param data the raw records
+# @param run the new run number
+# @return the renumbered records
+def renumber(data, run):
+    out = bytearray(data)
+    for offset in range(0, len(out), RECORD.size):
+        struct.pack_into('<I', out, offset, run)
+    return bytes(out)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Merge or convert athstats binary files')
+    parser.add_argument('inputs', nargs='+', help='binary files written by AthstatsHelper')
+    parser.add_argument('-o', '--output', help='merged binary file')
+    parser.add_argument('--csv', action='store_true', help='print the records as CSV')
+    parser.add_argument('--renumber', action='store_true',
+                        help='use the position of each input file as the run number')
+    args = parser.parse_args(argv[1:])
+    if args.output is None and not args.csv:
+        parser.error('one of --output or --csv is required')
+
+    files, interval = open_inputs(args.inputs)
+    out = None
+    if args.output is not None:
+        out = open(args.output, 'wb')
+        out.write(HEADER.pack(MAGIC, VERSION, RECORD.size, interval))
+    if args.csv:
+        print('interval_ns,' + ','.join(FIELDS))
+    for index, (name, f) in enumerate(zip(args.inputs, files)):
+        for data in read_blocks(f, name):
+            if args.renumber:
+                data = renumber(data, index)
+            if out is not None:
+                out.write(data)
+            if args.csv:
+                for offset in range(0, len(data), RECORD.size):
+                    values = RECORD.unpack_from(data, offset)
+                    print('%d,%s' % (interval, ','.join(str(v) for v in values)))
+        f.close()
+    if out is not None:
+        out.close()
+
+
+if __name__ == '__main__':
+    main(sys.argv)
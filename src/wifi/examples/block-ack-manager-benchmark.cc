@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of the originator side of block ack
+// exchanges in BlockAckManager.
+//
+// One agreement is established with each recipient.  In each round, the
+// MPDUs waiting for retransmission are extracted and then, for each
+// recipient in turn, new MPDUs are stored to fill the window and a compressed
+// Block Ack acknowledging all of them but one out of every lossPeriod new
+// MPDUs is processed.  Retransmitted MPDUs are always acknowledged.  The
+// wall clock time per Block Ack is printed for each window size.
+//
+// The compressed Block Ack bitmap covers 64 MPDUs, which bounds the
+// window size.
+//
+// Sample usage:
+//   ./waf --run 'block-ack-manager-benchmark --recipients=16 --lossPeriod=4'
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/block-ack-manager.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/mac-tx-middle.h"
+#include "ns3/mgt-headers.h"
+#include "ns3/ctrl-headers.h"
+
+using namespace ns3;
+
+/**
+ * Block or unblock destination callback
+ * \param recipient the recipient
+ * \param tid the TID
+ */
+static void
+BlockDestination (Mac48Address recipient, uint8_t tid)
+{
+}
+
+/// State of an agreement
+struct Originator
+{
+  Mac48Address recipient;         ///< the recipient
+  uint16_t nextSeq;               ///< the next new sequence number
+  std::vector<uint16_t> retries;  ///< the sequence numbers to retransmit
+};
+
+/**
+ * Run the benchmark
+ * \param nRecipients the number of recipients
+ * \param window the number of MPDUs per Block Ack
+ * \param lossPeriod one out of every lossPeriod new MPDUs is lost
+ * \param rounds the number of rounds
+ * \returns the wall clock time (ms)
+ */
+static int64_t
+Run (uint32_t nRecipients, uint16_t window, uint32_t lossPeriod, uint32_t rounds)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> stationManager = CreateObject<ConstantRateWifiManager> ();
+  stationManager->SetupPhy (phy);
+
+  Ptr<BlockAckManager> manager = CreateObject<BlockAckManager> ();
+  manager->SetWifiRemoteStationManager (stationManager);
+  manager->SetQueue (CreateObject<WifiMacQueue> ());
+  manager->SetTxMiddle (Create<MacTxMiddle> ());
+  manager->SetMaxPacketDelay (Seconds (10));
+  manager->SetBlockAckThreshold (0);
+  manager->SetBlockAckType (COMPRESSED_BLOCK_ACK);
+  manager->SetBlockDestinationCallback (MakeCallback (&BlockDestination));
+  manager->SetUnblockDestinationCallback (MakeCallback (&BlockDestination));
+
+  std::vector<Originator> originators (nRecipients);
+  for (uint32_t i = 0; i < nRecipients; i++)
+    {
+      originators[i].recipient = Mac48Address::Allocate ();
+      originators[i].nextSeq = 0;
+      MgtAddBaRequestHeader reqHdr;
+      reqHdr.SetImmediateBlockAck ();
+      reqHdr.SetTid (0);
+      reqHdr.SetTimeout (0);
+      reqHdr.SetBufferSize (window - 1);
+      reqHdr.SetStartingSequence (0);
+      reqHdr.SetAmsduSupport (false);
+      manager->CreateAgreement (&reqHdr, originators[i].recipient);
+      MgtAddBaResponseHeader respHdr;
+      respHdr.SetImmediateBlockAck ();
+      respHdr.SetTid (0);
+      respHdr.SetTimeout (0);
+      respHdr.SetBufferSize (window - 1);
+      respHdr.SetStatusCode (StatusCode ());
+      respHdr.SetAmsduSupport (false);
+      manager->UpdateAgreement (&respHdr, originators[i].recipient);
+    }
+
+  Ptr<Packet> packet = Create<Packet> (1000);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t round = 0; round < rounds; round++)
+    {
+      // retransmitted MPDUs, which stay buffered until acknowledged
+      WifiMacHeader retryHdr;
+      while (manager->GetNextPacket (retryHdr, true) != 0)
+        {
+        }
+      for (std::vector<Originator>::iterator o = originators.begin (); o != originators.end (); o++)
+        {
+          uint16_t startingSeq = o->retries.empty () ? o->nextSeq : o->retries.front ();
+
+          // new MPDUs, without leaving the window of the oldest buffered MPDU
+          uint16_t nNew = std::min<uint16_t> (window - o->retries.size (),
+                                              (startingSeq + window - o->nextSeq + 4096) % 4096);
+          CtrlBAckResponseHeader blockAck;
+          blockAck.SetType (COMPRESSED_BLOCK_ACK);
+          blockAck.SetTidInfo (0);
+          blockAck.SetStartingSequence (startingSeq);
+          for (std::vector<uint16_t>::const_iterator seq = o->retries.begin (); seq != o->retries.end (); seq++)
+            {
+              blockAck.SetReceivedPacket (*seq);
+            }
+          o->retries.clear ();
+          hdr.SetAddr1 (o->recipient);
+          for (uint16_t i = 0; i < nNew; i++)
+            {
+              hdr.SetSequenceNumber (o->nextSeq);
+              manager->StorePacket (packet, hdr, Simulator::Now ());
+              if (o->nextSeq % lossPeriod == 0)
+                {
+                  o->retries.push_back (o->nextSeq);
+                }
+              else
+                {
+                  blockAck.SetReceivedPacket (o->nextSeq);
+                }
+              o->nextSeq = (o->nextSeq + 1) % 4096;
+            }
+          manager->NotifyGotBlockAck (&blockAck, o->recipient, 30.0, WifiMode ("OfdmRate6Mbps"), 30.0);
+        }
+    }
+  int64_t ms = clock.End ();
+  manager->Dispose ();
+  stationManager->Dispose ();
+  phy->Dispose ();
+  return ms;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nRecipients = 8;
+  uint32_t lossPeriod = 8;
+  uint32_t rounds = 2000;
+
+  CommandLine cmd;
+  cmd.AddValue ("recipients", "Number of block ack agreements", nRecipients);
+  cmd.AddValue ("lossPeriod", "One out of every lossPeriod new MPDUs is lost", lossPeriod);
+  cmd.AddValue ("rounds", "Number of Block Acks per agreement", rounds);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (8) << "window"
+            << std::setw (12) << "time (ms)"
+            << std::setw (20) << "us per Block Ack"
+            << std::endl;
+  for (uint16_t window = 8; window <= 64; window *= 2)
+    {
+      int64_t ms = Run (nRecipients, window, lossPeriod, rounds);
+      std::cout << std::setw (8) << window
+                << std::setw (12) << ms
+                << std::setw (20) << std::setprecision (4) << ms * 1e3 / (rounds * nRecipients)
+                << std::endl;
+    }
+  return 0;
+}
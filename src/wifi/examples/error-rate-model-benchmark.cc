@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the throughput of ErrorRateModel::GetChunkSuccessRate
+// for the NIST and YANS error rate models, called directly and through a
+// TableErrorRateModel.
+//
+// For each model, the same random sequence of (mode, SNR) pairs is evaluated
+// by the analytic model and by the table; the number of calls per second
+// of both, the time spent computing the tables and the largest absolute
+// difference between the success rates are printed.
+//
+// Sample usage:
+//   ./waf --run 'error-rate-model-benchmark --calls=1000000 --resolution=0.05'
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include "ns3/command-line.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/table-error-rate-model.h"
+#include "ns3/wifi-tx-vector.h"
+
+using namespace ns3;
+
+/**
+ * Evaluate a model on a sequence of modes and SNR values
+ * \param model the error rate model
+ * \param txVectors the TXVECTOR of each call
+ * \param snrs the SNR of each call
+ * \param nbits the chunk size (bits)
+ * \param psr the success rates (output)
+ * \returns the wall clock time (ms)
+ */
+static int64_t
+Evaluate (Ptr<ErrorRateModel> model, const std::vector<WifiTxVector> &txVectors,
+          const std::vector<double> &snrs, uint64_t nbits, std::vector<double> &psr)
+{
+  psr.resize (snrs.size ());
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < snrs.size (); i++)
+    {
+      psr[i] = model->GetChunkSuccessRate (txVectors[i].GetMode (), txVectors[i], snrs[i], nbits);
+    }
+  return clock.End ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t calls = 1000000;
+  double minSnr = -5;
+  double maxSnr = 35;
+  double resolution = 0.05;
+  uint32_t frameSize = 1500;
+
+  CommandLine cmd;
+  cmd.AddValue ("calls", "Number of GetChunkSuccessRate calls per model", calls);
+  cmd.AddValue ("minSnr", "Lowest random SNR (dB)", minSnr);
+  cmd.AddValue ("maxSnr", "Highest random SNR (dB)", maxSnr);
+  cmd.AddValue ("resolution", "Resolution of the tables (dB)", resolution);
+  cmd.AddValue ("frameSize", "Chunk size (bytes)", frameSize);
+  cmd.Parse (argc, argv);
+
+  const char *modes[] = {"OfdmRate6Mbps", "OfdmRate12Mbps", "OfdmRate24Mbps", "OfdmRate36Mbps",
+                         "OfdmRate54Mbps", "HtMcs0", "HtMcs4", "HtMcs7", "VhtMcs8"};
+  uint32_t nModes = sizeof (modes) / sizeof (modes[0]);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  std::vector<WifiTxVector> txVectors (calls);
+  std::vector<double> snrs (calls);
+  for (uint32_t i = 0; i < calls; i++)
+    {
+      txVectors[i].SetMode (WifiMode (modes[random->GetInteger (0, nModes - 1)]));
+      txVectors[i].SetChannelWidth (txVectors[i].GetMode ().GetModulationClass () == WIFI_MOD_CLASS_VHT ? 80 : 20);
+      snrs[i] = std::pow (10.0, random->GetValue (minSnr, maxSnr) / 10.0);
+    }
+
+  Ptr<ErrorRateModel> models[2] = {CreateObject<NistErrorRateModel> (), CreateObject<YansErrorRateModel> ()};
+  const char *names[2] = {"NIST", "YANS"};
+
+  std::cout << std::setw (6) << "model"
+            << std::setw (16) << "analytic (c/s)"
+            << std::setw (16) << "table (c/s)"
+            << std::setw (10) << "speedup"
+            << std::setw (12) << "init (ms)"
+            << std::setw (14) << "max error"
+            << std::endl;
+  for (uint32_t m = 0; m < 2; m++)
+    {
+      Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+      table->SetAttribute ("ErrorRateModel", PointerValue (models[m]));
+      table->SetAttribute ("Resolution", DoubleValue (resolution));
+
+      std::vector<double> exact;
+      std::vector<double> interpolated;
+      int64_t analyticMs = Evaluate (models[m], txVectors, snrs, frameSize * 8, exact);
+      //the first pass computes the tables of the modes
+      int64_t initMs = Evaluate (table, txVectors, snrs, frameSize * 8, interpolated);
+      int64_t tableMs = Evaluate (table, txVectors, snrs, frameSize * 8, interpolated);
+      initMs = std::max<int64_t> (initMs - tableMs, 0);
+
+      double maxError = 0;
+      for (uint32_t i = 0; i < calls; i++)
+        {
+          maxError = std::max (maxError, std::abs (exact[i] - interpolated[i]));
+        }
+      std::cout << std::setw (6) << names[m]
+                << std::setw (16) << static_cast<uint64_t> (calls * 1000.0 / std::max<int64_t> (analyticMs, 1))
+                << std::setw (16) << static_cast<uint64_t> (calls * 1000.0 / std::max<int64_t> (tableMs, 1))
+                << std::setw (10) << std::setprecision (3)
+                << static_cast<double> (analyticMs) / std::max<int64_t> (tableMs, 1)
+                << std::setw (12) << initMs
+                << std::setw (14) << maxError
+                << std::endl;
+    }
+  return 0;
+}
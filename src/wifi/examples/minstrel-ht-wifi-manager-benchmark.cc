@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the CPU time MinstrelHtWifiManager spends per
+// transmitted frame, as a function of the number of associated stations.
+//
+// A single 802.11n or 802.11ac MAC and PHY are created, without a channel,
+// and the HT (and VHT) capabilities of the MAC are registered for every
+// station.  A-MPDUs are then "sent" round-robin to the stations, one every
+// interval of simulated time, so that the periodic statistics updates run
+// as they would in a real simulation.  For each A-MPDU, the data TXVECTOR
+// is requested and the transmission status is reported; the success ratio
+// of an A-MPDU decreases with the MCS, so that rate sampling and the EWMA
+// statistics stay busy.  The wall clock time per frame is printed.
+//
+// Sample usage:
+//   ./waf --run 'minstrel-ht-wifi-manager-benchmark --standard=ac --maxStas=64'
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/adhoc-wifi-mac.h"
+#include "ns3/ht-capabilities.h"
+#include "ns3/vht-capabilities.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/minstrel-ht-wifi-manager.h"
+
+using namespace ns3;
+
+/// Minstrel-HT benchmark
+class MinstrelHtBenchmark
+{
+public:
+  /**
+   * Run the benchmark
+   * \param vht whether to use 802.11ac rather than 802.11n
+   * \param nStas the number of stations
+   * \param frames the number of A-MPDUs
+   * \param interval the time between two A-MPDUs
+   * \returns the wall clock time (ms)
+   */
+  int64_t Run (bool vht, uint32_t nStas, uint32_t frames, Time interval);
+
+private:
+  /**
+   * Transmit an A-MPDU to the next station and schedule the next one
+   * \param remaining the number of A-MPDUs left to send
+   */
+  void Send (uint32_t remaining);
+
+  Ptr<WifiRemoteStationManager> m_manager; ///< the station manager
+  std::vector<Mac48Address> m_stas;        ///< the stations
+  Ptr<Packet> m_packet;                    ///< the MPDU payload
+  WifiMacHeader m_header;                  ///< the MPDU header
+  Time m_interval;                         ///< the time between two A-MPDUs
+  uint32_t m_next;                         ///< the index of the next station
+};
+
+void
+MinstrelHtBenchmark::Send (uint32_t remaining)
+{
+  Mac48Address address = m_stas[m_next];
+  m_next = (m_next + 1) % m_stas.size ();
+  m_header.SetAddr1 (address);
+  WifiTxVector txVector = m_manager->GetDataTxVector (address, &m_header, m_packet);
+  // Up to MCS 4 of a stream, all 16 MPDUs succeed; each MCS above loses 3.
+  uint8_t mcs = txVector.GetMode ().GetMcsValue () % 8;
+  uint8_t nFailed = mcs > 4 ? (mcs - 4) * 3 : 0;
+  m_manager->ReportAmpduTxStatus (address, 0, 16 - nFailed, nFailed, 30.0, 30.0);
+  if (--remaining > 0)
+    {
+      Simulator::Schedule (m_interval, &MinstrelHtBenchmark::Send, this, remaining);
+    }
+}
+
+int64_t
+MinstrelHtBenchmark::Run (bool vht, uint32_t nStas, uint32_t frames, Time interval)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (vht ? WIFI_PHY_STANDARD_80211ac : WIFI_PHY_STANDARD_80211n_5GHZ);
+  Ptr<AdhocWifiMac> mac = CreateObject<AdhocWifiMac> ();
+  mac->SetAttribute ("HtSupported", BooleanValue (true));
+  mac->SetAttribute ("VhtSupported", BooleanValue (vht));
+  m_manager = CreateObject<MinstrelHtWifiManager> ();
+  mac->SetWifiRemoteStationManager (m_manager);
+  mac->SetWifiPhy (phy);
+  mac->ConfigureStandard (vht ? WIFI_PHY_STANDARD_80211ac : WIFI_PHY_STANDARD_80211n_5GHZ);
+  m_manager->SetupPhy (phy);
+  m_manager->SetupMac (mac);
+  m_manager->Initialize ();
+
+  m_stas.resize (nStas);
+  for (uint32_t i = 0; i < nStas; i++)
+    {
+      m_stas[i] = Mac48Address::Allocate ();
+      m_manager->AddAllSupportedModes (m_stas[i]);
+      m_manager->AddStationHtCapabilities (m_stas[i], mac->GetHtCapabilities ());
+      if (vht)
+        {
+          m_manager->AddStationVhtCapabilities (m_stas[i], mac->GetVhtCapabilities ());
+        }
+    }
+  m_packet = Create<Packet> (1000);
+  m_header.SetType (WIFI_MAC_QOSDATA);
+  m_header.SetQosTid (0);
+  m_interval = interval;
+  m_next = 0;
+
+  Simulator::ScheduleNow (&MinstrelHtBenchmark::Send, this, frames);
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+  Simulator::Destroy ();
+  m_manager = 0;
+  m_stas.clear ();
+  return ms;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string standard = "n";
+  uint32_t minStas = 1;
+  uint32_t maxStas = 64;
+  uint32_t frames = 200000;
+  double interval = 100;
+
+  CommandLine cmd;
+  cmd.AddValue ("standard", "802.11 standard (n or ac)", standard);
+  cmd.AddValue ("minStas", "Smallest number of stations", minStas);
+  cmd.AddValue ("maxStas", "Largest number of stations (doubled from minStas)", maxStas);
+  cmd.AddValue ("frames", "Number of A-MPDUs per run", frames);
+  cmd.AddValue ("interval", "Time between two A-MPDUs (us)", interval);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (8) << "stas"
+            << std::setw (12) << "time (ms)"
+            << std::setw (16) << "ns per frame"
+            << std::endl;
+  for (uint32_t n = minStas; n <= maxStas; n *= 2)
+    {
+      MinstrelHtBenchmark benchmark;
+      int64_t ms = benchmark.Run (standard == "ac", n, frames, MicroSeconds (interval));
+      std::cout << std::setw (8) << n
+                << std::setw (12) << ms
+                << std::setw (16) << std::setprecision (4) << ms * 1e6 / frames
+                << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,291 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of the spectrum representation of Wi-Fi
+// signals.
+//
+// First, the transmit power spectral densities of every modulation family
+// and channel width, and the matching RF filters, are created repeatedly
+// through WifiSpectrumValueHelper, and the time per call is printed.
+//
+// Then, as in the wifi-spectrum examples, SpectrumWifiPhys placed on a
+// square grid share a MultiModelSpectrumChannel, and each one periodically
+// broadcasts a packet.  The wall clock time per transmission and per
+// received signal (which includes the RF filtering of the receiver) is
+// printed for each network size.
+//
+// Sample usage:
+//   ./waf --run 'spectrum-wifi-phy-benchmark --standard=ac --width=80 --maxNodes=64'
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "ns3/command-line.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/spectrum-wifi-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/spectrum-wifi-phy.h"
+#include "ns3/wifi-spectrum-value-helper.h"
+
+using namespace ns3;
+
+/**
+ * Time the creation of transmit power spectral densities and RF filters
+ * \param calls the number of calls per configuration
+ */
+static void
+RunPsdBenchmark (uint32_t calls)
+{
+  std::cout << std::setw (8) << "psd"
+            << std::setw (8) << "width"
+            << std::setw (16) << "ns per call"
+            << std::endl;
+  const char *names[] = {"ofdm", "ht", "he", "filter"};
+  uint16_t widths[] = {20, 40, 80, 160};
+  for (uint32_t kind = 0; kind < 4; kind++)
+    {
+      for (uint32_t w = 0; w < 4; w++)
+        {
+          uint16_t width = widths[w];
+          if (kind == 0 && width > 20)
+            {
+              continue;
+            }
+          uint32_t frequency = 5180 + 10 * (width / 20 - 1);
+          SystemWallClockMs clock;
+          clock.Start ();
+          for (uint32_t i = 0; i < calls; i++)
+            {
+              double txPowerW = 0.01 * (1 + i % 4);
+              switch (kind)
+                {
+                case 0:
+                  WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (frequency, width, txPowerW, width);
+                  break;
+                case 1:
+                  WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (frequency, width, txPowerW, width);
+                  break;
+                case 2:
+                  WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (frequency, width, txPowerW, width);
+                  break;
+                default:
+                  WifiSpectrumValueHelper::GetRfFilter (frequency, width, 312500, width);
+                  break;
+                }
+            }
+          int64_t ms = clock.End ();
+          std::cout << std::setw (8) << names[kind]
+                    << std::setw (8) << width
+                    << std::setw (16) << std::setprecision (4) << ms * 1e6 / calls
+                    << std::endl;
+        }
+    }
+}
+
+/// Network experiment
+class SpectrumWifiExperiment
+{
+public:
+  /// Output structure
+  struct Output
+  {
+    int64_t wallMs;     ///< wall clock time (ms)
+    uint64_t sent;      ///< packets sent
+    uint64_t received;  ///< packets received successfully
+  };
+
+  /**
+   * Run the experiment
+   * \param standard the Wi-Fi standard
+   * \param width the channel width (MHz)
+   * \param nNodes the number of PHYs
+   * \param duration the simulated time
+   * \returns the experiment output
+   */
+  Output Run (WifiPhyStandard standard, uint16_t width, uint32_t nNodes, Time duration);
+
+private:
+  /**
+   * Send a packet and schedule the next one
+   * \param phy the sending PHY
+   */
+  void Send (Ptr<WifiPhy> phy);
+  /**
+   * Receive callback
+   * \param p the packet
+   * \param snr the SNR
+   * \param txVector the wifi transmit vector
+   */
+  void Receive (Ptr<Packet> p, double snr, WifiTxVector txVector);
+
+  WifiTxVector m_txVector; ///< the TXVECTOR of every packet
+  Time m_interval;         ///< interval between two packets of a PHY
+  Output m_output;         ///< output
+};
+
+void
+SpectrumWifiExperiment::Send (Ptr<WifiPhy> phy)
+{
+  if (!phy->IsStateTx ())
+    {
+      phy->SendPacket (Create<Packet> (1000), m_txVector);
+      m_output.sent++;
+    }
+  Simulator::Schedule (m_interval, &SpectrumWifiExperiment::Send, this, phy);
+}
+
+void
+SpectrumWifiExperiment::Receive (Ptr<Packet> p, double snr, WifiTxVector txVector)
+{
+  m_output.received++;
+}
+
+SpectrumWifiExperiment::Output
+SpectrumWifiExperiment::Run (WifiPhyStandard standard, uint16_t width, uint32_t nNodes, Time duration)
+{
+  m_output.sent = 0;
+  m_output.received = 0;
+  m_interval = MilliSeconds (10);
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  SpectrumWifiPhyHelper phy = SpectrumWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+  phy.Set ("ChannelWidth", UintegerValue (width));
+  WifiHelper wifi;
+  wifi.SetStandard (standard);
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+
+  MobilityHelper mobility;
+  uint32_t side = static_cast<uint32_t> (std::ceil (std::sqrt (nNodes)));
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (10.0),
+                                 "DeltaY", DoubleValue (10.0),
+                                 "GridWidth", UintegerValue (side));
+  mobility.Install (nodes);
+
+  switch (standard)
+    {
+    case WIFI_PHY_STANDARD_80211a:
+      m_txVector.SetMode (WifiMode ("OfdmRate6Mbps"));
+      m_txVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+      break;
+    case WIFI_PHY_STANDARD_80211n_5GHZ:
+      m_txVector.SetMode (WifiMode ("HtMcs0"));
+      m_txVector.SetPreambleType (WIFI_PREAMBLE_HT_MF);
+      break;
+    case WIFI_PHY_STANDARD_80211ac:
+      m_txVector.SetMode (WifiMode ("VhtMcs0"));
+      m_txVector.SetPreambleType (WIFI_PREAMBLE_VHT);
+      break;
+    default:
+      m_txVector.SetMode (WifiMode ("HeMcs0"));
+      m_txVector.SetPreambleType (WIFI_PREAMBLE_HE_SU);
+      m_txVector.SetGuardInterval (800);
+      break;
+    }
+  m_txVector.SetChannelWidth (width);
+  m_txVector.SetNss (1);
+  m_txVector.SetTxPowerLevel (0);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<WifiPhy> wifiPhy = DynamicCast<WifiNetDevice> (devices.Get (i))->GetPhy ();
+      wifiPhy->SetReceiveOkCallback (MakeCallback (&SpectrumWifiExperiment::Receive, this));
+      // spread the first transmissions over one interval
+      Time start = MicroSeconds ((m_interval.GetMicroSeconds () * i) / nNodes);
+      Simulator::Schedule (start, &SpectrumWifiExperiment::Send, this, wifiPhy);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (duration);
+  Simulator::Run ();
+  m_output.wallMs = clock.End ();
+  Simulator::Destroy ();
+  return m_output;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string standard = "ac";
+  uint16_t width = 20;
+  uint32_t minNodes = 4;
+  uint32_t maxNodes = 32;
+  double duration = 1;
+  uint32_t calls = 100000;
+
+  CommandLine cmd;
+  cmd.AddValue ("standard", "802.11 standard (a, n, ac or ax)", standard);
+  cmd.AddValue ("width", "Channel width (MHz)", width);
+  cmd.AddValue ("minNodes", "Smallest number of PHYs", minNodes);
+  cmd.AddValue ("maxNodes", "Largest number of PHYs (doubled from minNodes)", maxNodes);
+  cmd.AddValue ("duration", "Simulated time (s)", duration);
+  cmd.AddValue ("calls", "Number of calls per PSD configuration", calls);
+  cmd.Parse (argc, argv);
+
+  WifiPhyStandard phyStandard = WIFI_PHY_STANDARD_80211ac;
+  if (standard == "a")
+    {
+      phyStandard = WIFI_PHY_STANDARD_80211a;
+    }
+  else if (standard == "n")
+    {
+      phyStandard = WIFI_PHY_STANDARD_80211n_5GHZ;
+    }
+  else if (standard == "ax")
+    {
+      phyStandard = WIFI_PHY_STANDARD_80211ax_5GHZ;
+    }
+
+  RunPsdBenchmark (calls);
+
+  std::cout << std::endl
+            << std::setw (8) << "nodes"
+            << std::setw (10) << "sent"
+            << std::setw (12) << "received"
+            << std::setw (12) << "time (ms)"
+            << std::setw (14) << "us per tx"
+            << std::setw (14) << "us per rx"
+            << std::endl;
+  for (uint32_t n = minNodes; n <= maxNodes; n *= 2)
+    {
+      SpectrumWifiExperiment experiment;
+      SpectrumWifiExperiment::Output output = experiment.Run (phyStandard, width, n, Seconds (duration));
+      std::cout << std::setw (8) << n
+                << std::setw (10) << output.sent
+                << std::setw (12) << output.received
+                << std::setw (12) << output.wallMs
+                << std::setw (14) << std::setprecision (4) << output.wallMs * 1e3 / std::max<uint64_t> (output.sent, 1)
+                << std::setw (14) << std::setprecision (4) << output.wallMs * 1e3 / std::max<uint64_t> (output.sent * (n - 1), 1)
+                << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of building large Wi-Fi topologies.
+//
+// For each network size, the construction is split in phases whose wall
+// clock times are printed: the creation of the nodes, the installation of
+// their mobility models, the installation of the Wi-Fi devices by
+// WifiHelper::Install (one access point and stations, or ad hoc devices),
+// the connection of the ASCII trace sinks (optional), the initialization of
+// all the objects when the simulation starts, and the destruction of the
+// simulation.  No packet is sent.
+//
+// Sample usage:
+//   ./waf --run 'wifi-install-benchmark --mac=infra --minNodes=1000 --maxNodes=8000'
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "ns3/command-line.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/ssid.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/yans-wifi-helper.h"
+
+using namespace ns3;
+
+/// Number of phases
+static const uint32_t N_PHASES = 6;
+
+/// Phase names
+static const char *g_phaseNames[N_PHASES] = {"nodes", "mobility", "install", "ascii", "start", "destroy"};
+
+/**
+ * Build a topology and time each phase of its construction
+ * \param standard the Wi-Fi standard
+ * \param infra whether to install one access point and stations rather than ad hoc devices
+ * \param ascii whether to connect the ASCII trace sinks
+ * \param nNodes the number of nodes
+ * \param times the wall clock time of each phase (ms)
+ */
+static void
+BuildTopology (WifiPhyStandard standard, bool infra, bool ascii, uint32_t nNodes, int64_t times[N_PHASES])
+{
+  SystemWallClockMs clock;
+
+  clock.Start ();
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  times[0] = clock.End ();
+
+  clock.Start ();
+  MobilityHelper mobility;
+  uint32_t side = static_cast<uint32_t> (std::ceil (std::sqrt (nNodes)));
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (5.0),
+                                 "DeltaY", DoubleValue (5.0),
+                                 "GridWidth", UintegerValue (side));
+  mobility.Install (nodes);
+  times[1] = clock.End ();
+
+  clock.Start ();
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi;
+  wifi.SetStandard (standard);
+  wifi.SetRemoteStationManager ("ns3::IdealWifiManager");
+  WifiMacHelper mac;
+  NetDeviceContainer devices;
+  if (infra)
+    {
+      Ssid ssid = Ssid ("benchmark");
+      mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid));
+      devices.Add (wifi.Install (phy, mac, nodes.Get (0)));
+      mac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid));
+      for (uint32_t i = 1; i < nNodes; i++)
+        {
+          devices.Add (wifi.Install (phy, mac, nodes.Get (i)));
+        }
+    }
+  else
+    {
+      mac.SetType ("ns3::AdhocWifiMac");
+      devices = wifi.Install (phy, mac, nodes);
+    }
+  times[2] = clock.End ();
+
+  clock.Start ();
+  if (ascii)
+    {
+      AsciiTraceHelper asciiTraceHelper;
+      phy.EnableAsciiAll (asciiTraceHelper.CreateFileStream ("wifi-install-benchmark.tr"));
+    }
+  times[3] = clock.End ();
+
+  clock.Start ();
+  Simulator::Stop (Seconds (0));
+  Simulator::Run ();
+  times[4] = clock.End ();
+
+  clock.Start ();
+  Simulator::Destroy ();
+  times[5] = clock.End ();
+}
+
+int main (int argc, char *argv[])
+{
+  std::string standard = "n";
+  std::string macType = "adhoc";
+  bool ascii = false;
+  uint32_t minNodes = 250;
+  uint32_t maxNodes = 4000;
+
+  CommandLine cmd;
+  cmd.AddValue ("standard", "802.11 standard (a, n or ac)", standard);
+  cmd.AddValue ("mac", "Type of MAC (adhoc or infra)", macType);
+  cmd.AddValue ("ascii", "Connect the ASCII trace sinks", ascii);
+  cmd.AddValue ("minNodes", "Smallest number of nodes", minNodes);
+  cmd.AddValue ("maxNodes", "Largest number of nodes (doubled from minNodes)", maxNodes);
+  cmd.Parse (argc, argv);
+
+  WifiPhyStandard phyStandard = WIFI_PHY_STANDARD_80211n_5GHZ;
+  if (standard == "a")
+    {
+      phyStandard = WIFI_PHY_STANDARD_80211a;
+    }
+  else if (standard == "ac")
+    {
+      phyStandard = WIFI_PHY_STANDARD_80211ac;
+    }
+
+  std::cout << std::setw (8) << "nodes";
+  for (uint32_t phase = 0; phase < N_PHASES; phase++)
+    {
+      std::cout << std::setw (10) << g_phaseNames[phase];
+    }
+  std::cout << std::setw (12) << "total (ms)"
+            << std::setw (16) << "us per device"
+            << std::endl;
+  for (uint32_t n = minNodes; n <= maxNodes; n *= 2)
+    {
+      int64_t times[N_PHASES];
+      BuildTopology (phyStandard, macType == "infra", ascii, n, times);
+      int64_t total = 0;
+      std::cout << std::setw (8) << n;
+      for (uint32_t phase = 0; phase < N_PHASES; phase++)
+        {
+          std::cout << std::setw (10) << times[phase];
+          total += times[phase];
+        }
+      std::cout << std::setw (12) << total
+                << std::setw (16) << std::setprecision (4) << times[2] * 1e3 / n
+                << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,470 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the simulation speed of canonical 802.11n networks,
+// so that performance regressions can be tracked across commits.
+//
+// Three scenarios are available:
+//  - bss: one access point and stations placed around it;
+//  - multiap: four access points on a square grid sharing the channel, each
+//    with its own SSID, and stations associated with the closest one;
+//  - adhoc: ad hoc stations on a square grid, each one sending to the next
+//    one (multi-hop meshes need an IP stack and a routing protocol, which
+//    are outside of the wifi module, so this is the single-hop variant).
+//
+// For each combination of scenario, number of stations, MCS and aggregation,
+// the stations are given one second to associate, then each one sends
+// fixed-size frames, directly through its WifiNetDevice, so that all of them
+// together offer the requested load.  Only the traffic period is measured.
+//
+// One CSV line is printed per combination, with the wall clock time, the
+// wall clock time per simulated second, the number of simulator events
+// scheduled (and their rate per wall clock second), the peak resident set
+// size, and the number of packets per simulated second transmitted and
+// received by the PHYs, transmitted and received by the MACs, and delivered
+// to the nodes.  Each combination is run in its own child process, so that
+// the peak resident set size is that of the combination alone.
+//
+// Sample usage:
+//   ./waf --run 'wifi-perf --scenarios=bss,multiap --staNums=2,8,32,64 --mcs=0,7 --output=wifi-perf.csv'
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "ns3/command-line.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/ssid.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/wifi-phy.h"
+
+using namespace ns3;
+
+/// Protocol number of the frames sent by the benchmark (local experimental ethertype)
+static const uint16_t PROTOCOL = 0x88b5;
+
+/// Event used to read the unique ID of the next scheduled event
+static void
+Noop (void)
+{
+}
+
+/**
+ * Split a comma-separated list
+ * \param list the list
+ * \return the items of the list
+ */
+static std::vector<std::string>
+SplitList (const std::string &list)
+{
+  std::vector<std::string> items;
+  std::istringstream iss (list);
+  std::string item;
+  while (std::getline (iss, item, ','))
+    {
+      if (!item.empty ())
+        {
+          items.push_back (item);
+        }
+    }
+  return items;
+}
+
+/**
+ * \param usage the resource usage of a process
+ * \return the peak resident set size of the process (kB)
+ */
+static long
+GetPeakRssKb (const struct rusage &usage)
+{
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+/// Network experiment
+class WifiPerfExperiment
+{
+public:
+  /// Input structure
+  struct Input
+  {
+    std::string scenario; ///< scenario (bss, multiap or adhoc)
+    uint32_t nStas;       ///< number of stations
+    uint8_t mcs;          ///< HT MCS of the data frames
+    bool aggregation;     ///< whether A-MPDU aggregation is enabled
+    uint32_t packetSize;  ///< size of the frames (bytes)
+    double load;          ///< total offered load (Mbit/s)
+    Time duration;        ///< simulated time of the traffic period
+  };
+
+  /// Output structure
+  struct Output
+  {
+    int64_t wallMs;   ///< wall clock time of the traffic period (ms)
+    uint64_t events;  ///< simulator events scheduled during the traffic period
+    uint64_t phyTx;   ///< packets transmitted by the PHYs
+    uint64_t phyRx;   ///< packets received by the PHYs
+    uint64_t macTx;   ///< packets transmitted by the MACs
+    uint64_t macRx;   ///< packets received by the MACs
+    uint64_t nodeRx;  ///< packets delivered to the nodes
+  };
+
+  WifiPerfExperiment ();
+  /**
+   * Run the experiment
+   * \param input the experiment input
+   * \returns the experiment output
+   */
+  Output Run (const Input &input);
+
+private:
+  /**
+   * Send a frame and schedule the next one
+   * \param device the sending device
+   * \param to the destination address
+   */
+  void Send (Ptr<NetDevice> device, Address to);
+  /**
+   * Receive callback of the nodes
+   * \param device the receiving device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the source address
+   * \param to the destination address
+   * \param type the packet type
+   */
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType type);
+  /**
+   * PHY transmit trace sink
+   * \param packet the packet
+   */
+  void PhyTx (Ptr<const Packet> packet);
+  /**
+   * PHY receive trace sink
+   * \param packet the packet
+   */
+  void PhyRx (Ptr<const Packet> packet);
+  /**
+   * MAC transmit trace sink
+   * \param packet the packet
+   */
+  void MacTx (Ptr<const Packet> packet);
+  /**
+   * MAC receive trace sink
+   * \param packet the packet
+   */
+  void MacRx (Ptr<const Packet> packet);
+
+  uint32_t m_packetSize; ///< size of the frames
+  Time m_interval;       ///< interval between two frames of a station
+  Output m_output;       ///< output
+};
+
+WifiPerfExperiment::WifiPerfExperiment ()
+  : m_packetSize (0),
+    m_interval (),
+    m_output ()
+{
+}
+
+void
+WifiPerfExperiment::Send (Ptr<NetDevice> device, Address to)
+{
+  device->Send (Create<Packet> (m_packetSize), to, PROTOCOL);
+  Simulator::Schedule (m_interval, &WifiPerfExperiment::Send, this, device, to);
+}
+
+void
+WifiPerfExperiment::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                             const Address &from, const Address &to, NetDevice::PacketType type)
+{
+  m_output.nodeRx++;
+}
+
+void
+WifiPerfExperiment::PhyTx (Ptr<const Packet> packet)
+{
+  m_output.phyTx++;
+}
+
+void
+WifiPerfExperiment::PhyRx (Ptr<const Packet> packet)
+{
+  m_output.phyRx++;
+}
+
+void
+WifiPerfExperiment::MacTx (Ptr<const Packet> packet)
+{
+  m_output.macTx++;
+}
+
+void
+WifiPerfExperiment::MacRx (Ptr<const Packet> packet)
+{
+  m_output.macRx++;
+}
+
+WifiPerfExperiment::Output
+WifiPerfExperiment::Run (const Input &input)
+{
+  m_packetSize = input.packetSize;
+  m_interval = Seconds (input.packetSize * 8.0 * input.nStas / (input.load * 1e6));
+
+  uint32_t nAps = 0;
+  if (input.scenario == "bss")
+    {
+      nAps = 1;
+    }
+  else if (input.scenario == "multiap")
+    {
+      nAps = 4;
+    }
+  NodeContainer aps;
+  aps.Create (nAps);
+  NodeContainer stas;
+  stas.Create (input.nStas);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  std::ostringstream oss;
+  oss << "HtMcs" << +input.mcs;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue (oss.str ()),
+                                "ControlMode", StringValue ("HtMcs0"));
+  UintegerValue maxAmpduSize (input.aggregation ? 65535 : 0);
+
+  // stations are placed on a disc of radius 10 m around their access point,
+  // or on a grid with a 10 m spacing in the ad hoc scenario
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  WifiMacHelper mac;
+  NetDeviceContainer apDevices;
+  NetDeviceContainer staDevices;
+  if (nAps == 0)
+    {
+      uint32_t side = static_cast<uint32_t> (std::ceil (std::sqrt (input.nStas)));
+      for (uint32_t i = 0; i < input.nStas; i++)
+        {
+          positions->Add (Vector (10.0 * (i % side), 10.0 * (i / side), 0.0));
+        }
+      mac.SetType ("ns3::AdhocWifiMac",
+                   "BE_MaxAmpduSize", maxAmpduSize);
+      staDevices = wifi.Install (phy, mac, stas);
+    }
+  else
+    {
+      for (uint32_t i = 0; i < nAps; i++)
+        {
+          positions->Add (Vector (30.0 * (i % 2), 30.0 * (i / 2), 0.0));
+        }
+      for (uint32_t i = 0; i < nAps; i++)
+        {
+          std::ostringstream ssid;
+          ssid << "wifi-perf-" << i;
+          mac.SetType ("ns3::ApWifiMac",
+                       "Ssid", SsidValue (Ssid (ssid.str ())),
+                       "BE_MaxAmpduSize", maxAmpduSize);
+          apDevices.Add (wifi.Install (phy, mac, aps.Get (i)));
+        }
+      for (uint32_t i = 0; i < input.nStas; i++)
+        {
+          uint32_t ap = i % nAps;
+          double angle = 2 * M_PI * i / input.nStas;
+          positions->Add (Vector (30.0 * (ap % 2) + 10.0 * std::cos (angle),
+                                  30.0 * (ap / 2) + 10.0 * std::sin (angle), 0.0));
+          std::ostringstream ssid;
+          ssid << "wifi-perf-" << ap;
+          mac.SetType ("ns3::StaWifiMac",
+                       "Ssid", SsidValue (Ssid (ssid.str ())),
+                       "BE_MaxAmpduSize", maxAmpduSize);
+          staDevices.Add (wifi.Install (phy, mac, stas.Get (i)));
+        }
+    }
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator (positions);
+  NodeContainer nodes (aps, stas);
+  mobility.Install (nodes);
+
+  NetDeviceContainer devices (apDevices, staDevices);
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (devices.Get (i));
+      device->GetNode ()->RegisterProtocolHandler (MakeCallback (&WifiPerfExperiment::Receive, this),
+                                                   PROTOCOL, device);
+      device->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&WifiPerfExperiment::PhyTx, this));
+      device->GetPhy ()->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&WifiPerfExperiment::PhyRx, this));
+      device->GetMac ()->TraceConnectWithoutContext ("MacTx", MakeCallback (&WifiPerfExperiment::MacTx, this));
+      device->GetMac ()->TraceConnectWithoutContext ("MacRx", MakeCallback (&WifiPerfExperiment::MacRx, this));
+    }
+
+  // leave one second for the association, then spread the first frames
+  // over one interval
+  Time warmup = Seconds (1);
+  for (uint32_t i = 0; i < input.nStas; i++)
+    {
+      Address to = (nAps == 0)
+        ? staDevices.Get ((i + 1) % input.nStas)->GetAddress ()
+        : apDevices.Get (i % nAps)->GetAddress ();
+      Time start = warmup + MicroSeconds ((m_interval.GetMicroSeconds () * i) / input.nStas);
+      Simulator::Schedule (start, &WifiPerfExperiment::Send, this, staDevices.Get (i), to);
+    }
+  Simulator::Stop (warmup);
+  Simulator::Run ();
+
+  m_output = Output ();
+  uint64_t firstUid = Simulator::ScheduleNow (&Noop).GetUid ();
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (input.duration);
+  Simulator::Run ();
+  m_output.wallMs = clock.End ();
+  m_output.events = Simulator::ScheduleNow (&Noop).GetUid () - firstUid;
+  Simulator::Destroy ();
+  return m_output;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string scenarios = "bss,multiap,adhoc";
+  std::string staNums = "2,8,32,64";
+  std::string mcsList = "0,7";
+  std::string aggregationList = "1,0";
+  uint32_t packetSize = 1000;
+  double load = 50;
+  double duration = 1;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.AddValue ("scenarios", "Comma-separated list of scenarios (bss, multiap, adhoc)", scenarios);
+  cmd.AddValue ("staNums", "Comma-separated list of numbers of stations", staNums);
+  cmd.AddValue ("mcs", "Comma-separated list of HT MCSs of the data frames", mcsList);
+  cmd.AddValue ("aggregation", "Comma-separated list of A-MPDU settings (1 enabled, 0 disabled)", aggregationList);
+  cmd.AddValue ("packetSize", "Size of the frames (bytes)", packetSize);
+  cmd.AddValue ("load", "Total offered load (Mbit/s)", load);
+  cmd.AddValue ("duration", "Simulated time of the traffic period (s)", duration);
+  cmd.AddValue ("output", "CSV file to append the results to, instead of the standard output", output);
+  cmd.Parse (argc, argv);
+  NS_ABORT_MSG_IF (load <= 0, "The offered load must be positive");
+
+  std::ofstream file;
+  bool writeHeader = true;
+  if (!output.empty ())
+    {
+      std::ifstream existing (output.c_str ());
+      writeHeader = !existing.good () || existing.peek () == std::ifstream::traits_type::eof ();
+      file.open (output.c_str (), std::ios_base::app);
+      NS_ABORT_MSG_IF (!file.is_open (), "Cannot open " << output);
+    }
+  std::ostream &os = file.is_open () ? file : std::cout;
+  if (writeHeader)
+    {
+      os << "scenario,stas,mcs,aggregation,sim_s,wall_ms,wall_ms_per_sim_s,events,events_per_wall_s,"
+         << "peak_rss_kb,phy_tx_pps,phy_rx_pps,mac_tx_pps,mac_rx_pps,node_rx_pps"
+         << std::endl;
+    }
+
+  std::vector<std::string> scenarioItems = SplitList (scenarios);
+  std::vector<std::string> staItems = SplitList (staNums);
+  std::vector<std::string> mcsItems = SplitList (mcsList);
+  std::vector<std::string> aggregationItems = SplitList (aggregationList);
+  for (uint32_t s = 0; s < scenarioItems.size (); s++)
+    {
+      for (uint32_t n = 0; n < staItems.size (); n++)
+        {
+          for (uint32_t m = 0; m < mcsItems.size (); m++)
+            {
+              for (uint32_t a = 0; a < aggregationItems.size (); a++)
+                {
+                  WifiPerfExperiment::Input input;
+                  input.scenario = scenarioItems[s];
+                  input.nStas = std::atoi (staItems[n].c_str ());
+                  input.mcs = static_cast<uint8_t> (std::atoi (mcsItems[m].c_str ()));
+                  input.aggregation = std::atoi (aggregationItems[a].c_str ()) != 0;
+                  input.packetSize = packetSize;
+                  input.load = load;
+                  input.duration = Seconds (duration);
+                  NS_ABORT_MSG_IF (input.scenario != "bss" && input.scenario != "multiap" && input.scenario != "adhoc",
+                                   "Unknown scenario " << input.scenario);
+                  NS_ABORT_MSG_IF (input.nStas < 2, "At least two stations are needed");
+
+                  // the child runs the experiment and sends its output back
+                  // through a pipe, the parent collects its resource usage
+                  int fds[2];
+                  NS_ABORT_MSG_IF (pipe (fds) != 0, "Cannot create a pipe");
+                  pid_t pid = fork ();
+                  NS_ABORT_MSG_IF (pid < 0, "Cannot fork");
+                  if (pid == 0)
+                    {
+                      close (fds[0]);
+                      WifiPerfExperiment experiment;
+                      WifiPerfExperiment::Output result = experiment.Run (input);
+                      bool written = write (fds[1], &result, sizeof (result)) == sizeof (result);
+                      _exit (written ? 0 : 1);
+                    }
+                  close (fds[1]);
+                  WifiPerfExperiment::Output result;
+                  bool received = read (fds[0], &result, sizeof (result)) == sizeof (result);
+                  close (fds[0]);
+                  int status;
+                  struct rusage usage;
+                  NS_ABORT_MSG_IF (wait4 (pid, &status, 0, &usage) != pid, "Cannot wait for the experiment");
+                  NS_ABORT_MSG_IF (!received || !WIFEXITED (status) || WEXITSTATUS (status) != 0,
+                                   "Experiment " << input.scenario << " with " << input.nStas << " stations failed");
+                  double wallS = std::max<int64_t> (result.wallMs, 1) / 1e3;
+                  os << input.scenario
+                     << "," << input.nStas
+                     << "," << +input.mcs
+                     << "," << input.aggregation
+                     << "," << duration
+                     << "," << result.wallMs
+                     << "," << result.wallMs / duration
+                     << "," << result.events
+                     << "," << result.events / wallS
+                     << "," << GetPeakRssKb (usage)
+                     << "," << result.phyTx / duration
+                     << "," << result.phyRx / duration
+                     << "," << result.macTx / duration
+                     << "," << result.macRx / duration
+                     << "," << result.nodeRx / duration
+                     << std::endl;
+                }
+            }
+        }
+    }
+  return 0;
+}
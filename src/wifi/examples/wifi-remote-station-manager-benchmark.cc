@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of the per-frame calls an access point
+// makes to its WifiRemoteStationManager, as a function of the number of
+// associated stations.
+//
+// For each number of stations, the frames are sent round-robin to the
+// stations; for each frame, the data TXVECTOR is requested, the need for
+// RTS is checked, and the transmission and the reception of a frame are
+// reported, which are four station lookups.  The wall clock time per
+// frame is printed; it should not grow with the number of stations.
+//
+// Sample usage:
+//   ./waf --run 'wifi-remote-station-manager-benchmark --manager=ns3::IdealWifiManager --maxStas=256'
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include "ns3/command-line.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-remote-station-manager.h"
+
+using namespace ns3;
+
+/**
+ * Time the per-frame calls to a station manager
+ * \param factory the station manager factory
+ * \param nStas the number of stations
+ * \param frames the number of frames
+ * \returns the wall clock time (ms)
+ */
+static int64_t
+Run (ObjectFactory &factory, uint32_t nStas, uint32_t frames)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = factory.Create<WifiRemoteStationManager> ();
+  manager->SetupPhy (phy);
+
+  std::vector<Mac48Address> stas (nStas);
+  for (uint32_t i = 0; i < nStas; i++)
+    {
+      stas[i] = Mac48Address::Allocate ();
+    }
+  Ptr<Packet> packet = Create<Packet> (1000);
+  WifiMacHeader header;
+  header.SetType (WIFI_MAC_QOSDATA);
+  header.SetQosTid (0);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < frames; i++)
+    {
+      Mac48Address address = stas[i % nStas];
+      header.SetAddr1 (address);
+      WifiTxVector txVector = manager->GetDataTxVector (address, &header, packet);
+      manager->NeedRts (address, &header, packet, txVector);
+      manager->ReportDataOk (address, &header, 100.0, txVector.GetMode (), 100.0, packet->GetSize ());
+      manager->ReportRxOk (address, &header, 100.0, txVector.GetMode ());
+    }
+  return clock.End ();
+}
+
+int main (int argc, char *argv[])
+{
+  std::string manager = "ns3::ConstantRateWifiManager";
+  uint32_t minStas = 2;
+  uint32_t maxStas = 256;
+  uint32_t frames = 1000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("manager", "Type of the WifiRemoteStationManager", manager);
+  cmd.AddValue ("minStas", "Smallest number of stations", minStas);
+  cmd.AddValue ("maxStas", "Largest number of stations (doubled from minStas)", maxStas);
+  cmd.AddValue ("frames", "Number of frames per run", frames);
+  cmd.Parse (argc, argv);
+
+  ObjectFactory factory;
+  factory.SetTypeId (manager);
+
+  std::cout << std::setw (8) << "stas"
+            << std::setw (12) << "time (ms)"
+            << std::setw (16) << "ns per frame"
+            << std::endl;
+  for (uint32_t n = minStas; n <= maxStas; n *= 2)
+    {
+      int64_t ms = Run (factory, n, frames);
+      std::cout << std::setw (8) << n
+                << std::setw (12) << ms
+                << std::setw (16) << std::setprecision (4) << ms * 1e6 / frames
+                << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures how the cost of YansWifiChannel::Send scales with
+// the number of PHYs on a channel, with and without the spatial index and
+// receive power culling.
+//
+// PHYs are placed on a square grid and each one periodically broadcasts a
+// packet.  For each network size, the simulation is run once with the
+// default channel (every transmission delivered to every PHY) and once with
+// the given SpatialIndexRange and RxSensitivityCull; the wall clock time
+// and the number of packets successfully received are printed for both.
+// If the range and threshold are chosen beyond anything a receiver can
+// detect, the received counts are identical.
+//
+// Sample usage:
+//   ./waf --run 'yans-wifi-channel-scaling --maxNodes=800 --range=500 --cull=-110'
+
+#include <cmath>
+#include <limits>
+#include <iostream>
+#include <iomanip>
+#include "ns3/packet.h"
+#include "ns3/command-line.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/yans-error-rate-model.h"
+
+using namespace ns3;
+
+/// Scaling experiment
+class ChannelScalingExperiment
+{
+public:
+  /// Input structure
+  struct Input
+  {
+    Input ();
+    uint32_t nNodes;     ///< number of PHYs
+    double spacing;      ///< grid spacing (m)
+    double range;        ///< SpatialIndexRange (m)
+    double cull;         ///< RxSensitivityCull (dBm)
+    Time interval;       ///< interval between two packets of a PHY
+    Time duration;       ///< simulated time
+    uint32_t packetSize; ///< packet size (bytes)
+  };
+  /// Output structure
+  struct Output
+  {
+    uint64_t wallMs;    ///< wall clock time (ms)
+    uint64_t sent;      ///< packets sent
+    uint64_t received;  ///< packets received successfully
+  };
+
+  /**
+   * Run the experiment
+   * \param input the experiment parameters
+   * \returns the experiment output
+   */
+  Output Run (const Input &input);
+
+private:
+  /**
+   * Send a packet and schedule the next one
+   * \param phy the sending PHY
+   */
+  void Send (Ptr<YansWifiPhy> phy);
+  /**
+   * Receive callback
+   * \param p the packet
+   * \param snr the SNR
+   * \param txVector the wifi transmit vector
+   */
+  void Receive (Ptr<Packet> p, double snr, WifiTxVector txVector);
+
+  Input m_input;   ///< input
+  Output m_output; ///< output
+};
+
+ChannelScalingExperiment::Input::Input ()
+  : nNodes (100),
+    spacing (50),
+    range (0),
+    cull (-std::numeric_limits<double>::max ()),
+    interval (MilliSeconds (100)),
+    duration (Seconds (2)),
+    packetSize (500)
+{
+}
+
+void
+ChannelScalingExperiment::Send (Ptr<YansWifiPhy> phy)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (WifiMode ("OfdmRate6Mbps"));
+  txVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+  if (!phy->IsStateTx ())
+    {
+      phy->SendPacket (Create<Packet> (m_input.packetSize), txVector);
+      m_output.sent++;
+    }
+  Simulator::Schedule (m_input.interval, &ChannelScalingExperiment::Send, this, phy);
+}
+
+void
+ChannelScalingExperiment::Receive (Ptr<Packet> p, double snr, WifiTxVector txVector)
+{
+  m_output.received++;
+}
+
+ChannelScalingExperiment::Output
+ChannelScalingExperiment::Run (const Input &input)
+{
+  m_input = input;
+  m_output.sent = 0;
+  m_output.received = 0;
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetAttribute ("SpatialIndexRange", DoubleValue (input.range));
+  channel->SetAttribute ("RxSensitivityCull", DoubleValue (input.cull));
+
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  uint32_t side = static_cast<uint32_t> (std::ceil (std::sqrt (input.nNodes)));
+  for (uint32_t i = 0; i < input.nNodes; i++)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector ((i % side) * input.spacing, (i / side) * input.spacing, 0.0));
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (error);
+      phy->SetChannel (channel);
+      phy->SetMobility (mobility);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      phy->SetReceiveOkCallback (MakeCallback (&ChannelScalingExperiment::Receive, this));
+      // spread the first transmissions over one interval
+      Time start = MicroSeconds ((input.interval.GetMicroSeconds () * i) / input.nNodes);
+      Simulator::Schedule (start, &ChannelScalingExperiment::Send, this, phy);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (input.duration);
+  Simulator::Run ();
+  m_output.wallMs = clock.End ();
+  Simulator::Destroy ();
+  return m_output;
+}
+
+int main (int argc, char *argv[])
+{
+  ChannelScalingExperiment::Input input;
+  uint32_t minNodes = 25;
+  uint32_t maxNodes = 400;
+  double range = 500;
+  double cull = -110;
+  double duration = input.duration.GetSeconds ();
+
+  CommandLine cmd;
+  cmd.AddValue ("minNodes", "Smallest number of PHYs", minNodes);
+  cmd.AddValue ("maxNodes", "Largest number of PHYs (doubled from minNodes)", maxNodes);
+  cmd.AddValue ("spacing", "Grid spacing (m)", input.spacing);
+  cmd.AddValue ("range", "SpatialIndexRange of the optimized run (m)", range);
+  cmd.AddValue ("cull", "RxSensitivityCull of the optimized run (dBm)", cull);
+  cmd.AddValue ("duration", "Simulated time (s)", duration);
+  cmd.AddValue ("packetSize", "Packet size (bytes)", input.packetSize);
+  cmd.Parse (argc, argv);
+  input.duration = Seconds (duration);
+
+  std::cout << std::setw (8) << "nodes"
+            << std::setw (10) << "sent"
+            << std::setw (14) << "base (ms)"
+            << std::setw (14) << "base rx"
+            << std::setw (14) << "index (ms)"
+            << std::setw (14) << "index rx"
+            << std::setw (10) << "speedup"
+            << std::endl;
+  for (uint32_t n = minNodes; n <= maxNodes; n *= 2)
+    {
+      ChannelScalingExperiment experiment;
+      input.nNodes = n;
+      input.range = 0;
+      input.cull = -std::numeric_limits<double>::max ();
+      ChannelScalingExperiment::Output base = experiment.Run (input);
+      input.range = range;
+      input.cull = cull;
+      ChannelScalingExperiment::Output indexed = experiment.Run (input);
+      std::cout << std::setw (8) << n
+                << std::setw (10) << base.sent
+                << std::setw (14) << base.wallMs
+                << std::setw (14) << base.received
+                << std::setw (14) << indexed.wallMs
+                << std::setw (14) << indexed.received
+                << std::setw (10) << std::setprecision (3)
+                << static_cast<double> (base.wallMs) / std::max<uint64_t> (indexed.wallMs, 1)
+                << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include "ns3/names.h"
+#include "ns3/error-rate-model.h"
+#include "ns3/abstract-wifi-phy.h"
+#include "abstract-wifi-helper.h"
+
+namespace ns3 {
+
+AbstractWifiPhyHelper::AbstractWifiPhyHelper ()
+  : m_channel (0)
+{
+  m_phy.SetTypeId ("ns3::AbstractWifiPhy");
+}
+
+AbstractWifiPhyHelper
+AbstractWifiPhyHelper::Default (void)
+{
+  AbstractWifiPhyHelper helper;
+  helper.SetErrorRateModel ("ns3::NistErrorRateModel");
+  return helper;
+}
+
+void
+AbstractWifiPhyHelper::SetChannel (Ptr<AbstractWifiChannel> channel)
+{
+  m_channel = channel;
+}
+
+void
+AbstractWifiPhyHelper::SetChannel (std::string channelName)
+{
+  Ptr<AbstractWifiChannel> channel = Names::Find<AbstractWifiChannel> (channelName);
+  m_channel = channel;
+}
+
+Ptr<WifiPhy>
+AbstractWifiPhyHelper::Create (Ptr<Node> node, Ptr<NetDevice> device) const
+{
+  Ptr<AbstractWifiPhy> phy = m_phy.Create<AbstractWifiPhy> ();
+  //
+  // The PHYs share one table of the error rate model, which is only
+  // rebuilt if the error rate model was reconfigured since the last PHY.
+  //
+  std::ostringstream config;
+  config << m_errorRateModel;
+  if (m_errorRateTable == 0 || config.str () != m_errorRateTableConfig)
+    {
+      m_errorRateTable = CreateObject<TableErrorRateModel> ();
+      m_errorRateTable->SetErrorRateModel (m_errorRateModel.Create<ErrorRateModel> ());
+      m_errorRateTableConfig = config.str ();
+    }
+  phy->SetErrorRateModel (m_errorRateTable);
+  phy->SetChannel (m_channel);
+  phy->SetDevice (device);
+  return phy;
+}
+
+} //namespace ns3
@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ABSTRACT_WIFI_HELPER_H
+#define ABSTRACT_WIFI_HELPER_H
+
+#include "wifi-helper.h"
+#include "ns3/abstract-wifi-channel.h"
+#include "ns3/table-error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \brief Make it easy to create and manage PHY objects for the abstract
+ * PHY model.
+ *
+ * The channel, an ns3::AbstractWifiChannel, is created by the user and
+ * configured through its PropagationLossModel and PropagationDelayModel
+ * attributes.
+ *
+ * All the PHYs created by a helper (and its copies) with the same error
+ * rate model configuration share a single ns3::TableErrorRateModel wrapping
+ * that model, so the effective SINR to PER tables are computed once per
+ * mode for the whole network rather than once per PHY.
+ *
+ * The Pcap and ascii traces generated by the EnableAscii and EnablePcap methods defined
+ * in this class correspond to PHY-level traces and come to us via WifiPhyHelper
+ */
+class AbstractWifiPhyHelper : public WifiPhyHelper
+{
+public:
+  /**
+   * Create a phy helper without any parameter set. The user must set
+   * them all to be able to call Install later.
+   */
+  AbstractWifiPhyHelper ();
+
+  /**
+   * Create a phy helper in a default working state.
+   * \returns a default AbstractWifiPhyHelper
+   */
+  static AbstractWifiPhyHelper Default (void);
+
+  /**
+   * \param channel the channel to associate to this helper
+   *
+   * Every PHY created by a call to Install is associated to this channel.
+   */
+  void SetChannel (Ptr<AbstractWifiChannel> channel);
+  /**
+   * \param channelName The name of the channel to associate to this helper
+   *
+   * Every PHY created by a call to Install is associated to this channel.
+   */
+  void SetChannel (std::string channelName);
+
+private:
+  /**
+   * \param node the node on which we wish to create a wifi PHY
+   * \param device the device within which this PHY will be created
+   * \returns a newly-created PHY object.
+   *
+   * This method implements the pure virtual method defined in \ref ns3::WifiPhyHelper.
+   */
+  virtual Ptr<WifiPhy> Create (Ptr<Node> node, Ptr<NetDevice> device) const;
+
+  Ptr<AbstractWifiChannel> m_channel; ///< abstract wifi channel
+  mutable Ptr<TableErrorRateModel> m_errorRateTable; ///< error rate tables shared by the PHYs
+  mutable std::string m_errorRateTableConfig;        ///< error rate model configuration of m_errorRateTable
+};
+
+} //namespace ns3
+
+#endif /* ABSTRACT_WIFI_HELPER_H */
@@ -26,6 +26,7 @@
 #include "ns3/wifi-phy-state.h"
 #include "ns3/net-device-container.h"
 #include "ns3/node-container.h"
+#include "ns3/rng-seed-manager.h"
 #include "athstats-helper.h"
 #include <iomanip>
 #include <fstream>
@@ -35,21 +36,28 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Athstats");
 
 AthstatsHelper::AthstatsHelper ()
-  : m_interval (Seconds (1.0))
+  : m_interval (Seconds (1.0)),
+    m_intervalSet (false)
 {
 }
 
 void
-AthstatsHelper::EnableAthstats (std::string filename,  uint32_t nodeid, uint32_t deviceid)
+AthstatsHelper::SetInterval (Time interval)
+{
+  m_interval = interval;
+  m_intervalSet = true;
+}
+
+Ptr<AthstatsWifiTraceSink>
+AthstatsHelper::Connect (uint32_t nodeid, uint32_t deviceid)
 {
   Ptr<AthstatsWifiTraceSink> athstats = CreateObject<AthstatsWifiTraceSink> ();
-  std::ostringstream oss;
-  oss << filename
-      << "_" << std::setfill ('0') << std::setw (3) << std::right <<  nodeid
-      << "_" << std::setfill ('0') << std::setw (3) << std::right << deviceid;
-  athstats->Open (oss.str ());
+  if (m_intervalSet)
+    {
+      athstats->SetAttribute ("Interval", TimeValue (m_interval));
+    }
 
-  oss.str ("");
+  std::ostringstream oss;
   oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid;
   std::string devicepath = oss.str ();
 
@@ -65,6 +73,18 @@ AthstatsHelper::EnableAthstats (std::string filename,  uint32_t nodeid, uint32_t
   Config::Connect (devicepath + "/Phy/State/RxError", MakeCallback (&AthstatsWifiTraceSink::PhyRxErrorTrace, athstats));
   Config::Connect (devicepath + "/Phy/State/Tx", MakeCallback (&AthstatsWifiTraceSink::PhyTxTrace, athstats));
   Config::Connect (devicepath + "/Phy/State/State", MakeCallback (&AthstatsWifiTraceSink::PhyStateTrace, athstats));
+  return athstats;
+}
+
+void
+AthstatsHelper::EnableAthstats (std::string filename,  uint32_t nodeid, uint32_t deviceid)
+{
+  Ptr<AthstatsWifiTraceSink> athstats = Connect (nodeid, deviceid);
+  std::ostringstream oss;
+  oss << filename
+      << "_" << std::setfill ('0') << std::setw (3) << std::right <<  nodeid
+      << "_" << std::setfill ('0') << std::setw (3) << std::right << deviceid;
+  athstats->Open (oss.str ());
 }
 
 void
@@ -98,6 +118,108 @@ AthstatsHelper::EnableAthstats (std::string filename, NodeContainer n)
   EnableAthstats (filename, devs);
 }
 
+void
+AthstatsHelper::EnableAthstatsBinary (std::string filename, NetDeviceContainer d)
+{
+  Time interval = m_interval;
+  if (!m_intervalSet)
+    {
+      //the interval the trace sinks are created with
+      TypeId::AttributeInformation info;
+      AthstatsWifiTraceSink::GetTypeId ().LookupAttributeByName ("Interval", &info);
+      interval = DynamicCast<const TimeValue> (info.initialValue)->Get ();
+    }
+  Ptr<AthstatsBinaryWriter> writer = Create<AthstatsBinaryWriter> (filename, interval);
+  for (NetDeviceContainer::Iterator i = d.Begin (); i != d.End (); ++i)
+    {
+      Ptr<NetDevice> dev = *i;
+      uint32_t nodeid = dev->GetNode ()->GetId ();
+      uint32_t deviceid = dev->GetIfIndex ();
+      Connect (nodeid, deviceid)->SetBinaryWriter (writer, nodeid, deviceid);
+    }
+  //the sinks may outlive the simulation, so that the file is closed
+  //when the simulation is destroyed
+  Simulator::ScheduleDestroy (&AthstatsBinaryWriter::Close, writer);
+}
+
+void
+AthstatsHelper::EnableAthstatsBinary (std::string filename, NodeContainer n)
+{
+  NetDeviceContainer devs;
+  for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      for (std::size_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          devs.Add (node->GetDevice (j));
+        }
+    }
+  EnableAthstatsBinary (filename, devs);
+}
+
+/**
+ * Write an unsigned integer in little endian byte order
+ * \param os the output stream
+ * \param value the value
+ * \param size the number of bytes to write
+ */
+static void
+WriteLittleEndian (std::ostream &os, uint64_t value, uint32_t size)
+{
+  char bytes[8];
+  for (uint32_t i = 0; i < size; i++)
+    {
+      bytes[i] = static_cast<char> ((value >> (8 * i)) & 0xff);
+    }
+  os.write (bytes, size);
+}
+
+AthstatsBinaryWriter::AthstatsBinaryWriter (std::string const &name, Time interval)
+  : m_run (static_cast<uint32_t> (RngSeedManager::GetRun ()))
+{
+  NS_LOG_FUNCTION (this << name << interval);
+  m_writer.open (name.c_str (), std::ios_base::binary | std::ios_base::out);
+  NS_ABORT_MSG_IF (m_writer.fail (), "AthstatsBinaryWriter: open (" << name << ") failed");
+  m_writer.write ("NS3ATHST", 8);
+  WriteLittleEndian (m_writer, 1, 4);
+  WriteLittleEndian (m_writer, RECORD_SIZE, 4);
+  WriteLittleEndian (m_writer, interval.GetNanoSeconds (), 8);
+}
+
+AthstatsBinaryWriter::~AthstatsBinaryWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+AthstatsBinaryWriter::Write (uint32_t nodeid, uint32_t deviceid, uint32_t index, const uint32_t counters[N_COUNTERS])
+{
+  NS_LOG_FUNCTION (this << nodeid << deviceid << index);
+  if (!m_writer.is_open ())
+    {
+      return;
+    }
+  WriteLittleEndian (m_writer, m_run, 4);
+  WriteLittleEndian (m_writer, nodeid, 4);
+  WriteLittleEndian (m_writer, deviceid, 4);
+  WriteLittleEndian (m_writer, index, 4);
+  for (uint32_t i = 0; i < N_COUNTERS; i++)
+    {
+      WriteLittleEndian (m_writer, counters[i], 4);
+    }
+}
+
+void
+AthstatsBinaryWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writer.is_open ())
+    {
+      m_writer.close ();
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED (AthstatsWifiTraceSink);
 
 TypeId
@@ -125,7 +247,10 @@ AthstatsWifiTraceSink::AthstatsWifiTraceSink ()
     m_phyRxOkCount (0),
     m_phyRxErrorCount (0),
     m_phyTxCount (0),
-    m_writer (0)
+    m_writer (0),
+    m_nodeId (0),
+    m_deviceId (0),
+    m_reportIndex (0)
 {
   Simulator::ScheduleNow (&AthstatsWifiTraceSink::WriteStats, this);
 }
@@ -256,10 +381,30 @@ AthstatsWifiTraceSink::Open (std::string const &name)
   NS_LOG_LOGIC ("Writer opened successfully");
 }
 
+void
+AthstatsWifiTraceSink::SetBinaryWriter (Ptr<AthstatsBinaryWriter> writer, uint32_t nodeid, uint32_t deviceid)
+{
+  NS_LOG_FUNCTION (this << nodeid << deviceid);
+  NS_ABORT_MSG_UNLESS (m_writer == 0, "AthstatsWifiTraceSink::SetBinaryWriter (): text output already open");
+  m_binaryWriter = writer;
+  m_nodeId = nodeid;
+  m_deviceId = deviceid;
+}
+
 void
 AthstatsWifiTraceSink::WriteStats ()
 {
   NS_LOG_FUNCTION (this);
+  if (m_binaryWriter)
+    {
+      uint32_t counters[AthstatsBinaryWriter::N_COUNTERS] = {m_txCount, m_rxCount, m_shortRetryCount,
+                                                             m_longRetryCount, m_exceededRetryCount,
+                                                             m_phyRxOkCount, m_phyRxErrorCount, m_phyTxCount};
+      m_binaryWriter->Write (m_nodeId, m_deviceId, m_reportIndex++, counters);
+      ResetCounters ();
+      Simulator::Schedule (m_interval, &AthstatsWifiTraceSink::WriteStats, this);
+      return;
+    }
   //The comments below refer to how each value maps to madwifi's athstats
   //I know C strings are ugly but that's the quickest way to use exactly the same format as in madwifi
   char str[200];
@@ -21,6 +21,10 @@
 #ifndef ATHSTATS_HELPER_H
 #define ATHSTATS_HELPER_H
 
+#include <fstream>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
 #include "ns3/wifi-phy-state.h"
 
 namespace ns3 {
@@ -30,16 +34,29 @@ class NodeContainer;
 class NetDeviceContainer;
 class Packet;
 class Mac48Address;
+class AthstatsBinaryWriter;
+class AthstatsWifiTraceSink;
 
 /**
  * @brief create AthstatsWifiTraceSink instances and connect them to wifi devices
  *
- *
+ * The reports can either be written in text format, in one file per
+ * device (EnableAthstats), or in binary format, in a single file shared by
+ * all the devices (EnableAthstatsBinary).  See AthstatsBinaryWriter for
+ * the binary format; the athstats-merge.py program in src/wifi/examples
+ * merges binary files from several runs and converts them to CSV.
  */
 class AthstatsHelper
 {
 public:
   AthstatsHelper ();
+  /**
+   * Set the interval between two reports of the devices enabled afterwards.
+   * Unless this is called, the devices use the default value of the
+   * ns3::AthstatsWifiTraceSink::Interval attribute.
+   * \param interval the interval between two reports
+   */
+  void SetInterval (Time interval);
   /**
    * Enable athstats
    * \param filename the file name
@@ -65,9 +82,85 @@ public:
    * \param n the collection of nodes
    */
   void EnableAthstats (std::string filename, NodeContainer n);
+  /**
+   * Enable athstats in binary format, with a single file for all the devices
+   * \param filename the file name
+   * \param d the collection of devices
+   */
+  void EnableAthstatsBinary (std::string filename, NetDeviceContainer d);
+  /**
+   * Enable athstats in binary format, with a single file for all the devices
+   * \param filename the file name
+   * \param n the collection of nodes
+   */
+  void EnableAthstatsBinary (std::string filename, NodeContainer n);
 
 private:
-  Time m_interval; ///< interval
+  /**
+   * Create a trace sink and connect it to the traces of a device
+   * \param nodeid the node ID
+   * \param deviceid the device ID
+   * \return the trace sink
+   */
+  Ptr<AthstatsWifiTraceSink> Connect (uint32_t nodeid, uint32_t deviceid);
+
+  Time m_interval;    ///< interval
+  bool m_intervalSet; ///< whether SetInterval was called
+};
+
+
+/**
+ * @brief write the athstats reports of many devices to a single binary file
+ *
+ * All the integers are unsigned and little endian.  The file starts with
+ * a 24 byte header:
+ *
+ * - the magic string "NS3ATHST" (8 bytes)
+ * - the version of the format, 1 (4 bytes)
+ * - the size of a record, 48 (4 bytes)
+ * - the interval between two reports in nanoseconds (8 bytes)
+ *
+ * followed by one fixed size record per device and per report, made of
+ * twelve 4 byte fields: the run number (see RngSeedManager::GetRun), the
+ * node ID, the device ID, the index of the report (the first report is
+ * written when the simulation starts, and covers no time), then the
+ * transmitted and received packets, the short, long and exceeded retries,
+ * the PHY receptions with and without errors and the PHY transmissions
+ * during the interval.
+ *
+ * Since records carry the run number, the files of several runs can be
+ * merged by concatenating their records.
+ */
+class AthstatsBinaryWriter : public SimpleRefCount<AthstatsBinaryWriter>
+{
+public:
+  /// Number of counters of a record
+  static const uint32_t N_COUNTERS = 8;
+  /// Size of a record in bytes
+  static const uint32_t RECORD_SIZE = 4 * (4 + N_COUNTERS);
+
+  /**
+   * Open a file and write the header
+   * \param name the name of the file
+   * \param interval the interval between two reports
+   */
+  AthstatsBinaryWriter (std::string const &name, Time interval);
+  ~AthstatsBinaryWriter ();
+
+  /**
+   * Write the record of a report
+   * \param nodeid the node ID
+   * \param deviceid the device ID
+   * \param index the index of the report
+   * \param counters the counters
+   */
+  void Write (uint32_t nodeid, uint32_t deviceid, uint32_t index, const uint32_t counters[N_COUNTERS]);
+  /// Flush and close the file
+  void Close (void);
+
+private:
+  std::ofstream m_writer; ///< output stream
+  uint32_t m_run;         ///< run number
 };
 
 
@@ -208,6 +301,16 @@ public:
    */
   void Open (std::string const& name);
 
+  /**
+   * Write the reports to a binary file shared with other devices
+   * instead of a text file
+   *
+   * @param writer the binary writer
+   * @param nodeid the node ID of the device
+   * @param deviceid the device ID of the device
+   */
+  void SetBinaryWriter (Ptr<AthstatsBinaryWriter> writer, uint32_t nodeid, uint32_t deviceid);
+
 
 private:
   /// Write status function
@@ -225,6 +328,10 @@ private:
   uint32_t m_phyTxCount; ///< phy transmit count
 
   std::ofstream *m_writer; ///< output stream
+  Ptr<AthstatsBinaryWriter> m_binaryWriter; ///< binary output, if any
+  uint32_t m_nodeId; ///< node ID, for binary output
+  uint32_t m_deviceId; ///< device ID, for binary output
+  uint32_t m_reportIndex; ///< index of the next report, for binary output
 
   Time m_interval; ///< interval
 
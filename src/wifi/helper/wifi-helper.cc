@@ -21,6 +21,7 @@
  */
 
 #include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy-state-helper.h"
 #include "ns3/minstrel-wifi-manager.h"
 #include "ns3/minstrel-ht-wifi-manager.h"
 #include "ns3/ap-wifi-mac.h"
@@ -29,7 +30,6 @@
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/radiotap-header.h"
-#include "ns3/config.h"
 #include "ns3/names.h"
 #include "wifi-helper.h"
 
@@ -504,7 +504,7 @@ WifiPhyHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool p
       filename = pcapHelper.GetFilenameFromDevice (prefix, device);
     }
 
-  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, m_pcapDlt);
+  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, m_pcapDlt, device);
 
   phy->TraceConnectWithoutContext ("MonitorSnifferTx", MakeBoundCallback (&WifiPhyHelper::PcapSniffTxEvent, file));
   phy->TraceConnectWithoutContext ("MonitorSnifferRx", MakeBoundCallback (&WifiPhyHelper::PcapSniffRxEvent, file));
@@ -535,6 +535,15 @@ WifiPhyHelper::EnableAsciiInternal (
   uint32_t deviceid = nd->GetIfIndex ();
   std::ostringstream oss;
 
+  //Connect the trace sinks directly to the state of the PHY rather than
+  //through Config paths, whose resolution dominates the cost of enabling
+  //tracing on large topologies.
+  Ptr<WifiPhy> phy = device->GetPhy ();
+  NS_ABORT_MSG_IF (phy == 0, "WifiPhyHelper::EnableAsciiInternal(): Phy layer in WifiNetDevice must be set");
+  PointerValue ptr;
+  phy->GetAttribute ("State", ptr);
+  Ptr<WifiPhyStateHelper> state = ptr.Get<WifiPhyStateHelper> ();
+
   //If we are not provided an OutputStreamWrapper, we are expected to create
   //one using the usual trace filename conventions and write our traces
   //without a context since there will be one file per context and therefore
@@ -557,33 +566,19 @@ WifiPhyHelper::EnableAsciiInternal (
         }
 
       Ptr<OutputStreamWrapper> theStream = asciiTraceHelper.CreateFileStream (filename);
-      //We could go poking through the phy and the state looking for the
-      //correct trace source, but we can let Config deal with that with
-      //some search cost.  Since this is presumably happening at topology
-      //creation time, it doesn't seem much of a price to pay.
-      oss.str ("");
-      oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::WifiNetDevice/Phy/State/RxOk";
-      Config::ConnectWithoutContext (oss.str (), MakeBoundCallback (&AsciiPhyReceiveSinkWithoutContext, theStream));
-
-      oss.str ("");
-      oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::WifiNetDevice/Phy/State/Tx";
-      Config::ConnectWithoutContext (oss.str (), MakeBoundCallback (&AsciiPhyTransmitSinkWithoutContext, theStream));
-
+      state->TraceConnectWithoutContext ("RxOk", MakeBoundCallback (&AsciiPhyReceiveSinkWithoutContext, theStream));
+      state->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&AsciiPhyTransmitSinkWithoutContext, theStream));
       return;
     }
 
   //If we are provided an OutputStreamWrapper, we are expected to use it, and
   //to provide a context. We are free to come up with our own context if we
   //want, and use the AsciiTraceHelper Hook*WithContext functions, but for
-  //compatibility and simplicity, we just use Config::Connect and let it deal
-  //with coming up with a context.
-  oss.str ("");
-  oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::WifiNetDevice/Phy/State/RxOk";
-  Config::Connect (oss.str (), MakeBoundCallback (&AsciiPhyReceiveSinkWithContext, stream));
-
-  oss.str ("");
-  oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::WifiNetDevice/Phy/State/Tx";
-  Config::Connect (oss.str (), MakeBoundCallback (&AsciiPhyTransmitSinkWithContext, stream));
+  //compatibility and simplicity, we use the context Config::Connect would
+  //provide for the path of the trace source.
+  oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::WifiNetDevice/Phy/State/";
+  state->TraceConnect ("RxOk", oss.str () + "RxOk", MakeBoundCallback (&AsciiPhyReceiveSinkWithContext, stream));
+  state->TraceConnect ("Tx", oss.str () + "Tx", MakeBoundCallback (&AsciiPhyTransmitSinkWithContext, stream));
 }
 
 WifiHelper::~WifiHelper ()
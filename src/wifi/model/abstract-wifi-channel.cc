@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <limits>
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/mobility-model.h"
+#include "abstract-wifi-channel.h"
+#include "abstract-wifi-phy.h"
+#include "wifi-utils.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AbstractWifiChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (AbstractWifiChannel);
+
+TypeId
+AbstractWifiChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AbstractWifiChannel")
+    .SetParent<Channel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<AbstractWifiChannel> ()
+    .AddAttribute ("PropagationLossModel", "A pointer to the propagation loss model attached to this channel.",
+                   PointerValue (),
+                   MakePointerAccessor (&AbstractWifiChannel::SetPropagationLossModel,
+                                        &AbstractWifiChannel::GetPropagationLossModel),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("PropagationDelayModel", "A pointer to the propagation delay model attached to this channel.",
+                   PointerValue (),
+                   MakePointerAccessor (&AbstractWifiChannel::m_delay),
+                   MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("RxSensitivityCull",
+                   "Receive power (dBm, including the receiver RX gain) below which a "
+                   "transmission is not delivered to a receiver at all: no event is "
+                   "scheduled, so the receiver does not see it even as interference.",
+                   DoubleValue (-std::numeric_limits<double>::max ()),
+                   MakeDoubleAccessor (&AbstractWifiChannel::m_rxSensitivityCull),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+AbstractWifiChannel::AbstractWifiChannel ()
+  : m_nPathLossEvaluations (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AbstractWifiChannel::~AbstractWifiChannel ()
+{
+  NS_LOG_FUNCTION (this);
+  m_phyList.clear ();
+}
+
+void
+AbstractWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_mobility.size (); i++)
+    {
+      if (m_mobility[i] != 0)
+        {
+          m_mobility[i]->TraceDisconnectWithoutContext ("CourseChange",
+                                                        MakeBoundCallback (&AbstractWifiChannel::CourseChanged,
+                                                                           this, i));
+        }
+    }
+  m_mobility.clear ();
+  m_pathLoss.clear ();
+  m_phyList.clear ();
+  m_loss = 0;
+  m_delay = 0;
+  Channel::DoDispose ();
+}
+
+void
+AbstractWifiChannel::SetPropagationLossModel (const Ptr<PropagationLossModel> loss)
+{
+  NS_LOG_FUNCTION (this << loss);
+  m_loss = loss;
+  for (uint32_t i = 0; i < m_pathLoss.size (); i++)
+    {
+      m_pathLoss[i].clear ();
+    }
+}
+
+Ptr<PropagationLossModel>
+AbstractWifiChannel::GetPropagationLossModel (void) const
+{
+  return m_loss;
+}
+
+void
+AbstractWifiChannel::SetPropagationDelayModel (const Ptr<PropagationDelayModel> delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  m_delay = delay;
+}
+
+void
+AbstractWifiChannel::Send (uint32_t sender, Ptr<const Packet> packet, double txPowerDbm, Time duration) const
+{
+  NS_LOG_FUNCTION (this << sender << packet << txPowerDbm << duration.GetSeconds ());
+  Ptr<AbstractWifiPhy> senderPhy = m_phyList[sender];
+  Ptr<MobilityModel> senderMobility = GetMobility (sender);
+  Vector velocity = senderMobility->GetVelocity ();
+  bool senderStationary = velocity.x == 0 && velocity.y == 0 && velocity.z == 0;
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      Ptr<AbstractWifiPhy> receiver = m_phyList[i];
+      //For now don't account for inter channel interference nor channel bonding
+      if (i == sender || receiver->GetChannelNumber () != senderPhy->GetChannelNumber ())
+        {
+          continue;
+        }
+      Ptr<MobilityModel> receiverMobility = GetMobility (i);
+      velocity = receiverMobility->GetVelocity ();
+      bool stationary = senderStationary && velocity.x == 0 && velocity.y == 0 && velocity.z == 0;
+      double rxPowerDbm = txPowerDbm - GetPathLoss (sender, i, senderMobility, receiverMobility, stationary);
+      if (rxPowerDbm + receiver->GetRxGain () < m_rxSensitivityCull)
+        {
+          NS_LOG_DEBUG ("culled: rxPower=" << rxPowerDbm << "dbm");
+          continue;
+        }
+      Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                    "delay=" << delay);
+      Ptr<Packet> copy = packet->Copy ();
+      Ptr<NetDevice> dstNetDevice = receiver->GetDevice ();
+      uint32_t dstNode;
+      if (dstNetDevice == 0)
+        {
+          dstNode = 0xffffffff;
+        }
+      else
+        {
+          dstNode = dstNetDevice->GetNode ()->GetId ();
+        }
+
+      Simulator::ScheduleWithContext (dstNode,
+                                      delay, &AbstractWifiChannel::Receive,
+                                      receiver, copy, rxPowerDbm, duration);
+    }
+}
+
+Ptr<MobilityModel>
+AbstractWifiChannel::GetMobility (uint32_t i) const
+{
+  if (m_mobility[i] == 0)
+    {
+      m_mobility[i] = m_phyList[i]->GetMobility ();
+      NS_ASSERT (m_mobility[i] != 0);
+      m_mobility[i]->TraceConnectWithoutContext ("CourseChange",
+                                                 MakeBoundCallback (&AbstractWifiChannel::CourseChanged, this, i));
+    }
+  return m_mobility[i];
+}
+
+double
+AbstractWifiChannel::GetPathLoss (uint32_t from, uint32_t to,
+                                  Ptr<MobilityModel> fromMobility, Ptr<MobilityModel> toMobility,
+                                  bool cache) const
+{
+  if (!cache)
+    {
+      m_nPathLossEvaluations++;
+      return -m_loss->CalcRxPower (0, fromMobility, toMobility);
+    }
+  std::vector<double> &row = m_pathLoss[from];
+  if (row.size () <= to)
+    {
+      row.resize (m_phyList.size (), std::numeric_limits<double>::quiet_NaN ());
+    }
+  if (std::isnan (row[to]))
+    {
+      m_nPathLossEvaluations++;
+      row[to] = -m_loss->CalcRxPower (0, fromMobility, toMobility);
+    }
+  return row[to];
+}
+
+void
+AbstractWifiChannel::Invalidate (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  m_pathLoss[i].clear ();
+  for (std::vector<std::vector<double> >::iterator row = m_pathLoss.begin (); row != m_pathLoss.end (); row++)
+    {
+      if (row->size () > i)
+        {
+          (*row)[i] = std::numeric_limits<double>::quiet_NaN ();
+        }
+    }
+}
+
+void
+AbstractWifiChannel::CourseChanged (const AbstractWifiChannel *channel, uint32_t i, Ptr<const MobilityModel> mobility)
+{
+  channel->Invalidate (i);
+}
+
+void
+AbstractWifiChannel::Receive (Ptr<AbstractWifiPhy> phy, Ptr<Packet> packet, double rxPowerDbm, Time duration)
+{
+  NS_LOG_FUNCTION (phy << packet << rxPowerDbm << duration.GetSeconds ());
+  phy->StartReceivePreambleAndHeader (packet, DbmToW (rxPowerDbm + phy->GetRxGain ()), duration);
+}
+
+uint64_t
+AbstractWifiChannel::GetNPathLossEvaluations (void) const
+{
+  return m_nPathLossEvaluations;
+}
+
+std::size_t
+AbstractWifiChannel::GetNDevices (void) const
+{
+  return m_phyList.size ();
+}
+
+Ptr<NetDevice>
+AbstractWifiChannel::GetDevice (std::size_t i) const
+{
+  return m_phyList[i]->GetDevice ()->GetObject<NetDevice> ();
+}
+
+uint32_t
+AbstractWifiChannel::Add (Ptr<AbstractWifiPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  m_phyList.push_back (phy);
+  m_mobility.push_back (0);
+  m_pathLoss.push_back (std::vector<double> ());
+  return m_phyList.size () - 1;
+}
+
+int64_t
+AbstractWifiChannel::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  int64_t currentStream = stream;
+  currentStream += m_loss->AssignStreams (stream);
+  return (currentStream - stream);
+}
+
+} //namespace ns3
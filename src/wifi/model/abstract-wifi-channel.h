@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ABSTRACT_WIFI_CHANNEL_H
+#define ABSTRACT_WIFI_CHANNEL_H
+
+#include <vector>
+#include "ns3/channel.h"
+
+namespace ns3 {
+
+class NetDevice;
+class PropagationLossModel;
+class PropagationDelayModel;
+class AbstractWifiPhy;
+class Packet;
+class Time;
+class MobilityModel;
+
+/**
+ * \brief a channel to interconnect ns3::AbstractWifiPhy objects.
+ * \ingroup wifi
+ *
+ * This channel delivers every transmission to the other PHYs operating on
+ * the sender's channel number, like ns3::YansWifiChannel, but it keeps the
+ * path loss between every pair of stationary PHYs in a matrix, so that the
+ * ns3::PropagationLossModel is evaluated once per pair rather than once per
+ * frame.  A row of the matrix is allocated the first time the
+ * corresponding PHY transmits.
+ *
+ * Entries are discarded when the CourseChange trace of the mobility model
+ * of either PHY fires.  Pairs involving a PHY with a non-zero velocity,
+ * which moves without course change notifications, are never cached.  The
+ * cache assumes a deterministic propagation loss model: with a random one
+ * (e.g. ns3::NakagamiPropagationLossModel), the first sample of each pair
+ * would be frozen.
+ *
+ * As in ns3::YansWifiChannel, the RxSensitivityCull attribute drops the
+ * receptions whose power is below the given threshold before any event is
+ * scheduled.
+ */
+class AbstractWifiChannel : public Channel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  AbstractWifiChannel ();
+  virtual ~AbstractWifiChannel ();
+
+  //inherited from Channel.
+  virtual std::size_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
+
+  /**
+   * Adds the given AbstractWifiPhy to the PHY list
+   *
+   * \param phy the AbstractWifiPhy to be added to the PHY list
+   * \return the index of the PHY, to be passed to Send
+   */
+  uint32_t Add (Ptr<AbstractWifiPhy> phy);
+
+  /**
+   * \param loss the new propagation loss model.
+   */
+  void SetPropagationLossModel (const Ptr<PropagationLossModel> loss);
+  /**
+   * \return the propagation loss model.
+   */
+  Ptr<PropagationLossModel> GetPropagationLossModel (void) const;
+  /**
+   * \param delay the new propagation delay model.
+   */
+  void SetPropagationDelayModel (const Ptr<PropagationDelayModel> delay);
+
+  /**
+   * \param sender the index of the PHY from which the packet is originating.
+   * \param packet the packet to send
+   * \param txPowerDbm the tx power associated to the packet, in dBm
+   * \param duration the transmission duration associated with the packet
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from AbstractWifiPhy::StartTx.  The channel
+   * attempts to deliver the packet to all other AbstractWifiPhy objects
+   * on the channel (except for the sender).
+   */
+  void Send (uint32_t sender, Ptr<const Packet> packet, double txPowerDbm, Time duration) const;
+
+  /**
+   * \return the number of times the propagation loss model was evaluated
+   */
+  uint64_t GetNPathLossEvaluations (void) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   *
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * A vector of pointers to AbstractWifiPhy.
+   */
+  typedef std::vector<Ptr<AbstractWifiPhy> > PhyList;
+
+  /**
+   * Return the mobility model of a PHY, connecting to its CourseChange
+   * trace the first time.
+   *
+   * \param i the index of the PHY
+   * \return the mobility model of the PHY
+   */
+  Ptr<MobilityModel> GetMobility (uint32_t i) const;
+  /**
+   * Return the path loss from a PHY to another, from the matrix if possible.
+   *
+   * \param from the index of the sending PHY
+   * \param to the index of the receiving PHY
+   * \param fromMobility the mobility model of the sending PHY
+   * \param toMobility the mobility model of the receiving PHY
+   * \param cache whether the path loss may be read from and stored in the matrix
+   * \return the path loss (dB)
+   */
+  double GetPathLoss (uint32_t from, uint32_t to,
+                      Ptr<MobilityModel> fromMobility, Ptr<MobilityModel> toMobility,
+                      bool cache) const;
+  /**
+   * Discard the row and the column of a PHY from the matrix
+   *
+   * \param i the index of the PHY
+   */
+  void Invalidate (uint32_t i) const;
+  /**
+   * Callback of the CourseChange trace of the mobility model of a PHY
+   *
+   * \param channel the channel
+   * \param i the index of the PHY
+   * \param mobility the mobility model
+   */
+  static void CourseChanged (const AbstractWifiChannel *channel, uint32_t i, Ptr<const MobilityModel> mobility);
+
+  /**
+   * This method is scheduled by Send for each associated AbstractWifiPhy.
+   * The method then calls the corresponding AbstractWifiPhy that the first
+   * bit of the packet has arrived.
+   *
+   * \param receiver the device to which the packet is destined
+   * \param packet the packet being sent
+   * \param txPowerDbm the tx power associated to the packet being sent (dBm)
+   * \param duration the transmission duration associated with the packet being sent
+   */
+  static void Receive (Ptr<AbstractWifiPhy> receiver, Ptr<Packet> packet, double txPowerDbm, Time duration);
+
+  PhyList m_phyList;                                  //!< List of AbstractWifiPhys connected to this AbstractWifiChannel
+  Ptr<PropagationLossModel> m_loss;                   //!< Propagation loss model
+  Ptr<PropagationDelayModel> m_delay;                 //!< Propagation delay model
+  double m_rxSensitivityCull;                         //!< receive power (dBm) below which receptions are dropped
+  mutable std::vector<Ptr<MobilityModel> > m_mobility; //!< the mobility model of each PHY, once connected
+  mutable std::vector<std::vector<double> > m_pathLoss; //!< path loss (dB) from each PHY to each PHY, NaN if unknown
+  mutable uint64_t m_nPathLossEvaluations;            //!< number of evaluations of the propagation loss model
+};
+
+} //namespace ns3
+
+#endif /* ABSTRACT_WIFI_CHANNEL_H */
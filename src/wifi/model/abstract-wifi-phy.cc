@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "abstract-wifi-phy.h"
+#include "abstract-wifi-channel.h"
+#include "table-error-rate-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AbstractWifiPhy");
+
+NS_OBJECT_ENSURE_REGISTERED (AbstractWifiPhy);
+
+TypeId
+AbstractWifiPhy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AbstractWifiPhy")
+    .SetParent<WifiPhy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<AbstractWifiPhy> ()
+  ;
+  return tid;
+}
+
+AbstractWifiPhy::AbstractWifiPhy ()
+  : m_channelIndex (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AbstractWifiPhy::~AbstractWifiPhy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+AbstractWifiPhy::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<ErrorRateModel> model = m_interference.GetErrorRateModel ();
+  if (model != 0 && DynamicCast<TableErrorRateModel> (model) == 0)
+    {
+      Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+      table->SetErrorRateModel (model);
+      SetErrorRateModel (table);
+    }
+  WifiPhy::DoInitialize ();
+}
+
+void
+AbstractWifiPhy::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_channel = 0;
+  WifiPhy::DoDispose ();
+}
+
+Ptr<Channel>
+AbstractWifiPhy::GetChannel (void) const
+{
+  return m_channel;
+}
+
+void
+AbstractWifiPhy::SetChannel (const Ptr<AbstractWifiChannel> channel)
+{
+  NS_LOG_FUNCTION (this << channel);
+  m_channel = channel;
+  m_channelIndex = m_channel->Add (this);
+}
+
+void
+AbstractWifiPhy::StartTx (Ptr<Packet> packet, WifiTxVector txVector, Time txDuration)
+{
+  NS_LOG_DEBUG ("Start transmission: signal power before antenna gain=" << GetPowerDbm (txVector.GetTxPowerLevel ()) << "dBm");
+  m_channel->Send (m_channelIndex, packet, GetPowerDbm (txVector.GetTxPowerLevel ()) + GetTxGain (), txDuration);
+}
+
+InterferenceHelper::SnrPer
+AbstractWifiPhy::CalculatePlcpHeaderSnrPer (Ptr<Event> event) const
+{
+  return m_interference.CalculateEffectivePlcpHeaderSnrPer (event);
+}
+
+InterferenceHelper::SnrPer
+AbstractWifiPhy::CalculatePlcpPayloadSnrPer (Ptr<Event> event) const
+{
+  return m_interference.CalculateEffectivePlcpPayloadSnrPer (event);
+}
+
+} //namespace ns3
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ABSTRACT_WIFI_PHY_H
+#define ABSTRACT_WIFI_PHY_H
+
+#include "wifi-phy.h"
+
+namespace ns3 {
+
+class AbstractWifiChannel;
+
+/**
+ * \brief 802.11 PHY layer model for large scale studies
+ * \ingroup wifi
+ *
+ * This PHY keeps the state machine, the carrier sense and the reception
+ * procedure of ns3::WifiPhy, so that the MAC and the rate control
+ * algorithms behave as with ns3::YansWifiPhy, but it abstracts the error
+ * model of received frames.  Instead of integrating the error rate over
+ * every chunk of constant interference, the PLCP header and payload of a
+ * frame are each evaluated once, at the effective SINR of the frame: the
+ * SINR at the peak of the noise and interference power over the frame.
+ * This is pessimistic when a short interferer overlaps a long frame.
+ *
+ * The error rates are read from effective SINR to PER tables: at
+ * initialization, an error rate model which is not already a
+ * ns3::TableErrorRateModel is wrapped in one, whose tables are computed on
+ * first use of each mode.  ns3::AbstractWifiPhyHelper gives all the PHYs
+ * it creates the same ns3::TableErrorRateModel, so that the tables are
+ * computed once for the whole network.
+ *
+ * The received power is obtained from an ns3::AbstractWifiChannel, which
+ * caches the path loss between stationary PHYs.
+ */
+class AbstractWifiPhy : public WifiPhy
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  AbstractWifiPhy ();
+  virtual ~AbstractWifiPhy ();
+
+  /**
+   * Set the AbstractWifiChannel this AbstractWifiPhy is to be connected to.
+   *
+   * \param channel the AbstractWifiChannel this AbstractWifiPhy is to be connected to
+   */
+  void SetChannel (const Ptr<AbstractWifiChannel> channel);
+
+  /**
+   * \param packet the packet to send
+   * \param txVector the TXVECTOR that has tx parameters such as mode, the transmission mode to use to send
+   *        this packet, and txPowerLevel, a power level to use to send this packet. The real transmission
+   *        power is calculated as txPowerMin + txPowerLevel * (txPowerMax - txPowerMin) / nTxLevels
+   * \param txDuration duration of the transmission.
+   */
+  void StartTx (Ptr<Packet> packet, WifiTxVector txVector, Time txDuration);
+
+  virtual Ptr<Channel> GetChannel (void) const;
+
+
+protected:
+  // Inherited
+  virtual void DoInitialize (void);
+  virtual void DoDispose (void);
+  virtual InterferenceHelper::SnrPer CalculatePlcpHeaderSnrPer (Ptr<Event> event) const;
+  virtual InterferenceHelper::SnrPer CalculatePlcpPayloadSnrPer (Ptr<Event> event) const;
+
+
+private:
+  Ptr<AbstractWifiChannel> m_channel; //!< AbstractWifiChannel that this AbstractWifiPhy is connected to
+  uint32_t m_channelIndex;            //!< the index of this AbstractWifiPhy in its channel
+};
+
+} //namespace ns3
+
+#endif /* ABSTRACT_WIFI_PHY_H */
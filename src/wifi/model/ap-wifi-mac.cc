@@ -90,7 +90,10 @@ ApWifiMac::GetTypeId (void)
 }
 
 ApWifiMac::ApWifiMac ()
-  : m_enableBeaconGeneration (false)
+  : m_enableBeaconGeneration (false),
+    m_beaconUpToDate (false),
+    m_beaconChannelNumber (0),
+    m_beaconChannelWidth (0)
 {
   NS_LOG_FUNCTION (this);
   m_beaconTxop = CreateObject<Txop> ();
@@ -776,6 +779,8 @@ ApWifiMac::SendAssocResp (Mac48Address to, bool success, bool isReassoc)
   StatusCode code;
   if (success)
     {
+      //the list of associated stations changes
+      m_beaconUpToDate = false;
       code.SetSuccess ();
       uint16_t aid = 0;
       bool found = false;
@@ -839,57 +844,77 @@ ApWifiMac::SendAssocResp (Mac48Address to, bool success, bool isReassoc)
 }
 
 void
-ApWifiMac::SendOneBeacon (void)
+ApWifiMac::UpdateBeacon (void)
 {
   NS_LOG_FUNCTION (this);
-  WifiMacHeader hdr;
-  hdr.SetType (WIFI_MAC_MGT_BEACON);
-  hdr.SetAddr1 (Mac48Address::GetBroadcast ());
-  hdr.SetAddr2 (GetAddress ());
-  hdr.SetAddr3 (GetAddress ());
-  hdr.SetDsNotFrom ();
-  hdr.SetDsNotTo ();
-  Ptr<Packet> packet = Create<Packet> ();
-  MgtBeaconHeader beacon;
-  beacon.SetSsid (GetSsid ());
-  beacon.SetSupportedRates (GetSupportedRates ());
-  beacon.SetBeaconIntervalUs (GetBeaconInterval ().GetMicroSeconds ());
-  beacon.SetCapabilities (GetCapabilities ());
+  m_beacon = MgtBeaconHeader ();
+  m_beacon.SetSsid (GetSsid ());
+  m_beacon.SetSupportedRates (GetSupportedRates ());
+  m_beacon.SetBeaconIntervalUs (GetBeaconInterval ().GetMicroSeconds ());
+  m_beacon.SetCapabilities (GetCapabilities ());
   m_stationManager->SetShortPreambleEnabled (GetShortPreambleEnabled ());
   m_stationManager->SetShortSlotTimeEnabled (GetShortSlotTimeEnabled ());
-  if (GetPcfSupported ())
-    {
-      beacon.SetCfParameterSet (GetCfParameterSet ());
-    }
   if (GetDsssSupported ())
     {
-      beacon.SetDsssParameterSet (GetDsssParameterSet ());
+      m_beacon.SetDsssParameterSet (GetDsssParameterSet ());
     }
   if (GetErpSupported ())
     {
-      beacon.SetErpInformation (GetErpInformation ());
-    }
-  if (GetQosSupported ())
-    {
-      beacon.SetEdcaParameterSet (GetEdcaParameterSet ());
+      m_beacon.SetErpInformation (GetErpInformation ());
     }
   if (GetHtSupported () || GetVhtSupported ())
     {
-      beacon.SetExtendedCapabilities (GetExtendedCapabilities ());
-      beacon.SetHtCapabilities (GetHtCapabilities ());
-      beacon.SetHtOperation (GetHtOperation ());
+      m_beacon.SetExtendedCapabilities (GetExtendedCapabilities ());
+      m_beacon.SetHtCapabilities (GetHtCapabilities ());
+      m_beacon.SetHtOperation (GetHtOperation ());
     }
   if (GetVhtSupported () || GetHeSupported ())
     {
-      beacon.SetVhtCapabilities (GetVhtCapabilities ());
-      beacon.SetVhtOperation (GetVhtOperation ());
+      m_beacon.SetVhtCapabilities (GetVhtCapabilities ());
+      m_beacon.SetVhtOperation (GetVhtOperation ());
     }
   if (GetHeSupported ())
     {
-      beacon.SetHeCapabilities (GetHeCapabilities ());
-      beacon.SetHeOperation (GetHeOperation ());
+      m_beacon.SetHeCapabilities (GetHeCapabilities ());
+      m_beacon.SetHeOperation (GetHeOperation ());
     }
-  packet->AddHeader (beacon);
+  m_beaconChannelNumber = m_phy->GetChannelNumber ();
+  m_beaconChannelWidth = m_phy->GetChannelWidth ();
+  m_beaconUpToDate = true;
+}
+
+void
+ApWifiMac::SendOneBeacon (void)
+{
+  NS_LOG_FUNCTION (this);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_MGT_BEACON);
+  hdr.SetAddr1 (Mac48Address::GetBroadcast ());
+  hdr.SetAddr2 (GetAddress ());
+  hdr.SetAddr3 (GetAddress ());
+  hdr.SetDsNotFrom ();
+  hdr.SetDsNotTo ();
+  if (!m_beaconUpToDate
+      || !m_beacon.GetSsid ().IsEqual (GetSsid ())
+      || MicroSeconds (m_beacon.GetBeaconIntervalUs ()) != GetBeaconInterval ()
+      || m_beaconChannelNumber != m_phy->GetChannelNumber ()
+      || m_beaconChannelWidth != m_phy->GetChannelWidth ())
+    {
+      UpdateBeacon ();
+    }
+  //The CF and EDCA parameter sets only depend on attributes which may be
+  //changed at any time, and are cheap to build, so they are always refreshed
+  if (GetPcfSupported ())
+    {
+      m_beacon.SetCfParameterSet (GetCfParameterSet ());
+    }
+  if (GetQosSupported ())
+    {
+      m_beacon.SetEdcaParameterSet (GetEdcaParameterSet ());
+    }
+  //The body is serialized for each beacon, so that the timestamp is current
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (m_beacon);
 
   //The beacon has it's own special queue, so we load it in there
   m_beaconTxop->Queue (packet, hdr);
@@ -900,7 +925,7 @@ ApWifiMac::SendOneBeacon (void)
   //subsequent to the association of the long slot time STA.
   if (GetErpSupported ())
     {
-      if (GetShortSlotTimeEnabled () == true)
+      if (m_beacon.GetCapabilities ().IsShortSlotTime () == true)
         {
           //Enable short slot time
           SetSlot (MicroSeconds (9));
@@ -956,6 +981,7 @@ ApWifiMac::TxOk (const WifiMacHeader &hdr)
     {
       NS_LOG_DEBUG ("associated with sta=" << hdr.GetAddr1 ());
       m_stationManager->RecordGotAssocTxOk (hdr.GetAddr1 ());
+      m_beaconUpToDate = false;
     }
   else if (hdr.IsBeacon () && GetPcfSupported ())
     {
@@ -985,6 +1011,7 @@ ApWifiMac::TxFailed (const WifiMacHeader &hdr)
     {
       NS_LOG_DEBUG ("association failed with sta=" << hdr.GetAddr1 ());
       m_stationManager->RecordGotAssocTxFailed (hdr.GetAddr1 ());
+      m_beaconUpToDate = false;
     }
   else if (hdr.IsCfPoll ())
     {
@@ -1078,6 +1105,9 @@ ApWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
         }
       else if (hdr->GetAddr1 () == GetAddress ())
         {
+          //(re)association and disassociation requests change the state
+          //of the BSS advertised in beacons
+          m_beaconUpToDate = false;
           if (hdr->IsAssocReq ())
             {
               NS_LOG_DEBUG ("Association request received from " << from);
@@ -24,6 +24,7 @@
 #define AP_WIFI_MAC_H
 
 #include "infrastructure-wifi-mac.h"
+#include "mgt-headers.h"
 
 namespace ns3 {
 
@@ -222,8 +223,18 @@ private:
   void SendAssocResp (Mac48Address to, bool success, bool isReassoc);
   /**
    * Forward a beacon packet to the beacon special DCF.
+   *
+   * The beacon body is only rebuilt (see UpdateBeacon) when the BSS
+   * parameters it advertises may have changed, that is, when a station
+   * (re)associates or disassociates, or when the SSID, the beacon interval
+   * or the operating channel changed since the last beacon.
    */
   void SendOneBeacon (void);
+  /**
+   * Rebuild the cached beacon body from the current BSS parameters, except
+   * for the CF and EDCA parameter sets, which are set for every beacon.
+   */
+  void UpdateBeacon (void);
   /**
    * Determine what is the next PCF frame and trigger its transmission.
    */
@@ -329,6 +340,10 @@ private:
   Ptr<Txop> m_beaconTxop;                    //!< Dedicated Txop for beacons
   bool m_enableBeaconGeneration;             //!< Flag whether beacons are being generated
   EventId m_beaconEvent;                     //!< Event to generate one beacon
+  MgtBeaconHeader m_beacon;                  //!< Body of the last beacon
+  bool m_beaconUpToDate;                     //!< Flag whether m_beacon reflects the current state of the BSS
+  uint8_t m_beaconChannelNumber;             //!< Channel number for which m_beacon was built
+  uint16_t m_beaconChannelWidth;             //!< Channel width (MHz) for which m_beacon was built
   EventId m_cfpEvent;                        //!< Event to generate one PCF frame
   Ptr<UniformRandomVariable> m_beaconJitter; //!< UniformRandomVariable used to randomize the time of the first beacon
   bool m_enableBeaconJitter;                 //!< Flag whether the first beacon should be generated at random time
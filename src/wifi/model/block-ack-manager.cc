@@ -40,6 +40,11 @@ BlockAckManager::Item::Item (Ptr<const Packet> packet, const WifiMacHeader &hdr,
   NS_LOG_FUNCTION (this << packet << hdr << tStamp);
 }
 
+BlockAckManager::RetryWindow::RetryWindow ()
+  : count (0)
+{
+}
+
 Bar::Bar ()
 {
   NS_LOG_FUNCTION (this);
@@ -78,6 +83,7 @@ BlockAckManager::~BlockAckManager ()
   m_queue = 0;
   m_agreements.clear ();
   m_retryPackets.clear ();
+  m_retryWindows.clear ();
 }
 
 bool
@@ -160,6 +166,7 @@ BlockAckManager::DestroyAgreement (Mac48Address recipient, uint8_t tid)
               i++;
             }
         }
+      m_retryWindows.erase (std::make_pair (recipient, tid));
       m_agreements.erase (it);
       //remove scheduled bar
       for (std::list<Bar>::const_iterator i = m_bars.begin (); i != m_bars.end (); )
@@ -260,7 +267,7 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr, bool removePacket)
   if (!m_retryPackets.empty ())
     {
       NS_LOG_DEBUG ("Retry buffer size is " << m_retryPackets.size ());
-      std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
+      std::list<PacketQueueI>::iterator it = m_retryPackets.begin ();
       while (it != m_retryPackets.end ())
         {
           if ((*it)->hdr.IsQosData ())
@@ -280,8 +287,9 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr, bool removePacket)
                 {
                   //Standard says the originator should not send a packet with seqnum < winstart
                   NS_LOG_DEBUG ("The Retry packet have sequence number < WinStartO --> Discard " << (*it)->hdr.GetSequenceNumber () << " " << agreement->second.first.GetStartingSequence ());
-                  agreement->second.second.erase ((*it));
-                  it = m_retryPackets.erase (it);
+                  PacketQueueI queueIt = *it;
+                  it = EraseFromRetryQueue (it);
+                  agreement->second.second.erase (queueIt);
                   continue;
                 }
               else if ((*it)->hdr.GetSequenceNumber () > (agreement->second.first.GetStartingSequence () + 63) % 4096)
@@ -301,6 +309,7 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr, bool removePacket)
               NS_FATAL_ERROR ("Packet in blockAck manager retry queue is not Qos Data");
             }
           recipient = hdr.GetAddr1 ();
+          bool normalAck = false;
           if (!agreement->second.first.IsHtSupported ()
               && (ExistsAgreementInState (recipient, tid, OriginatorBlockAckAgreement::ESTABLISHED)
                   || SwitchToBlockAckIfNeeded (recipient, tid, hdr.GetSequenceNumber ())))
@@ -317,16 +326,18 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr, bool removePacket)
                * the use of Block Ack.
                */
               hdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
-              if (removePacket)
-                {
-                  AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
-                  i->second.second.erase (*it);
-                }
+              normalAck = true;
             }
           if (removePacket)
             {
               NS_LOG_INFO ("Retry packet seq = " << hdr.GetSequenceNumber ());
-              it = m_retryPackets.erase (it);
+              PacketQueueI queueIt = *it;
+              it = EraseFromRetryQueue (it);
+              if (normalAck)
+                {
+                  AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
+                  i->second.second.erase (queueIt);
+                }
               NS_LOG_DEBUG ("Removed one packet, retry buffer size = " << m_retryPackets.size ());
             }
           break;
@@ -344,7 +355,7 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, uint8_t tid,
   Mac48Address recipient = hdr.GetAddr1 ();
   AgreementsI agreement = m_agreements.find (std::make_pair (recipient, tid));
   NS_ASSERT (agreement != m_agreements.end ());
-  std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
+  std::list<PacketQueueI>::iterator it = m_retryPackets.begin ();
   for (; it != m_retryPackets.end (); it++)
     {
       if (!(*it)->hdr.IsQosData ())
@@ -357,8 +368,9 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, uint8_t tid,
             {
               //standard says the originator should not send a packet with seqnum < winstart
               NS_LOG_DEBUG ("The Retry packet have sequence number < WinStartO --> Discard " << (*it)->hdr.GetSequenceNumber () << " " << agreement->second.first.GetStartingSequence ());
-              agreement->second.second.erase ((*it));
-              it = m_retryPackets.erase (it);
+              PacketQueueI queueIt = *it;
+              it = EraseFromRetryQueue (it);
+              agreement->second.second.erase (queueIt);
               it--;
               continue;
             }
@@ -398,8 +410,7 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, uint8_t tid,
 bool
 BlockAckManager::RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seqnumber)
 {
-
-  std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
+  std::list<PacketQueueI>::iterator it = m_retryPackets.begin ();
   for (; it != m_retryPackets.end (); it++)
     {
       if (!(*it)->hdr.IsQosData ())
@@ -410,8 +421,9 @@ BlockAckManager::RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seq
         {
           WifiMacHeader hdr = (*it)->hdr;
           AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
-          i->second.second.erase ((*it));
-          m_retryPackets.erase (it);
+          PacketQueueI queueIt = *it;
+          EraseFromRetryQueue (it);
+          i->second.second.erase (queueIt);
           NS_LOG_DEBUG ("Removed Packet from retry queue = " << hdr.GetSequenceNumber () << " " << +tid << " " << recipient << " Buffer Size = " << m_retryPackets.size ());
           return true;
         }
@@ -468,31 +480,14 @@ BlockAckManager::GetNRetryNeededPackets (Mac48Address recipient, uint8_t tid) co
 {
   NS_LOG_FUNCTION (this << recipient << +tid);
   uint32_t nPackets = 0;
-  uint16_t currentSeq = 0;
   if (ExistsAgreement (recipient, tid))
     {
-      std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
-      while (it != m_retryPackets.end ())
+      /* there is at most one packet per sequence number in the retry queue,
+         so fragments are already counted as one packet */
+      RetryWindows::const_iterator window = m_retryWindows.find (std::make_pair (recipient, tid));
+      if (window != m_retryWindows.end ())
         {
-          if (!(*it)->hdr.IsQosData ())
-            {
-              NS_FATAL_ERROR ("Packet in blockAck manager retry queue is not Qos Data");
-            }
-          if ((*it)->hdr.GetAddr1 () == recipient && (*it)->hdr.GetQosTid () == tid)
-            {
-              currentSeq = (*it)->hdr.GetSequenceNumber ();
-              nPackets++;
-              /* a fragmented packet must be counted as one packet */
-              while (it != m_retryPackets.end () && (*it)->hdr.GetSequenceNumber () == currentSeq)
-                {
-                  it++;
-                }
-            }
-          //go to next packet
-          else
-            {
-              it++;
-            }
+          nPackets = window->second.count;
         }
     }
   return nPackets;
@@ -515,21 +510,9 @@ BlockAckManager::SetWifiRemoteStationManager (const Ptr<WifiRemoteStationManager
 bool
 BlockAckManager::AlreadyExists (uint16_t currentSeq, Mac48Address recipient, uint8_t tid) const
 {
-  std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
-  while (it != m_retryPackets.end ())
-    {
-      NS_LOG_FUNCTION (this << (*it)->hdr.GetType ());
-      if (!(*it)->hdr.IsQosData ())
-        {
-          NS_FATAL_ERROR ("Packet in blockAck manager retry queue is not Qos Data");
-        }
-      if ((*it)->hdr.GetAddr1 () == recipient && (*it)->hdr.GetQosTid () == tid && currentSeq == (*it)->hdr.GetSequenceNumber ())
-        {
-          return true;
-        }
-      it++;
-    }
-  return false;
+  NS_LOG_FUNCTION (this << currentSeq << recipient << +tid);
+  RetryWindows::const_iterator window = m_retryWindows.find (std::make_pair (recipient, tid));
+  return window != m_retryWindows.end () && window->second.seqs.test (currentSeq);
 }
 
 void
@@ -808,22 +791,35 @@ void
 BlockAckManager::RemoveFromRetryQueue (Mac48Address address, uint8_t tid, uint16_t seq)
 {
   /* remove retry packet iterator if it's present in retry queue */
-  std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
+  if (!AlreadyExists (seq, address, tid))
+    {
+      return;
+    }
+  std::list<PacketQueueI>::iterator it = m_retryPackets.begin ();
   while (it != m_retryPackets.end ())
     {
       if ((*it)->hdr.GetAddr1 () == address
           && (*it)->hdr.GetQosTid () == tid
           && (*it)->hdr.GetSequenceNumber () == seq)
         {
-          it = m_retryPackets.erase (it);
-        }
-      else
-        {
-          it++;
+          EraseFromRetryQueue (it);
+          return;
         }
+      it++;
     }
 }
 
+std::list<BlockAckManager::PacketQueueI>::iterator
+BlockAckManager::EraseFromRetryQueue (std::list<PacketQueueI>::iterator it)
+{
+  uint16_t seq = (*it)->hdr.GetSequenceNumber ();
+  RetryWindows::iterator window = m_retryWindows.find (std::make_pair ((*it)->hdr.GetAddr1 (), (*it)->hdr.GetQosTid ()));
+  NS_ASSERT (window != m_retryWindows.end () && window->second.seqs.test (seq));
+  window->second.seqs.reset (seq);
+  window->second.count--;
+  return m_retryPackets.erase (it);
+}
+
 void
 BlockAckManager::CleanupBuffers (void)
 {
@@ -894,6 +890,10 @@ uint16_t
 BlockAckManager::GetSeqNumOfNextRetryPacket (Mac48Address recipient, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << recipient << +tid);
+  if (GetNRetryNeededPackets (recipient, tid) == 0)
+    {
+      return 4096;
+    }
   std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
   while (it != m_retryPackets.end ())
     {
@@ -926,6 +926,10 @@ void
 BlockAckManager::InsertInRetryQueue (PacketQueueI item)
 {
   NS_LOG_INFO ("Adding to retry queue " << (*item).hdr.GetSequenceNumber ());
+  RetryWindow &window = m_retryWindows[std::make_pair (item->hdr.GetAddr1 (), item->hdr.GetQosTid ())];
+  NS_ASSERT (!window.seqs.test (item->hdr.GetSequenceNumber ()));
+  window.seqs.set (item->hdr.GetSequenceNumber ());
+  window.count++;
   if (m_retryPackets.size () == 0)
     {
       m_retryPackets.push_back (item);
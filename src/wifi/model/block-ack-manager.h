@@ -22,6 +22,7 @@
 #define BLOCK_ACK_MANAGER_H
 
 #include <map>
+#include <bitset>
 #include "ns3/nstime.h"
 #include "wifi-mac-header.h"
 #include "originator-block-ack-agreement.h"
@@ -475,6 +476,32 @@ private:
    * \param seq sequence number of the packet to be removed
    */
   void RemoveFromRetryQueue (Mac48Address address, uint8_t tid, uint16_t seq);
+  /**
+   * Remove an item from the retransmission queue and from the retry window
+   * of its agreement.
+   *
+   * \param it the item in the retransmission queue
+   * \return the item that followed the erased one
+   */
+  std::list<PacketQueueI>::iterator EraseFromRetryQueue (std::list<PacketQueueI>::iterator it);
+
+  /**
+   * The sequence numbers of the packets of an agreement that are in the
+   * retransmission queue.  A packet is inserted in the retransmission queue
+   * only if no other packet with the same sequence number is there, so this
+   * mirrors the retransmission queue exactly and spares its scans when
+   * packets are acknowledged or counted.
+   */
+  struct RetryWindow
+  {
+    RetryWindow ();
+    std::bitset<4096> seqs; ///< bit set for each sequence number in the retransmission queue
+    uint32_t count;         ///< number of bits set
+  };
+  /**
+   * typedef for a map between an agreement and its retry window.
+   */
+  typedef std::map<std::pair<Mac48Address, uint8_t>, RetryWindow> RetryWindows;
 
   /**
    * This data structure contains, for each block ack agreement (recipient, tid), a set of packets
@@ -490,6 +517,7 @@ private:
    * frame.
    */
   std::list<PacketQueueI> m_retryPackets;
+  RetryWindows m_retryWindows; ///< retry windows of the agreements
   std::list<Bar> m_bars; ///< list of BARs
 
   uint8_t m_blockAckThreshold; ///< block ack threshold
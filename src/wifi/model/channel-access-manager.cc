@@ -118,7 +118,9 @@ ChannelAccessManager::ChannelAccessManager ()
     m_off (false),
     m_slot (Seconds (0.0)),
     m_sifs (Seconds (0.0)),
-    m_phyListener (0)
+    m_phyListener (0),
+    m_nAccessTimeoutSchedules (0),
+    m_nAvoidedReschedules (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -291,6 +293,7 @@ ChannelAccessManager::RequestAccess (Ptr<Txop> state, bool isCfPeriod)
       state->NotifyAccessRequested ();
       Time delay = (MostRecent (GetAccessGrantStart (true), Simulator::Now ()) - Simulator::Now ());
       m_accessTimeout = Simulator::Schedule (delay, &ChannelAccessManager::GrantPcfAccess, this, state);
+      m_accessTimeoutEnd = Simulator::Now () + delay;
       return;
     }
   UpdateBackoff ();
@@ -342,12 +345,13 @@ void
 ChannelAccessManager::DoGrantAccess (void)
 {
   NS_LOG_FUNCTION (this);
+  Time accessGrantStart = GetAccessGrantStart ();
   uint32_t k = 0;
   for (States::iterator i = m_states.begin (); i != m_states.end (); k++)
     {
       Ptr<Txop> state = *i;
       if (state->IsAccessRequested ()
-          && GetBackoffEndFor (state) <= Simulator::Now () )
+          && GetBackoffEndFor (state, accessGrantStart) <= Simulator::Now () )
         {
           /**
            * This is the first dcf we find with an expired backoff and which
@@ -361,7 +365,7 @@ ChannelAccessManager::DoGrantAccess (void)
             {
               Ptr<Txop> otherState = *j;
               if (otherState->IsAccessRequested ()
-                  && GetBackoffEndFor (otherState) <= Simulator::Now ())
+                  && GetBackoffEndFor (otherState, accessGrantStart) <= Simulator::Now ())
                 {
                   NS_LOG_DEBUG ("dcf " << k << " needs access. backoff expired. internal collision. slots=" <<
                                 otherState->GetBackoffSlots ());
@@ -456,34 +460,38 @@ ChannelAccessManager::GetAccessGrantStart (bool ignoreNav) const
 }
 
 Time
-ChannelAccessManager::GetBackoffStartFor (Ptr<Txop> state)
+ChannelAccessManager::GetBackoffStartFor (Ptr<Txop> state, Time accessGrantStart) const
 {
-  NS_LOG_FUNCTION (this << state);
-  Time mostRecentEvent = MostRecent (state->GetBackoffStart (),
-                                     GetAccessGrantStart () + (state->GetAifsn () * m_slot));
-
-  return mostRecentEvent;
+  return MostRecent (state->GetBackoffStart (),
+                     accessGrantStart + (state->GetAifsn () * m_slot));
 }
 
 Time
-ChannelAccessManager::GetBackoffEndFor (Ptr<Txop> state)
+ChannelAccessManager::GetBackoffEndFor (Ptr<Txop> state, Time accessGrantStart) const
 {
-  NS_LOG_FUNCTION (this << state);
-  NS_LOG_DEBUG ("Backoff start: " << GetBackoffStartFor (state).As (Time::US) <<
-                " end: " << (GetBackoffStartFor (state) + state->GetBackoffSlots () * m_slot).As (Time::US));
-  return GetBackoffStartFor (state) + (state->GetBackoffSlots () * m_slot);
+  Time backoffStart = GetBackoffStartFor (state, accessGrantStart);
+  Time backoffEnd = backoffStart + (state->GetBackoffSlots () * m_slot);
+  NS_LOG_DEBUG ("Backoff start: " << backoffStart.As (Time::US) <<
+                " end: " << backoffEnd.As (Time::US));
+  return backoffEnd;
 }
 
 void
 ChannelAccessManager::UpdateBackoff (void)
 {
   NS_LOG_FUNCTION (this);
+  /*
+   * Updating the backoff slots of a Txop does not change the time at which
+   * access can be granted, which is therefore computed once for all the
+   * Txops.
+   */
+  Time accessGrantStart = GetAccessGrantStart ();
   uint32_t k = 0;
   for (States::iterator i = m_states.begin (); i != m_states.end (); i++, k++)
     {
       Ptr<Txop> state = *i;
 
-      Time backoffStart = GetBackoffStartFor (state);
+      Time backoffStart = GetBackoffStartFor (state, accessGrantStart);
       if (backoffStart <= Simulator::Now ())
         {
           uint32_t nIntSlots = (Simulator::Now () - backoffStart) / m_slot;
@@ -519,13 +527,14 @@ ChannelAccessManager::DoRestartAccessTimeoutIfNeeded (void)
    * if there is one, how many slots for AIFS+backoff does it require ?
    */
   bool accessTimeoutNeeded = false;
+  Time accessGrantStart = GetAccessGrantStart ();
   Time expectedBackoffEnd = Simulator::GetMaximumSimulationTime ();
   for (States::iterator i = m_states.begin (); i != m_states.end (); i++)
     {
       Ptr<Txop> state = *i;
       if (state->IsAccessRequested ())
         {
-          Time tmp = GetBackoffEndFor (state);
+          Time tmp = GetBackoffEndFor (state, accessGrantStart);
           if (tmp > Simulator::Now ())
             {
               accessTimeoutNeeded = true;
@@ -537,20 +546,40 @@ ChannelAccessManager::DoRestartAccessTimeoutIfNeeded (void)
   if (accessTimeoutNeeded)
     {
       NS_LOG_DEBUG ("expected backoff end=" << expectedBackoffEnd);
-      Time expectedBackoffDelay = expectedBackoffEnd - Simulator::Now ();
-      if (m_accessTimeout.IsRunning ()
-          && Simulator::GetDelayLeft (m_accessTimeout) > expectedBackoffDelay)
+      if (m_accessTimeout.IsRunning ())
         {
+          /**
+           * A pending access timeout which expires no later than the
+           * earliest backoff end is kept: when it expires, AccessTimeout
+           * grants access or starts a new timeout if the backoff end was
+           * postponed in the meantime.
+           */
+          if (m_accessTimeoutEnd <= expectedBackoffEnd)
+            {
+              m_nAvoidedReschedules++;
+              return;
+            }
           m_accessTimeout.Cancel ();
         }
-      if (m_accessTimeout.IsExpired ())
-        {
-          m_accessTimeout = Simulator::Schedule (expectedBackoffDelay,
-                                                 &ChannelAccessManager::AccessTimeout, this);
-        }
+      m_accessTimeout = Simulator::Schedule (expectedBackoffEnd - Simulator::Now (),
+                                             &ChannelAccessManager::AccessTimeout, this);
+      m_accessTimeoutEnd = expectedBackoffEnd;
+      m_nAccessTimeoutSchedules++;
     }
 }
 
+uint64_t
+ChannelAccessManager::GetNAccessTimeoutSchedules (void) const
+{
+  return m_nAccessTimeoutSchedules;
+}
+
+uint64_t
+ChannelAccessManager::GetNAvoidedReschedules (void) const
+{
+  return m_nAvoidedReschedules;
+}
+
 void
 ChannelAccessManager::NotifyRxStartNow (Time duration)
 {
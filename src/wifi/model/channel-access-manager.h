@@ -219,6 +219,16 @@ public:
    */
   bool IsBusy (void) const;
 
+  /**
+   * \return the number of access timeouts scheduled so far
+   */
+  uint64_t GetNAccessTimeoutSchedules (void) const;
+  /**
+   * \return the number of times a pending access timeout was kept
+   *         instead of being cancelled and scheduled again
+   */
+  uint64_t GetNAvoidedReschedules (void) const;
+
 
 protected:
   // Inherited from ns3::Object
@@ -280,20 +290,27 @@ private:
    * started for the given Txop.
    *
    * \param state
+   * \param accessGrantStart the time returned by GetAccessGrantStart
    *
    * \return the time when the backoff procedure started
    */
-  Time GetBackoffStartFor (Ptr<Txop> state);
+  Time GetBackoffStartFor (Ptr<Txop> state, Time accessGrantStart) const;
   /**
    * Return the time when the backoff procedure
    * ended (or will ended) for the given Txop.
    *
    * \param state
+   * \param accessGrantStart the time returned by GetAccessGrantStart
    *
    * \return the time when the backoff procedure ended (or will ended)
    */
-  Time GetBackoffEndFor (Ptr<Txop> state);
+  Time GetBackoffEndFor (Ptr<Txop> state, Time accessGrantStart) const;
 
+  /**
+   * Schedule an access timeout at the earliest backoff end of the Txops
+   * which requested access, unless an access timeout is already pending
+   * which expires no later than that.
+   */
   void DoRestartAccessTimeoutIfNeeded (void);
 
   /**
@@ -343,9 +360,12 @@ private:
   bool m_off;                   //!< flag whether it is in off state
   Time m_eifsNoDifs;            //!< EIFS no DIFS time
   EventId m_accessTimeout;      //!< the access timeout ID
+  Time m_accessTimeoutEnd;      //!< the expiration time of the access timeout
   Time m_slot;                  //!< the slot time
   Time m_sifs;                  //!< the SIFS time
   PhyListener* m_phyListener;   //!< the phy listener
+  uint64_t m_nAccessTimeoutSchedules; //!< number of access timeouts scheduled
+  uint64_t m_nAvoidedReschedules; //!< number of pending access timeouts kept
 };
 
 } //namespace ns3
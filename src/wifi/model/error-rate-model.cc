@@ -34,9 +34,42 @@ TypeId ErrorRateModel::GetTypeId (void)
   return tid;
 }
 
+bool
+ErrorRateModel::SnrThresholdKey::operator < (const SnrThresholdKey &o) const
+{
+  if (modeUid != o.modeUid)
+    {
+      return modeUid < o.modeUid;
+    }
+  if (channelWidth != o.channelWidth)
+    {
+      return channelWidth < o.channelWidth;
+    }
+  if (guardInterval != o.guardInterval)
+    {
+      return guardInterval < o.guardInterval;
+    }
+  if (nss != o.nss)
+    {
+      return nss < o.nss;
+    }
+  return ber < o.ber;
+}
+
 double
 ErrorRateModel::CalculateSnr (WifiTxVector txVector, double ber) const
 {
+  SnrThresholdKey key;
+  key.modeUid = txVector.GetMode ().GetUid ();
+  key.channelWidth = txVector.GetChannelWidth ();
+  key.guardInterval = txVector.GetGuardInterval ();
+  key.nss = txVector.GetNss ();
+  key.ber = ber;
+  std::map<SnrThresholdKey, double>::const_iterator it = m_snrThresholds.find (key);
+  if (it != m_snrThresholds.end ())
+    {
+      return it->second;
+    }
   //This is a very simple binary search.
   double low, high, precision;
   low = 1e-25;
@@ -55,7 +88,14 @@ ErrorRateModel::CalculateSnr (WifiTxVector txVector, double ber) const
           high = middle;
         }
     }
+  m_snrThresholds.insert (std::make_pair (key, low));
   return low;
 }
 
+void
+ErrorRateModel::ClearSnrThresholds (void)
+{
+  m_snrThresholds.clear ();
+}
+
 } //namespace ns3
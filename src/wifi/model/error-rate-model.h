@@ -21,6 +21,7 @@
 #ifndef ERROR_RATE_MODEL_H
 #define ERROR_RATE_MODEL_H
 
+#include <map>
 #include "ns3/object.h"
 
 namespace ns3 {
@@ -47,6 +48,10 @@ public:
    * \param ber a target ber
    *
    * \return the snr which corresponds to the requested ber
+   *
+   * The results are cached, as rate managers such as IdealWifiManager ask
+   * for the minimum SNR of every mode when they are initialized.  Subclasses
+   * must call ClearSnrThresholds whenever their success rates change.
    */
   double CalculateSnr (WifiTxVector txVector, double ber) const;
 
@@ -74,6 +79,36 @@ public:
    * \return probability of successfully receiving the chunk
    */
   virtual double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const = 0;
+
+
+protected:
+  /**
+   * Discard the SNRs cached by CalculateSnr, when the parameters which
+   * determine the chunk success rates change.
+   */
+  void ClearSnrThresholds (void);
+
+
+private:
+  /**
+   * Inputs of a minimum SNR calculation
+   */
+  struct SnrThresholdKey
+  {
+    uint32_t modeUid;       ///< the UID of the mode
+    uint16_t channelWidth;  ///< the channel width (MHz)
+    uint16_t guardInterval; ///< the guard interval (ns)
+    uint8_t nss;            ///< the number of spatial streams
+    double ber;             ///< the bit error rate
+
+    /**
+     * \param o the other key
+     * \return true if this key is lower than the other one
+     */
+    bool operator < (const SnrThresholdKey &o) const;
+  };
+
+  mutable std::map<SnrThresholdKey, double> m_snrThresholds; //!< minimum SNRs already calculated
 };
 
 } //namespace ns3
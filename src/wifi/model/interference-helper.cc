@@ -19,6 +19,7 @@
  *          Sébastien Deronne <sebastien.deronne@gmail.com>
  */
 
+#include <algorithm>
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
@@ -30,6 +31,38 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("InterferenceHelper");
 
+namespace {
+
+/**
+ * Order NiChanges and times by time, for the binary searches
+ * in the list of NiChanges.
+ */
+struct NiChangeTimeLess
+{
+  /**
+   * \param moment the time
+   * \param change the NiChange
+   * \return true if moment is earlier than the time of change
+   */
+  template <typename T>
+  bool operator () (const Time &moment, const T &change) const
+  {
+    return moment < change.first;
+  }
+  /**
+   * \param change the NiChange
+   * \param moment the time
+   * \return true if the time of change is earlier than moment
+   */
+  template <typename T>
+  bool operator () (const T &change, const Time &moment) const
+  {
+    return change.first < moment;
+  }
+};
+
+} //unnamed namespace
+
 /****************************************************************
  *       Phy event class
  ****************************************************************/
@@ -138,18 +171,27 @@ Ptr<Event>
 InterferenceHelper::Add (Ptr<const Packet> packet, WifiTxVector txVector, Time duration, double rxPowerW)
 {
   Ptr<Event> event = Create<Event> (packet, txVector, duration, rxPowerW);
-  AppendEvent (event);
+  Add (event);
   return event;
 }
 
+void
+InterferenceHelper::Add (Ptr<Event> event)
+{
+  AppendSignal (event->GetStartTime (), event->GetEndTime (), event->GetRxPowerW (), event);
+}
+
+void
+InterferenceHelper::AddInterference (Time duration, double rxPowerW)
+{
+  Time now = Simulator::Now ();
+  AppendSignal (now, now + duration, rxPowerW, 0);
+}
+
 void
 InterferenceHelper::AddForeignSignal (Time duration, double rxPowerW)
 {
-  // Parameters other than duration and rxPowerW are unused for this type
-  // of signal, so we provide dummy versions
-  WifiTxVector fakeTxVector;
-  Ptr<const Packet> packet (0);
-  Add (packet, fakeTxVector, duration, rxPowerW);
+  AddInterference (duration, rxPowerW);
 }
 
 void
@@ -195,26 +237,28 @@ InterferenceHelper::GetEnergyDuration (double energyW) const
 }
 
 void
-InterferenceHelper::AppendEvent (Ptr<Event> event)
+InterferenceHelper::AppendSignal (Time startTime, Time endTime, double rxPowerW, Ptr<Event> event)
 {
   NS_LOG_FUNCTION (this);
   double previousPowerStart = 0;
   double previousPowerEnd = 0;
-  previousPowerStart = GetPreviousPosition (event->GetStartTime ())->second.GetPower ();
-  previousPowerEnd = GetPreviousPosition (event->GetEndTime ())->second.GetPower ();
+  previousPowerStart = GetPreviousPosition (startTime)->second.GetPower ();
+  previousPowerEnd = GetPreviousPosition (endTime)->second.GetPower ();
 
   if (!m_rxing)
     {
       m_firstPower = previousPowerStart;
       // Always leave the first zero power noise event in the list
       m_niChanges.erase (++(m_niChanges.begin ()),
-                         GetNextPosition (event->GetStartTime ()));
+                         GetNextPosition (startTime));
     }
-  auto first = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event));
-  auto last = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event));
-  for (auto i = first; i != last; ++i)
+  auto first = AddNiChangeEvent (startTime, NiChange (previousPowerStart, event));
+  //the end is inserted after the start, so the start keeps its index
+  NiChanges::difference_type firstIndex = first - m_niChanges.begin ();
+  auto last = AddNiChangeEvent (endTime, NiChange (previousPowerEnd, event));
+  for (auto i = m_niChanges.begin () + firstIndex; i != last; ++i)
     {
-      i->second.AddPower (event->GetRxPowerW ());
+      i->second.AddPower (rxPowerW);
     }
 }
 
@@ -237,20 +281,39 @@ double
 InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const
 {
   double noiseInterference = m_firstPower;
-  auto it = m_niChanges.find (event->GetStartTime ());
+  auto it = GetFirstPosition (event->GetStartTime ());
   for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it)
     {
       noiseInterference = it->second.GetPower ();
     }
-  ni->emplace (event->GetStartTime (), NiChange (0, event));
+  ni->emplace_back (event->GetStartTime (), NiChange (0, event));
   while (++it != m_niChanges.end () && it->second.GetEvent () != event)
     {
-      ni->insert (*it);
+      ni->push_back (*it);
     }
-  ni->emplace (event->GetEndTime (), NiChange (0, event));
+  ni->emplace_back (event->GetEndTime (), NiChange (0, event));
   return noiseInterference;
 }
 
+double
+InterferenceHelper::CalculatePeakNoiseInterferenceW (Ptr<Event> event) const
+{
+  auto it = GetFirstPosition (event->GetStartTime ());
+  while (it != m_niChanges.end () && it->second.GetEvent () != event)
+    {
+      ++it;
+    }
+  NS_ASSERT (it != m_niChanges.end ());
+  //the power of the changes between the start and the end of the event includes the event
+  double powerW = event->GetRxPowerW ();
+  double peakW = it->second.GetPower () - powerW;
+  while (++it != m_niChanges.end () && it->second.GetEvent () != event)
+    {
+      peakW = std::max (peakW, it->second.GetPower () - powerW);
+    }
+  return std::max (peakW, 0.0);
+}
+
 double
 InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiMode mode, WifiTxVector txVector) const
 {
@@ -776,6 +839,60 @@ InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<Event> event) const
   return snrPer;
 }
 
+struct InterferenceHelper::SnrPer
+InterferenceHelper::CalculateEffectivePlcpPayloadSnrPer (Ptr<Event> event) const
+{
+  const WifiTxVector txVector = event->GetTxVector ();
+  double snr = CalculateSnr (event->GetRxPowerW (),
+                             CalculatePeakNoiseInterferenceW (event),
+                             txVector.GetChannelWidth ());
+  Time plcpPayloadStart = event->GetStartTime () + WifiPhy::CalculatePlcpPreambleAndHeaderDuration (txVector);
+
+  struct SnrPer snrPer;
+  snrPer.snr = snr;
+  snrPer.per = 1 - CalculateChunkSuccessRate (snr, event->GetEndTime () - plcpPayloadStart,
+                                              event->GetPayloadMode (), txVector);
+  return snrPer;
+}
+
+struct InterferenceHelper::SnrPer
+InterferenceHelper::CalculateEffectivePlcpHeaderSnrPer (Ptr<Event> event) const
+{
+  const WifiTxVector txVector = event->GetTxVector ();
+  double snr = CalculateSnr (event->GetRxPowerW (),
+                             CalculatePeakNoiseInterferenceW (event),
+                             txVector.GetChannelWidth ());
+  WifiPreamble preamble = txVector.GetPreambleType ();
+  WifiMode headerMode = WifiPhy::GetPlcpHeaderMode (txVector);
+  Time plcpHeaderStart = event->GetStartTime () + WifiPhy::GetPlcpPreambleDuration (txVector);
+  Time plcpHsigHeaderStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (txVector);
+  Time plcpTrainingSymbolsStart = plcpHsigHeaderStart + WifiPhy::GetPlcpHtSigHeaderDuration (preamble) + WifiPhy::GetPlcpSigA1Duration (preamble) + WifiPhy::GetPlcpSigA2Duration (preamble);
+  Time plcpPayloadStart = plcpTrainingSymbolsStart + WifiPhy::GetPlcpTrainingSymbolDuration (txVector) + WifiPhy::GetPlcpSigBDuration (preamble);
+
+  //same split between legacy and MCS header modes as CalculatePlcpHeaderPer
+  double psr;
+  if (preamble == WIFI_PREAMBLE_LONG || preamble == WIFI_PREAMBLE_SHORT)
+    {
+      psr = CalculateChunkSuccessRate (snr, plcpPayloadStart - plcpHeaderStart, headerMode, txVector);
+    }
+  else if (preamble == WIFI_PREAMBLE_VHT || preamble == WIFI_PREAMBLE_HE_SU)
+    {
+      WifiMode mcsHeaderMode = (preamble == WIFI_PREAMBLE_VHT) ? WifiPhy::GetVhtPlcpHeaderMode () : WifiPhy::GetHePlcpHeaderMode ();
+      psr = CalculateChunkSuccessRate (snr, plcpTrainingSymbolsStart - plcpHeaderStart, headerMode, txVector)
+        * CalculateChunkSuccessRate (snr, plcpPayloadStart - plcpTrainingSymbolsStart, mcsHeaderMode, txVector);
+    }
+  else
+    {
+      psr = CalculateChunkSuccessRate (snr, plcpHsigHeaderStart - plcpHeaderStart, headerMode, txVector)
+        * CalculateChunkSuccessRate (snr, plcpPayloadStart - plcpHsigHeaderStart, WifiPhy::GetHtPlcpHeaderMode (), txVector);
+    }
+
+  struct SnrPer snrPer;
+  snrPer.snr = snr;
+  snrPer.per = 1 - psr;
+  return snrPer;
+}
+
 void
 InterferenceHelper::EraseEvents (void)
 {
@@ -789,7 +906,13 @@ InterferenceHelper::EraseEvents (void)
 InterferenceHelper::NiChanges::const_iterator
 InterferenceHelper::GetNextPosition (Time moment) const
 {
-  return m_niChanges.upper_bound (moment);
+  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), moment, NiChangeTimeLess ());
+}
+
+InterferenceHelper::NiChanges::const_iterator
+InterferenceHelper::GetFirstPosition (Time moment) const
+{
+  return std::lower_bound (m_niChanges.begin (), m_niChanges.end (), moment, NiChangeTimeLess ());
 }
 
 InterferenceHelper::NiChanges::const_iterator
@@ -805,6 +928,11 @@ InterferenceHelper::GetPreviousPosition (Time moment) const
 InterferenceHelper::NiChanges::iterator
 InterferenceHelper::AddNiChangeEvent (Time moment, NiChange change)
 {
+  if (m_niChanges.empty () || m_niChanges.back ().first <= moment)
+    {
+      m_niChanges.emplace_back (moment, change);
+      return --m_niChanges.end ();
+    }
   return m_niChanges.insert (GetNextPosition (moment), std::make_pair (moment, change));
 }
 
@@ -821,7 +949,7 @@ InterferenceHelper::NotifyRxEnd ()
   NS_LOG_FUNCTION (this);
   m_rxing = false;
   //Update m_firstPower for frame capture
-  auto it = m_niChanges.find (Simulator::Now ());
+  auto it = GetFirstPosition (Simulator::Now ());
   it--;
   m_firstPower = it->second.GetPower ();
 }
@@ -23,7 +23,7 @@
 
 #include "ns3/nstime.h"
 #include "wifi-tx-vector.h"
-#include <map>
+#include <deque>
 
 namespace ns3 {
 
@@ -164,6 +164,21 @@ public:
    * \return Event
    */
   Ptr<Event> Add (Ptr<const Packet> packet, WifiTxVector txVector, Time duration, double rxPower);
+  /**
+   * Add the signal of an event created by the caller to interference helper.
+   *
+   * \param event the event
+   */
+  void Add (Ptr<Event> event);
+  /**
+   * Add a signal that will not be received to interference helper.  Only
+   * its power is recorded: no Event is created and no reference to the
+   * packet is kept.
+   *
+   * \param duration the duration of the signal
+   * \param rxPower receive power (W)
+   */
+  void AddInterference (Time duration, double rxPower);
 
   /**
    * Add a non-Wifi signal to interference helper.
@@ -189,6 +204,26 @@ public:
    * \return struct of SNR and PER
    */
   struct InterferenceHelper::SnrPer CalculatePlcpHeaderSnrPer (Ptr<Event> event) const;
+  /**
+   * Calculate the effective SNIR of the event, i.e. the SNIR at the peak of
+   * the noise and interference power over the whole event, and the PER of
+   * the plcp payload as a single chunk at that SNIR.  This is cheaper than,
+   * and never more optimistic than, CalculatePlcpPayloadSnrPer.
+   *
+   * \param event the event corresponding to the first time the corresponding packet arrives
+   *
+   * \return struct of SNR and PER
+   */
+  struct InterferenceHelper::SnrPer CalculateEffectivePlcpPayloadSnrPer (Ptr<Event> event) const;
+  /**
+   * Calculate the effective SNIR of the event and the PER of the plcp
+   * header at that SNIR, with one chunk per header modulation.
+   *
+   * \param event the event corresponding to the first time the corresponding packet arrives
+   *
+   * \return struct of SNR and PER
+   */
+  struct InterferenceHelper::SnrPer CalculateEffectivePlcpHeaderSnrPer (Ptr<Event> event) const;
 
   /**
    * Notify that RX has started.
@@ -244,16 +279,22 @@ private:
   };
 
   /**
-   * typedef for a multimap of NiChanges
+   * typedef for a list of NiChanges sorted by time.  NiChanges with the same
+   * time are kept in insertion order.  Since signals mostly arrive in time
+   * order, new NiChanges are usually appended at the back, and the ones that
+   * are no longer needed are trimmed from the front.
    */
-  typedef std::multimap<Time, NiChange> NiChanges;
+  typedef std::deque<std::pair<Time, NiChange> > NiChanges;
 
   /**
-   * Append the given Event.
+   * Append a signal to the list of NiChanges.
    *
-   * \param event
+   * \param startTime the start time of the signal
+   * \param endTime the end time of the signal
+   * \param rxPowerW the receive power of the signal (W)
+   * \param event the event of the signal, or 0 if it is only interference
    */
-  void AppendEvent (Ptr<Event> event);
+  void AppendSignal (Time startTime, Time endTime, double rxPowerW, Ptr<Event> event);
   /**
    * Calculate noise and interference power in W.
    *
@@ -263,6 +304,15 @@ private:
    * \return noise and interference power
    */
   double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  /**
+   * Return the peak noise and interference power over the duration of the
+   * event, excluding the event itself.
+   *
+   * \param event the event
+   *
+   * \return the peak noise and interference power (W)
+   */
+  double CalculatePeakNoiseInterferenceW (Ptr<Event> event) const;
   /**
    * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
    * (Mode is not currently used)
@@ -322,6 +372,13 @@ private:
    * \returns an iterator to the list of NiChanges
    */
   NiChanges::const_iterator GetNextPosition (Time moment) const;
+  /**
+   * Returns an iterator to the first nichange that is not earlier than moment
+   *
+   * \param moment time to check from
+   * \returns an iterator to the list of NiChanges
+   */
+  NiChanges::const_iterator GetFirstPosition (Time moment) const;
   /**
    * Returns an iterator to the first nichange that is later than moment
    *
@@ -127,10 +127,6 @@ MacLow::MacLow ()
     m_cfAckInfo ()
 {
   NS_LOG_FUNCTION (this);
-  for (uint8_t i = 0; i < 8; i++)
-    {
-      m_aggregateQueue[i] = CreateObject<WifiMacQueue> ();
-    }
 }
 
 MacLow::~MacLow ()
@@ -530,7 +526,7 @@ MacLow::StartTransmission (Ptr<const Packet> packet,
       //queue when previous RTS request has failed.
       m_ampdu = false;
     }
-  else if (m_currentHdr.IsQosData () && !m_aggregateQueue[GetTid (packet, *hdr)]->IsEmpty ())
+  else if (m_currentHdr.IsQosData () && !IsAggregateQueueEmpty (GetTid (packet, *hdr)))
     {
       //m_aggregateQueue > 0 occurs when a RTS/CTS exchange failed before an A-MPDU transmission.
       //In that case, we transmit the same A-MPDU as previously.
@@ -545,15 +541,13 @@ MacLow::StartTransmission (Ptr<const Packet> packet,
           //VHT/HE single MPDUs are followed by normal ACKs
           m_txParams.EnableAck ();
         }
-      AcIndex ac = QosUtilsMapTidToAc (GetTid (packet, *hdr));
-      std::map<AcIndex, Ptr<QosTxop> >::const_iterator edcaIt = m_edca.find (ac);
       Ptr<Packet> aggregatedPacket = Create<Packet> ();
       for (uint32_t i = 0; i < sentMpdus; i++)
         {
-          Ptr<Packet> newPacket = (m_txPackets[GetTid (packet, *hdr)].at (i).packet)->Copy ();
-          newPacket->AddHeader (m_txPackets[GetTid (packet, *hdr)].at (i).hdr);
-          AddWifiMacTrailer (newPacket);
-          edcaIt->second->GetMpduAggregator ()->Aggregate (newPacket, aggregatedPacket);
+          const Item &item = m_txPackets[GetTid (packet, *hdr)].at (i);
+          uint32_t mpduSize = item.packet->GetSize () + item.hdr.GetSize () + WIFI_MAC_FCS_LENGTH;
+          uint32_t ampduSize = MpduAggregator::GetSizeIfAggregated (mpduSize, aggregatedPacket->GetSize ());
+          aggregatedPacket->AddAtEnd (Create<Packet> (ampduSize - aggregatedPacket->GetSize ()));
         }
       m_currentPacket = aggregatedPacket;
       m_currentHdr = (m_txPackets[GetTid (packet, *hdr)].at (0).hdr);
@@ -693,6 +687,11 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiTxVector txVector, bool
    * we handle any packet present in the
    * packet queue.
    */
+  if (!ampduSubframe && !m_promisc && !m_cfAckInfo.expectCfAck
+      && NotifyNavIfNotForMe (packet, 0))
+    {
+      return;
+    }
   WifiMacHeader hdr;
   packet->RemoveHeader (hdr);
 
@@ -1270,6 +1269,40 @@ MacLow::NotifyNav (Ptr<const Packet> packet, const WifiMacHeader &hdr)
     }
 }
 
+bool
+MacLow::NotifyNavIfNotForMe (Ptr<const Packet> packet, uint32_t offset)
+{
+  //Frame Control (2 bytes), Duration/ID (2 bytes) and Address 1 (6 bytes)
+  uint8_t buffer[16];
+  NS_ASSERT (offset + 10 <= sizeof (buffer));
+  if (packet->CopyData (buffer, offset + 10) < offset + 10)
+    {
+      return false;
+    }
+  uint8_t *fields = buffer + offset;
+  uint8_t type = (fields[0] >> 2) & 0x03;
+  if (type != 0 && type != 2)
+    {
+      //neither a management nor a data frame
+      return false;
+    }
+  Mac48Address addr1;
+  addr1.CopyFrom (fields + 4);
+  if (addr1 == m_self || addr1.IsGroup ())
+    {
+      return false;
+    }
+  NS_ASSERT (m_lastNavStart <= Simulator::Now ());
+  uint16_t duration = fields[2] | (fields[3] << 8);
+  if (duration <= 32767)
+    {
+      // see section 9.2.5.4 802.11-1999
+      DoNavStartNow (MicroSeconds (duration));
+    }
+  NS_LOG_DEBUG ("rx not for me to=" << addr1);
+  return true;
+}
+
 void
 MacLow::NavCounterResetCtsMissed (Time rtsEndRxTime)
 {
@@ -1388,7 +1421,7 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr, WifiTxV
       Ptr<Packet> newPacket;
       Ptr <WifiMacQueueItem> dequeuedItem;
       WifiMacHeader newHdr;
-      uint32_t queueSize = m_aggregateQueue[GetTid (packet, *hdr)]->GetNPackets ();
+      uint32_t queueSize = GetAggregateQueue (GetTid (packet, *hdr))->GetNPackets ();
       bool singleMpdu = false;
       bool last = false;
       MpduType mpdutype = NORMAL_MPDU;
@@ -1412,7 +1445,7 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr, WifiTxV
         }
       for (; queueSize > 0; queueSize--)
         {
-          dequeuedItem = m_aggregateQueue[GetTid (packet, *hdr)]->Dequeue ();
+          dequeuedItem = GetAggregateQueue (GetTid (packet, *hdr))->Dequeue ();
           newHdr = dequeuedItem->GetHeader ();
           newPacket = dequeuedItem->GetPacket ()->Copy ();
           newHdr.SetDuration (hdr->GetDuration ());
@@ -1899,7 +1932,7 @@ MacLow::SendDataAfterCts (Time duration)
   if (m_currentHdr.IsQosData ())
     {
       uint8_t tid = GetTid (m_currentPacket, m_currentHdr);
-      if (!m_aggregateQueue[GetTid (m_currentPacket, m_currentHdr)]->IsEmpty ())
+      if (!IsAggregateQueueEmpty (tid))
         {
           for (std::vector<Item>::size_type i = 0; i != m_txPackets[tid].size (); i++)
             {
@@ -2448,6 +2481,11 @@ MacLow::DeaggregateAmpduAndReceive (Ptr<Packet> aggregatedPacket, double rxSnr,
   if (aggregatedPacket->RemovePacketTag (ampdu))
     {
       ampduSubframe = true;
+      AmpduSubframeHeader subframeHdr;
+      if (NotifyNavIfNotForMe (aggregatedPacket, subframeHdr.GetSerializedSize ()))
+        {
+          return;
+        }
       MpduAggregator::DeaggregatedMpdus packets = MpduAggregator::Deaggregate (aggregatedPacket);
       MpduAggregator::DeaggregatedMpdusCI n = packets.begin ();
 
@@ -2619,16 +2657,19 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                       peekedHdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
                     }
                   currentSequenceNumber = peekedHdr.GetSequenceNumber ();
-                  newPacket->AddHeader (peekedHdr);
-                  AddWifiMacTrailer (newPacket);
+                  //the MPDUs are only serialized when they are passed to the PHY: until
+                  //then, currentAggregatedPacket only accounts for the size of the A-MPDU
+                  uint32_t mpduSize = newPacket->GetSize () + peekedHdr.GetSize () + WIFI_MAC_FCS_LENGTH;
+                  uint32_t ampduSize = MpduAggregator::GetSizeIfAggregated (mpduSize, currentAggregatedPacket->GetSize ());
 
-                  aggregated = edcaIt->second->GetMpduAggregator ()->Aggregate (newPacket, currentAggregatedPacket);
+                  aggregated = (ampduSize <= edcaIt->second->GetMpduAggregator ()->GetMaxAmpduSize ());
 
                   if (aggregated)
                     {
-                      NS_LOG_DEBUG ("Adding packet with sequence number " << currentSequenceNumber << " to A-MPDU, packet size = " << newPacket->GetSize () << ", A-MPDU size = " << currentAggregatedPacket->GetSize ());
+                      currentAggregatedPacket->AddAtEnd (Create<Packet> (ampduSize - currentAggregatedPacket->GetSize ()));
+                      NS_LOG_DEBUG ("Adding packet with sequence number " << currentSequenceNumber << " to A-MPDU, packet size = " << mpduSize << ", A-MPDU size = " << currentAggregatedPacket->GetSize ());
                       i++;
-                      m_aggregateQueue[tid]->Enqueue (Create<WifiMacQueueItem> (aggPacket, peekedHdr));
+                      GetAggregateQueue (tid)->Enqueue (Create<WifiMacQueueItem> (aggPacket, peekedHdr));
                     }
                 }
               else if (hdr.IsBlockAckReq ())
@@ -2690,15 +2731,14 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                       peekedHdr.SetQosAckPolicy (WifiMacHeader::BLOCK_ACK);
                     }
 
-                  newPacket = peekedPacket->Copy ();
-                  aggPacket = newPacket->Copy ();
-
-                  newPacket->AddHeader (peekedHdr);
-                  AddWifiMacTrailer (newPacket);
-                  aggregated = edcaIt->second->GetMpduAggregator ()->Aggregate (newPacket, currentAggregatedPacket);
+                  aggPacket = peekedPacket->Copy ();
+                  uint32_t mpduSize = aggPacket->GetSize () + peekedHdr.GetSize () + WIFI_MAC_FCS_LENGTH;
+                  uint32_t ampduSize = MpduAggregator::GetSizeIfAggregated (mpduSize, currentAggregatedPacket->GetSize ());
+                  aggregated = (ampduSize <= edcaIt->second->GetMpduAggregator ()->GetMaxAmpduSize ());
                   if (aggregated)
                     {
-                      m_aggregateQueue[tid]->Enqueue (Create<WifiMacQueueItem> (aggPacket, peekedHdr));
+                      currentAggregatedPacket->AddAtEnd (Create<Packet> (ampduSize - currentAggregatedPacket->GetSize ()));
+                      GetAggregateQueue (tid)->Enqueue (Create<WifiMacQueueItem> (aggPacket, peekedHdr));
                       if (i == 1 && hdr.IsQosData ())
                         {
                           if (!m_txParams.MustSendRts ())
@@ -2710,7 +2750,7 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                               InsertInTxQueue (packet, hdr, tstamp, tid);
                             }
                         }
-                      NS_LOG_DEBUG ("Adding packet with sequence number " << peekedHdr.GetSequenceNumber () << " to A-MPDU, packet size = " << newPacket->GetSize () << ", A-MPDU size = " << currentAggregatedPacket->GetSize ());
+                      NS_LOG_DEBUG ("Adding packet with sequence number " << peekedHdr.GetSequenceNumber () << " to A-MPDU, packet size = " << mpduSize << ", A-MPDU size = " << currentAggregatedPacket->GetSize ());
                       i++;
                       isAmpdu = true;
                       if (!m_txParams.MustSendRts ())
@@ -2802,7 +2842,7 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                       newPacket = packet->Copy ();
                       peekedHdr = hdr;
                       aggPacket = newPacket->Copy ();
-                      m_aggregateQueue[tid]->Enqueue (Create<WifiMacQueueItem> (aggPacket, peekedHdr));
+                      GetAggregateQueue (tid)->Enqueue (Create<WifiMacQueueItem> (aggPacket, peekedHdr));
                       newPacket->AddHeader (peekedHdr);
                       AddWifiMacTrailer (newPacket);
                       edcaIt->second->GetMpduAggregator ()->Aggregate (newPacket, currentAggregatedPacket);
@@ -2825,7 +2865,7 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                 }
               else
                 {
-                  uint32_t queueSize = m_aggregateQueue[tid]->GetNPackets ();
+                  uint32_t queueSize = GetAggregateQueue (tid)->GetNPackets ();
                   NS_ASSERT (queueSize <= 2); //since it is not an A-MPDU then only 2 packets should have been added to the queue no more
                   if (queueSize >= 1)
                     {
@@ -2846,7 +2886,7 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
 
               currentAggregatedPacket = Create<Packet> ();
               edcaIt->second->GetMpduAggregator ()->AggregateSingleMpdu (packet, currentAggregatedPacket);
-              m_aggregateQueue[tid]->Enqueue (Create<WifiMacQueueItem> (packet, peekedHdr));
+              GetAggregateQueue (tid)->Enqueue (Create<WifiMacQueueItem> (packet, peekedHdr));
               if (m_txParams.MustSendRts ())
                 {
                   InsertInTxQueue (packet, peekedHdr, tstamp, tid);
@@ -2871,10 +2911,26 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
   return newPacket;
 }
 
+Ptr<WifiMacQueue>
+MacLow::GetAggregateQueue (uint8_t tid)
+{
+  if (m_aggregateQueue[tid] == 0)
+    {
+      m_aggregateQueue[tid] = CreateObject<WifiMacQueue> ();
+    }
+  return m_aggregateQueue[tid];
+}
+
+bool
+MacLow::IsAggregateQueueEmpty (uint8_t tid) const
+{
+  return m_aggregateQueue[tid] == 0 || m_aggregateQueue[tid]->IsEmpty ();
+}
+
 void
 MacLow::FlushAggregateQueue (uint8_t tid)
 {
-  if (!m_aggregateQueue[tid]->IsEmpty ())
+  if (!IsAggregateQueueEmpty (tid))
     {
       NS_LOG_DEBUG ("Flush aggregate queue");
       m_aggregateQueue[tid]->Flush ();
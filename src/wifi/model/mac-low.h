@@ -37,6 +37,7 @@
 
 class TwoLevelAggregationTest;
 class AmpduAggregationTest;
+class MacLowNavTest;
 
 namespace ns3 {
 
@@ -62,6 +63,8 @@ public:
   friend class ::TwoLevelAggregationTest;
   /// Allow test cases to access private members
   friend class ::AmpduAggregationTest;
+  /// Allow test cases to access private members
+  friend class ::MacLowNavTest;
   /**
    * typedef for a callback for MacLowRx
    */
@@ -452,6 +455,21 @@ public:
 
 
 private:
+  /**
+   * Return the queue used for MPDU aggregation for the given TID.  The
+   * queues are only created when they are first needed, as most stations
+   * never aggregate MPDUs, or only for a few TIDs.
+   *
+   * \param tid the Traffic ID
+   * \return the aggregation queue for the given TID
+   */
+  Ptr<WifiMacQueue> GetAggregateQueue (uint8_t tid);
+  /**
+   * \param tid the Traffic ID
+   * \return true if the aggregation queue for the given TID has not been
+   *         created yet or is empty, false otherwise
+   */
+  bool IsAggregateQueueEmpty (uint8_t tid) const;
   /**
    * Cancel all scheduled events. Called before beginning a transmission
    * or switching channel.
@@ -607,6 +625,18 @@ private:
    * \param hdr the header
    */
   void NotifyNav (Ptr<const Packet> packet,const WifiMacHeader &hdr);
+  /**
+   * Peek at the Frame Control, Duration and Address 1 fields of a received
+   * frame, without deserializing its MAC header. If the frame is a data or
+   * management frame addressed to another station, update the NAV as
+   * NotifyNav would: nothing else has to be done for this frame.
+   *
+   * \param packet the packet
+   * \param offset the position of the MAC header in the packet
+   * \return true if the frame is a data or management frame addressed to
+   *         another station, false otherwise
+   */
+  bool NotifyNavIfNotForMe (Ptr<const Packet> packet, uint32_t offset);
   /**
    * Reset NAV with the given duration.
    *
@@ -233,8 +233,8 @@ MinstrelHtWifiManager::DoInitialize ()
                         {
                           uint16_t deviceIndex = i + (m_minstrelGroups[groupId].streams - 1) * 8;
                           WifiMode mode =  htMcsList[deviceIndex];
-                          AddFirstMpduTxTime (groupId, mode, CalculateFirstMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
-                          AddMpduTxTime (groupId, mode, CalculateMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
+                          AddFirstMpduTxTime (groupId, i, CalculateFirstMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
+                          AddMpduTxTime (groupId, i, CalculateMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
                         }
                       NS_LOG_DEBUG ("Initialized group " << +groupId << ": (" << +streams << "," << +sgi << "," << chWidth << ")");
                     }
@@ -274,8 +274,8 @@ MinstrelHtWifiManager::DoInitialize ()
                               // Check for invalid VHT MCSs and do not add time to array.
                               if (IsValidMcs (GetPhy (), streams, chWidth, mode))
                                 {
-                                  AddFirstMpduTxTime (groupId, mode, CalculateFirstMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
-                                  AddMpduTxTime (groupId, mode, CalculateMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
+                                  AddFirstMpduTxTime (groupId, i, CalculateFirstMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
+                                  AddMpduTxTime (groupId, i, CalculateMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
                                 }
                             }
                           NS_LOG_DEBUG ("Initialized group " << +groupId << ": (" << +streams << "," << +sgi << "," << chWidth << ")");
@@ -337,35 +337,45 @@ MinstrelHtWifiManager::CalculateMpduTxDuration (Ptr<WifiPhy> phy, uint8_t stream
 }
 
 Time
-MinstrelHtWifiManager::GetFirstMpduTxTime (uint8_t groupId, WifiMode mode) const
+MinstrelHtWifiManager::GetFirstMpduTxTime (uint8_t groupId, uint8_t rateId) const
 {
-  NS_LOG_FUNCTION (this << +groupId << mode);
-  auto it = m_minstrelGroups[groupId].ratesFirstMpduTxTimeTable.find (mode);
-  NS_ASSERT (it != m_minstrelGroups[groupId].ratesFirstMpduTxTimeTable.end ());
-  return it->second;
+  NS_LOG_FUNCTION (this << +groupId << +rateId);
+  NS_ASSERT (rateId < m_minstrelGroups[groupId].ratesFirstMpduTxTimeTable.size ());
+  NS_ASSERT (!m_minstrelGroups[groupId].ratesFirstMpduTxTimeTable[rateId].IsZero ());
+  return m_minstrelGroups[groupId].ratesFirstMpduTxTimeTable[rateId];
 }
 
 void
-MinstrelHtWifiManager::AddFirstMpduTxTime (uint8_t groupId, WifiMode mode, Time t)
+MinstrelHtWifiManager::AddFirstMpduTxTime (uint8_t groupId, uint8_t rateId, Time t)
 {
-  NS_LOG_FUNCTION (this << +groupId << mode << t);
-  m_minstrelGroups[groupId].ratesFirstMpduTxTimeTable.insert (std::make_pair (mode, t));
+  NS_LOG_FUNCTION (this << +groupId << +rateId << t);
+  TxTimeTable &table = m_minstrelGroups[groupId].ratesFirstMpduTxTimeTable;
+  if (table.size () <= rateId)
+    {
+      table.resize (m_numRates);
+    }
+  table[rateId] = t;
 }
 
 Time
-MinstrelHtWifiManager::GetMpduTxTime (uint8_t groupId, WifiMode mode) const
+MinstrelHtWifiManager::GetMpduTxTime (uint8_t groupId, uint8_t rateId) const
 {
-  NS_LOG_FUNCTION (this << +groupId << mode);
-  auto it = m_minstrelGroups[groupId].ratesTxTimeTable.find (mode);
-  NS_ASSERT (it != m_minstrelGroups[groupId].ratesTxTimeTable.end ());
-  return it->second;
+  NS_LOG_FUNCTION (this << +groupId << +rateId);
+  NS_ASSERT (rateId < m_minstrelGroups[groupId].ratesTxTimeTable.size ());
+  NS_ASSERT (!m_minstrelGroups[groupId].ratesTxTimeTable[rateId].IsZero ());
+  return m_minstrelGroups[groupId].ratesTxTimeTable[rateId];
 }
 
 void
-MinstrelHtWifiManager::AddMpduTxTime (uint8_t groupId, WifiMode mode, Time t)
+MinstrelHtWifiManager::AddMpduTxTime (uint8_t groupId, uint8_t rateId, Time t)
 {
-  NS_LOG_FUNCTION (this << +groupId << mode << t);
-  m_minstrelGroups[groupId].ratesTxTimeTable.insert (std::make_pair (mode, t));
+  NS_LOG_FUNCTION (this << +groupId << +rateId << t);
+  TxTimeTable &table = m_minstrelGroups[groupId].ratesTxTimeTable;
+  if (table.size () <= rateId)
+    {
+      table.resize (m_numRates);
+    }
+  table[rateId] = t;
 }
 
 WifiRemoteStation *
@@ -1098,7 +1108,7 @@ MinstrelHtWifiManager::FindRate (MinstrelHtWifiRemoteStation *station)
            * Also do not sample if the probability is already higher than 95%
            * to avoid wasting airtime.
            */
-          HtRateInfo sampleRateInfo = station->m_groupsTable[sampleGroupId].m_ratesTable[sampleRateId];
+          const HtRateInfo &sampleRateInfo = station->m_groupsTable[sampleGroupId].m_ratesTable[sampleRateId];
 
           NS_LOG_DEBUG ("Use sample rate? MaxTpRate= " << station->m_maxTpRate << " CurrentRate= " << station->m_txrate <<
                         " SampleRate= " << sampleIdx << " SampleProb= " << sampleRateInfo.ewmaProb);
@@ -1206,65 +1216,75 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
           station->m_groupsTable[j].m_maxTpRate2 = GetLowestIndex (station, j);
           station->m_groupsTable[j].m_maxProbRate = GetLowestIndex (station, j);
 
+          /*
+           * First update the statistics of every rate of the group, then
+           * select the best rates.  The selection only compares rates that
+           * were already updated (the group and station indexes start at
+           * the lowest supported rate), so splitting the loop does not
+           * change the result.
+           */
+          HtMinstrelRate &rates = station->m_groupsTable[j].m_ratesTable;
           for (uint8_t i = 0; i < m_numRates; i++)
             {
-              if (station->m_groupsTable[j].m_ratesTable[i].supported)
+              HtRateInfo &rate = rates[i];
+              if (!rate.supported)
                 {
-                  station->m_groupsTable[j].m_ratesTable[i].retryUpdated = false;
-
-                  NS_LOG_DEBUG (+i << " " << GetMcsSupported (station, station->m_groupsTable[j].m_ratesTable[i].mcsIndex) <<
-                                "\t attempt=" << station->m_groupsTable[j].m_ratesTable[i].numRateAttempt <<
-                                "\t success=" << station->m_groupsTable[j].m_ratesTable[i].numRateSuccess);
-
-                  /// If we've attempted something.
-                  if (station->m_groupsTable[j].m_ratesTable[i].numRateAttempt > 0)
-                    {
-                      station->m_groupsTable[j].m_ratesTable[i].numSamplesSkipped = 0;
-                      /**
-                       * Calculate the probability of success.
-                       * Assume probability scales from 0 to 100.
-                       */
-                      tempProb = (100 * station->m_groupsTable[j].m_ratesTable[i].numRateSuccess) / station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
+                  continue;
+                }
+              rate.retryUpdated = false;
 
-                      /// Bookkeeping.
-                      station->m_groupsTable[j].m_ratesTable[i].prob = tempProb;
+              NS_LOG_DEBUG (+i << " " << GetMcsSupported (station, rate.mcsIndex) <<
+                            "\t attempt=" << rate.numRateAttempt <<
+                            "\t success=" << rate.numRateSuccess);
 
-                      if (station->m_groupsTable[j].m_ratesTable[i].successHist == 0)
-                        {
-                          station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
-                        }
-                      else
-                        {
-                          station->m_groupsTable[j].m_ratesTable[i].ewmsdProb = CalculateEwmsd (station->m_groupsTable[j].m_ratesTable[i].ewmsdProb,
-                                                                                                tempProb, station->m_groupsTable[j].m_ratesTable[i].ewmaProb,
-                                                                                                m_ewmaLevel);
-                          /// EWMA probability
-                          tempProb = (tempProb * (100 - m_ewmaLevel) + station->m_groupsTable[j].m_ratesTable[i].ewmaProb * m_ewmaLevel)  / 100;
-                          station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
-                        }
+              /// If we've attempted something.
+              if (rate.numRateAttempt > 0)
+                {
+                  rate.numSamplesSkipped = 0;
+                  /**
+                   * Calculate the probability of success.
+                   * Assume probability scales from 0 to 100.
+                   */
+                  tempProb = (100 * rate.numRateSuccess) / rate.numRateAttempt;
 
-                      station->m_groupsTable[j].m_ratesTable[i].throughput = CalculateThroughput (station, j, i, tempProb);
+                  /// Bookkeeping.
+                  rate.prob = tempProb;
 
-                      station->m_groupsTable[j].m_ratesTable[i].successHist += station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                      station->m_groupsTable[j].m_ratesTable[i].attemptHist += station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
+                  if (rate.successHist == 0)
+                    {
+                      rate.ewmaProb = tempProb;
                     }
                   else
                     {
-                      station->m_groupsTable[j].m_ratesTable[i].numSamplesSkipped++;
+                      rate.ewmsdProb = CalculateEwmsd (rate.ewmsdProb, tempProb, rate.ewmaProb, m_ewmaLevel);
+                      /// EWMA probability
+                      tempProb = (tempProb * (100 - m_ewmaLevel) + rate.ewmaProb * m_ewmaLevel)  / 100;
+                      rate.ewmaProb = tempProb;
                     }
 
-                  /// Bookkeeping.
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateSuccess = station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateAttempt = station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
-                  station->m_groupsTable[j].m_ratesTable[i].numRateSuccess = 0;
-                  station->m_groupsTable[j].m_ratesTable[i].numRateAttempt = 0;
+                  rate.throughput = CalculateThroughput (station, j, i, tempProb);
 
-                  if (station->m_groupsTable[j].m_ratesTable[i].throughput != 0)
-                    {
-                      SetBestStationThRates (station, GetIndex (j, i));
-                      SetBestProbabilityRate (station, GetIndex (j, i));
-                    }
+                  rate.successHist += rate.numRateSuccess;
+                  rate.attemptHist += rate.numRateAttempt;
+                }
+              else
+                {
+                  rate.numSamplesSkipped++;
+                }
+
+              /// Bookkeeping.
+              rate.prevNumRateSuccess = rate.numRateSuccess;
+              rate.prevNumRateAttempt = rate.numRateAttempt;
+              rate.numRateSuccess = 0;
+              rate.numRateAttempt = 0;
+            }
 
+          for (uint8_t i = 0; i < m_numRates; i++)
+            {
+              if (rates[i].supported && rates[i].throughput != 0)
+                {
+                  SetBestStationThRates (station, GetIndex (j, i));
+                  SetBestProbabilityRate (station, GetIndex (j, i));
                 }
             }
         }
@@ -1503,7 +1523,7 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
                       station->m_groupsTable[groupId].m_ratesTable[rateId].successHist = 0;
                       station->m_groupsTable[groupId].m_ratesTable[rateId].attemptHist = 0;
                       station->m_groupsTable[groupId].m_ratesTable[rateId].throughput = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].perfectTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, i));
+                      station->m_groupsTable[groupId].m_ratesTable[rateId].perfectTxTime = GetFirstMpduTxTime (groupId, rateId);
                       station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 0;
                       station->m_groupsTable[groupId].m_ratesTable[rateId].adjustedRetryCount = 0;
                       CalculateRetransmits (station, groupId, rateId);
@@ -1549,8 +1569,8 @@ MinstrelHtWifiManager::CalculateRetransmits (MinstrelHtWifiRemoteStation *statio
       station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 2;
       station->m_groupsTable[groupId].m_ratesTable[rateId].retryUpdated = true;
 
-      dataTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex)) +
-        GetMpduTxTime (groupId, GetMcsSupported (station, station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex)) * (station->m_avgAmpduLen - 1);
+      dataTxTime = GetFirstMpduTxTime (groupId, rateId) +
+        GetMpduTxTime (groupId, rateId) * (station->m_avgAmpduLen - 1);
 
       /* Contention time for first 2 tries */
       cwTime = (cw / 2) * slotTime;
@@ -1709,7 +1729,7 @@ MinstrelHtWifiManager::StatsDump (MinstrelHtWifiRemoteStation *station, uint8_t
           of << "  " << std::setw (3) << +idx << "  ";
 
           /* tx_time[rate(i)] in usec */
-          txTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, station->m_groupsTable[groupId].m_ratesTable[i].mcsIndex));
+          txTime = GetFirstMpduTxTime (groupId, i);
           of << std::setw (6) << txTime.GetMicroSeconds () << "  ";
 
           of << std::setw (7) << CalculateThroughput (station, groupId, i, 100) / 100 << "   " <<
@@ -33,8 +33,11 @@ namespace ns3 {
 
 /**
  * Data structure to save transmission time calculations per rate.
+ * The table of a group is indexed by rate ID; it is filled once when the
+ * manager is initialized, so that looking up a TX time is a plain array
+ * access.  Entries of MCSs that are not valid for the group are zero.
  */
-typedef std::map<WifiMode, Time> TxTime;
+typedef std::vector<Time> TxTimeTable;
 
 /**
  * Data structure to contain the information that defines a group.
@@ -51,8 +54,8 @@ struct McsGroup
   bool isSupported; ///< is supported?
   // To accurately account for TX times, we separate the TX time of the first
   // MPDU in an A-MPDU from the rest of the MPDUs.
-  TxTime ratesTxTimeTable; ///< rates transmit time table
-  TxTime ratesFirstMpduTxTimeTable; ///< rates MPDU transmit time table
+  TxTimeTable ratesTxTimeTable; ///< rates transmit time table
+  TxTimeTable ratesFirstMpduTxTimeTable; ///< rates MPDU transmit time table
 };
 
 /**
@@ -276,37 +279,37 @@ private:
    * Obtain the TXtime saved in the group information.
    *
    * \param groupId the group ID
-   * \param mode the wifi mode
+   * \param rateId the rate ID
    * \returns the transmit time
    */
-  Time GetMpduTxTime (uint8_t groupId, WifiMode mode) const;
+  Time GetMpduTxTime (uint8_t groupId, uint8_t rateId) const;
 
   /**
    * Save a TxTime to the vector of groups.
    *
    * \param groupId the group ID
-   * \param mode the wifi mode
+   * \param rateId the rate ID
    * \param t the transmit time
    */
-  void AddMpduTxTime (uint8_t groupId, WifiMode mode, Time t);
+  void AddMpduTxTime (uint8_t groupId, uint8_t rateId, Time t);
 
   /**
    * Obtain the TXtime saved in the group information.
    *
    * \param groupId the group ID
-   * \param mode the wifi mode
+   * \param rateId the rate ID
    * \returns the transmit time
    */
-  Time GetFirstMpduTxTime (uint8_t groupId, WifiMode mode) const;
+  Time GetFirstMpduTxTime (uint8_t groupId, uint8_t rateId) const;
 
   /**
    * Save a TxTime to the vector of groups.
    *
    * \param groupId the group ID
-   * \param mode the wifi mode
+   * \param rateId the rate ID
    * \param t the transmit time
    */
-  void AddFirstMpduTxTime (uint8_t groupId, WifiMode mode, Time t);
+  void AddFirstMpduTxTime (uint8_t groupId, uint8_t rateId, Time t);
 
   /**
    * Update the number of retries and reset accordingly.
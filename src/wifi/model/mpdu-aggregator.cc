@@ -109,6 +109,14 @@ MpduAggregator::AggregateSingleMpdu (Ptr<const Packet> packet, Ptr<Packet> aggre
   aggregatedPacket->AddAtEnd (currentPacket);
 }
 
+uint32_t
+MpduAggregator::GetSizeIfAggregated (uint32_t mpduSize, uint32_t ampduSize)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  uint8_t padding = (4 - (ampduSize % 4 )) % 4;
+  return ampduSize + padding + AmpduSubframeHeader ().GetSerializedSize () + mpduSize;
+}
+
 void
 MpduAggregator::AddHeaderAndPad (Ptr<Packet> packet, bool last, bool isSingleMpdu) const
 {
@@ -165,7 +173,7 @@ MpduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
   DeaggregatedMpdus set;
 
   AmpduSubframeHeader hdr;
-  Ptr<Packet> extractedMpdu = Create<Packet> ();
+  Ptr<Packet> extractedMpdu;
   uint32_t maxSize = aggregatedPacket->GetSize ();
   uint16_t extractedLength;
   uint32_t padding;
@@ -175,6 +183,14 @@ MpduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
     {
       deserialized += aggregatedPacket->RemoveHeader (hdr);
       extractedLength = hdr.GetLength ();
+      if (aggregatedPacket->GetSize () < extractedLength + 4u)
+        {
+          //Last subframe (the PHY delivers each subframe of an A-MPDU on its
+          //own): hand over the remaining bytes instead of copying them
+          aggregatedPacket->RemoveAtEnd (aggregatedPacket->GetSize () - extractedLength);
+          set.push_back (std::make_pair (aggregatedPacket, hdr));
+          break;
+        }
       extractedMpdu = aggregatedPacket->CreateFragment (0, static_cast<uint32_t> (extractedLength));
       aggregatedPacket->RemoveAtStart (extractedLength);
       deserialized += extractedLength;
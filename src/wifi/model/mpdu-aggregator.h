@@ -86,6 +86,16 @@ public:
    * This method performs a VHT/HE single MPDU aggregation.
    */
   void AggregateSingleMpdu (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket) const;
+  /**
+   * \param mpduSize the size of the MPDU (including MAC header and FCS) to add to the A-MPDU.
+   * \param ampduSize the size of the A-MPDU.
+   *
+   * \return the size of the A-MPDU once the MPDU, its A-MPDU subframe header and the padding
+   *         of the previous subframe are added to it.
+   *
+   * This method lets the size of an A-MPDU be computed without serializing its MPDUs.
+   */
+  static uint32_t GetSizeIfAggregated (uint32_t mpduSize, uint32_t ampduSize);
   /**
    * \param packet the packet we want to insert into <i>aggregatedPacket</i>.
    * \param last true if it is the last packet.
@@ -107,6 +117,8 @@ public:
 
   /**
    * Deaggregates an A-MPDU by removing the A-MPDU subframe header and padding.
+   * The last MPDU is not copied: <i>aggregatedPacket</i> itself, stripped of
+   * everything but that MPDU, is returned for it.
    *
    * \param aggregatedPacket the aggregated packet
    * \return list of deaggragted packets and their A-MPDU subframe headers
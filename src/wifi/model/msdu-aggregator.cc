@@ -73,11 +73,7 @@ MsduAggregator::Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacke
 
   if ((14 + packet->GetSize () + actualSize + padding) <= GetMaxAmsduSize ())
     {
-      if (padding)
-        {
-          Ptr<Packet> pad = Create<Packet> (padding);
-          aggregatedPacket->AddAtEnd (pad);
-        }
+      aggregatedPacket->AddPaddingAtEnd (padding);
       currentHdr.SetDestinationAddr (dest);
       currentHdr.SetSourceAddr (src);
       currentHdr.SetLength (static_cast<uint16_t> (packet->GetSize ()));
@@ -103,7 +99,7 @@ MsduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
   DeaggregatedMsdus set;
 
   AmsduSubframeHeader hdr;
-  Ptr<Packet> extractedMsdu = Create<Packet> ();
+  Ptr<Packet> extractedMsdu;
   uint32_t maxSize = aggregatedPacket->GetSize ();
   uint16_t extractedLength;
   uint8_t padding;
@@ -113,6 +109,13 @@ MsduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
     {
       deserialized += aggregatedPacket->RemoveHeader (hdr);
       extractedLength = hdr.GetLength ();
+      if (aggregatedPacket->GetSize () < extractedLength + 4u)
+        {
+          //Last subframe: hand over the remaining bytes instead of a fragment
+          aggregatedPacket->RemoveAtEnd (aggregatedPacket->GetSize () - extractedLength);
+          set.push_back (std::make_pair (aggregatedPacket, hdr));
+          break;
+        }
       extractedMsdu = aggregatedPacket->CreateFragment (0, static_cast<uint32_t> (extractedLength));
       aggregatedPacket->RemoveAtStart (extractedLength);
       deserialized += extractedLength;
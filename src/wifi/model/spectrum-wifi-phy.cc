@@ -59,6 +59,10 @@ SpectrumWifiPhy::GetTypeId (void)
 }
 
 SpectrumWifiPhy::SpectrumWifiPhy ()
+  : m_txPsdCenterFrequency (0),
+    m_txPsdChannelWidth (0),
+    m_txPsdPowerW (0),
+    m_txPsdModulationClass (WIFI_MOD_CLASS_UNKNOWN)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -74,6 +78,7 @@ SpectrumWifiPhy::DoDispose (void)
   NS_LOG_FUNCTION (this);
   m_channel = 0;
   m_wifiSpectrumPhyInterface = 0;
+  m_txPsd = 0;
   WifiPhy::DoDispose ();
 }
 
@@ -231,7 +236,7 @@ SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
   // spectral mask representing our filtering allows) to find the
   // total energy apparent to the "demodulator".
   uint16_t channelWidth = GetChannelWidth ();
-  Ptr<SpectrumValue> filter = WifiSpectrumValueHelper::CreateRfFilter (GetFrequency (), channelWidth, GetBandBandwidth (), GetGuardBandwidth (channelWidth));
+  Ptr<const SpectrumValue> filter = WifiSpectrumValueHelper::GetRfFilter (GetFrequency (), channelWidth, GetBandBandwidth (), GetGuardBandwidth (channelWidth));
   SpectrumValue filteredSignal = (*filter) * (*receivedSignalPsd);
   // Add receiver antenna gain
   NS_LOG_DEBUG ("Signal power received (watts) before antenna gain: " << Integral (filteredSignal));
@@ -334,7 +339,23 @@ SpectrumWifiPhy::StartTx (Ptr<Packet> packet, WifiTxVector txVector, Time txDura
 {
   NS_LOG_DEBUG ("Start transmission: signal power before antenna gain=" << GetPowerDbm (txVector.GetTxPowerLevel ()) << "dBm");
   double txPowerWatts = DbmToW (GetPowerDbm (txVector.GetTxPowerLevel ()) + GetTxGain ());
-  Ptr<SpectrumValue> txPowerSpectrum = GetTxPowerSpectralDensity (GetCenterFrequencyForChannelWidth (txVector), txVector.GetChannelWidth (), txPowerWatts, txVector.GetMode ().GetModulationClass ());
+  uint16_t centerFrequency = GetCenterFrequencyForChannelWidth (txVector);
+  WifiModulationClass modulationClass = txVector.GetMode ().GetModulationClass ();
+  //The channel copies the PSD before applying the propagation loss, so the
+  //PSD of a transmission can be shared with the following ones.
+  if (m_txPsd == 0
+      || m_txPsdCenterFrequency != centerFrequency
+      || m_txPsdChannelWidth != txVector.GetChannelWidth ()
+      || m_txPsdPowerW != txPowerWatts
+      || m_txPsdModulationClass != modulationClass)
+    {
+      m_txPsd = GetTxPowerSpectralDensity (centerFrequency, txVector.GetChannelWidth (), txPowerWatts, modulationClass);
+      m_txPsdCenterFrequency = centerFrequency;
+      m_txPsdChannelWidth = txVector.GetChannelWidth ();
+      m_txPsdPowerW = txPowerWatts;
+      m_txPsdModulationClass = modulationClass;
+    }
+  Ptr<SpectrumValue> txPowerSpectrum = m_txPsd;
   Ptr<WifiSpectrumSignalParameters> txParams = Create<WifiSpectrumSignalParameters> ();
   txParams->duration = txDuration;
   txParams->psd = txPowerSpectrum;
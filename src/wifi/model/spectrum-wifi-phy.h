@@ -218,6 +218,12 @@ private:
   bool m_disableWifiReception;          //!< forces this Phy to fail to sync on any signal
   TracedCallback<bool, uint32_t, double, Time> m_signalCb; //!< Signal callback
 
+  Ptr<SpectrumValue> m_txPsd;                  //!< the Tx PSD of the last transmission, reused while its parameters do not change
+  uint16_t m_txPsdCenterFrequency;             //!< the center frequency (MHz) of m_txPsd
+  uint16_t m_txPsdChannelWidth;                //!< the channel width (MHz) of m_txPsd
+  double m_txPsdPowerW;                        //!< the power (W) of m_txPsd
+  WifiModulationClass m_txPsdModulationClass;  //!< the modulation class of m_txPsd
+
 };
 
 } //namespace ns3
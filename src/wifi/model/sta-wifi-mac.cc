@@ -20,6 +20,7 @@
  *          Mirko Banchi <mk.banchi@gmail.com>
  */
 
+#include <algorithm>
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
@@ -88,7 +89,9 @@ StaWifiMac::StaWifiMac ()
     m_waitBeaconEvent (),
     m_probeRequestEvent (),
     m_assocRequestEvent (),
-    m_beaconWatchdogEnd (Seconds (0))
+    m_beaconWatchdogEnd (Seconds (0)),
+    m_probeRequestChannelWidth (0),
+    m_beaconInfoUpToDate (false)
 {
   NS_LOG_FUNCTION (this);
 
@@ -133,6 +136,7 @@ StaWifiMac::SetWifiPhy (const Ptr<WifiPhy> phy)
   NS_LOG_FUNCTION (this << phy);
   RegularWifiMac::SetWifiPhy (phy);
   m_phy->SetCapabilitiesChangedCallback (MakeCallback (&StaWifiMac::PhyCapabilitiesChanged, this));
+  m_probeRequest = 0;
 }
 
 void
@@ -154,24 +158,34 @@ StaWifiMac::SendProbeRequest (void)
   hdr.SetAddr3 (Mac48Address::GetBroadcast ());
   hdr.SetDsNotFrom ();
   hdr.SetDsNotTo ();
-  Ptr<Packet> packet = Create<Packet> ();
-  MgtProbeRequestHeader probe;
-  probe.SetSsid (GetSsid ());
-  probe.SetSupportedRates (GetSupportedRates ());
-  if (GetHtSupported () || GetVhtSupported () || GetHeSupported ())
-    {
-      probe.SetExtendedCapabilities (GetExtendedCapabilities ());
-      probe.SetHtCapabilities (GetHtCapabilities ());
-    }
-  if (GetVhtSupported () || GetHeSupported ())
-    {
-      probe.SetVhtCapabilities (GetVhtCapabilities ());
-    }
-  if (GetHeSupported ())
+  //The body of a probe request only depends on the SSID and on the PHY
+  //capabilities, so it is serialized again only when they change
+  if (m_probeRequest == 0
+      || !m_probeRequestSsid.IsEqual (GetSsid ())
+      || m_probeRequestChannelWidth != m_phy->GetChannelWidth ())
     {
-      probe.SetHeCapabilities (GetHeCapabilities ());
+      MgtProbeRequestHeader probe;
+      probe.SetSsid (GetSsid ());
+      probe.SetSupportedRates (GetSupportedRates ());
+      if (GetHtSupported () || GetVhtSupported () || GetHeSupported ())
+        {
+          probe.SetExtendedCapabilities (GetExtendedCapabilities ());
+          probe.SetHtCapabilities (GetHtCapabilities ());
+        }
+      if (GetVhtSupported () || GetHeSupported ())
+        {
+          probe.SetVhtCapabilities (GetVhtCapabilities ());
+        }
+      if (GetHeSupported ())
+        {
+          probe.SetHeCapabilities (GetHeCapabilities ());
+        }
+      m_probeRequest = Create<Packet> ();
+      m_probeRequest->AddHeader (probe);
+      m_probeRequestSsid = GetSsid ();
+      m_probeRequestChannelWidth = m_phy->GetChannelWidth ();
     }
-  packet->AddHeader (probe);
+  Ptr<Packet> packet = m_probeRequest->Copy ();
 
   //The standard is not clear on the correct queue for management
   //frames if we are a QoS AP. The approach taken here is to always
@@ -562,7 +576,7 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
     {
       NS_LOG_DEBUG ("Beacon received");
       MgtBeaconHeader beacon;
-      packet->RemoveHeader (beacon);
+      bool unchanged = GetBeacon (packet, hdr->GetAddr3 (), beacon);
       CapabilityInformation capabilities = beacon.GetCapabilities ();
       NS_ASSERT (capabilities.IsEss ());
       bool goodBeacon = false;
@@ -611,7 +625,11 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
           m_beaconArrival (Simulator::Now ());
           Time delay = MicroSeconds (beacon.GetBeaconIntervalUs () * m_maxMissedBeacons);
           RestartBeaconWatchdog (delay);
-          UpdateApInfoFromBeacon (beacon, hdr->GetAddr2 (), hdr->GetAddr3 ());
+          if (!unchanged || !m_beaconInfoUpToDate)
+            {
+              UpdateApInfoFromBeacon (beacon, hdr->GetAddr2 (), hdr->GetAddr3 ());
+              m_beaconInfoUpToDate = true;
+            }
         }
       if (goodBeacon && m_state == WAIT_BEACON)
         {
@@ -729,6 +747,28 @@ StaWifiMac::UpdateCandidateApList (ApInfo newApInfo)
   m_candidateAps.push_back(newApInfo);
 }
 
+bool
+StaWifiMac::GetBeacon (Ptr<Packet> packet, Mac48Address bssid, MgtBeaconHeader &beacon)
+{
+  NS_LOG_FUNCTION (this << packet << bssid);
+  uint32_t size = packet->GetSize ();
+  m_beaconBuffer.resize (size);
+  packet->CopyData (m_beaconBuffer.data (), size);
+  KnownBeacon &known = m_knownBeacons[bssid];
+  //the first 8 bytes hold the timestamp, which changes for every beacon
+  if (known.m_body.size () == size && size >= 8
+      && std::equal (m_beaconBuffer.begin () + 8, m_beaconBuffer.end (), known.m_body.begin () + 8))
+    {
+      NS_LOG_DEBUG ("Same beacon as the previous one from " << bssid);
+      beacon = known.m_beacon;
+      return true;
+    }
+  packet->RemoveHeader (beacon);
+  known.m_body.swap (m_beaconBuffer);
+  known.m_beacon = beacon;
+  return false;
+}
+
 void
 StaWifiMac::UpdateApInfoFromBeacon (MgtBeaconHeader beacon, Mac48Address apAddr, Mac48Address bssid)
 {
@@ -858,6 +898,7 @@ void
 StaWifiMac::UpdateApInfoFromProbeResp (MgtProbeResponseHeader probeResp, Mac48Address apAddr, Mac48Address bssid)
 {
   NS_LOG_FUNCTION (this << probeResp << apAddr << bssid);
+  m_beaconInfoUpToDate = false;
   CapabilityInformation capabilities = probeResp.GetCapabilities ();
   SupportedRates rates = probeResp.GetSupportedRates ();
   for (uint8_t i = 0; i < m_phy->GetNBssMembershipSelectors (); i++)
@@ -927,6 +968,7 @@ void
 StaWifiMac::UpdateApInfoFromAssocResp (MgtAssocResponseHeader assocResp, Mac48Address apAddr)
 {
   NS_LOG_FUNCTION (this << assocResp << apAddr);
+  m_beaconInfoUpToDate = false;
   CapabilityInformation capabilities = assocResp.GetCapabilities ();
   SupportedRates rates = assocResp.GetSupportedRates ();
   bool isShortPreambleEnabled = capabilities.IsShortPreamble ();
@@ -1134,6 +1176,8 @@ StaWifiMac::SetState (MacState value)
       m_deAssocLogger (GetBssid ());
     }
   m_state = value;
+  //the information from the next beacon of the AP is applied again
+  m_beaconInfoUpToDate = false;
 }
 
 void
@@ -1150,6 +1194,8 @@ void
 StaWifiMac::PhyCapabilitiesChanged (void)
 {
   NS_LOG_FUNCTION (this);
+  //the capabilities advertised in the cached probe request are out of date
+  m_probeRequest = 0;
   if (IsAssociated ())
     {
       NS_LOG_DEBUG ("PHY capabilities changed: send reassociation request");
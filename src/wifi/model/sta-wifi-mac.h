@@ -168,6 +168,17 @@ private:
    * \param hdr the MAC header of the received packet
    */
   void Receive (Ptr<Packet> packet, const WifiMacHeader *hdr);
+  /**
+   * Deserialize the body of a received beacon, unless it is identical,
+   * except for the timestamp, to the previous beacon received from the same
+   * BSS, in which case the header deserialized then is returned.
+   *
+   * \param packet the beacon body
+   * \param bssid the BSSID of the beacon
+   * \param beacon the beacon header
+   * \return true if the beacon is the same as the previous one of the BSS
+   */
+  bool GetBeacon (Ptr<Packet> packet, Mac48Address bssid, MgtBeaconHeader &beacon);
   /**
    * Update associated AP's information from beacon. If STA is not associated,
    * this information will used for the association process.
@@ -310,6 +321,19 @@ private:
   Time m_beaconWatchdogEnd;    ///< beacon watchdog end
   uint32_t m_maxMissedBeacons; ///< maximum missed beacons
   bool m_activeProbing;        ///< active probing
+  Ptr<Packet> m_probeRequest;  ///< body of the last probe request
+  Ssid m_probeRequestSsid;     ///< SSID of the last probe request
+  uint16_t m_probeRequestChannelWidth; ///< channel width (MHz) for which the last probe request was built
+
+  /// The last beacon received from a BSS
+  struct KnownBeacon
+  {
+    std::vector<uint8_t> m_body; ///< the serialized beacon body
+    MgtBeaconHeader m_beacon;    ///< the deserialized beacon body
+  };
+  std::map<Mac48Address, KnownBeacon> m_knownBeacons; ///< the last beacon received from each BSS
+  std::vector<uint8_t> m_beaconBuffer; ///< buffer into which received beacons are copied
+  bool m_beaconInfoUpToDate;   ///< whether the last beacon of the AP was applied and nothing changed since
   std::vector<ApInfo> m_candidateAps; ///< list of candidate APs to associate
   // Note: std::multiset<ApInfo> might be a candidate container to implement
   // this sorted list, but we are using a std::vector because we want to sort
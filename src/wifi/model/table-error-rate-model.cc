@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "table-error-rate-model.h"
+#include "wifi-tx-vector.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TableErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TableErrorRateModel);
+
+/// Largest tabulated -ln of a success rate; exp (-MAX_Q) is zero in double precision
+static const double MAX_Q = 745.0;
+
+TypeId
+TableErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TableErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TableErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model whose results are tabulated.",
+                   PointerValue (),
+                   MakePointerAccessor (&TableErrorRateModel::SetErrorRateModel,
+                                        &TableErrorRateModel::GetErrorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnr",
+                   "The lowest tabulated SNR (dB). Lower SNR values are passed to the wrapped model.",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::SetMinSnr,
+                                       &TableErrorRateModel::GetMinSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The highest tabulated SNR (dB). Higher SNR values are passed to the wrapped model.",
+                   DoubleValue (40.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::SetMaxSnr,
+                                       &TableErrorRateModel::GetMaxSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Resolution",
+                   "The spacing of the tabulated SNR values (dB), which bounds the interpolation error.",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TableErrorRateModel::SetResolution,
+                                       &TableErrorRateModel::GetResolution),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+TableErrorRateModel::TableErrorRateModel ()
+  : m_minSnr (-10.0),
+    m_maxSnr (40.0),
+    m_resolution (0.05),
+    m_nPoints (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TableErrorRateModel::~TableErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TableErrorRateModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_model = 0;
+  m_tables.clear ();
+  ErrorRateModel::DoDispose ();
+}
+
+void
+TableErrorRateModel::SetErrorRateModel (const Ptr<ErrorRateModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  m_tables.clear ();
+  ClearSnrThresholds ();
+}
+
+Ptr<ErrorRateModel>
+TableErrorRateModel::GetErrorRateModel (void) const
+{
+  return m_model;
+}
+
+void
+TableErrorRateModel::SetSnrGrid (double minSnr, double maxSnr, double resolution)
+{
+  NS_LOG_FUNCTION (this << minSnr << maxSnr << resolution);
+  m_minSnr = minSnr;
+  m_maxSnr = maxSnr;
+  m_resolution = resolution;
+  m_tables.clear ();
+  ClearSnrThresholds ();
+  m_nPoints = 0;
+  if (m_maxSnr > m_minSnr && m_resolution > 0)
+    {
+      m_nPoints = static_cast<uint32_t> (std::floor ((m_maxSnr - m_minSnr) / m_resolution + 1e-9)) + 1;
+    }
+}
+
+void
+TableErrorRateModel::SetMinSnr (double minSnr)
+{
+  SetSnrGrid (minSnr, m_maxSnr, m_resolution);
+}
+
+double
+TableErrorRateModel::GetMinSnr (void) const
+{
+  return m_minSnr;
+}
+
+void
+TableErrorRateModel::SetMaxSnr (double maxSnr)
+{
+  SetSnrGrid (m_minSnr, maxSnr, m_resolution);
+}
+
+double
+TableErrorRateModel::GetMaxSnr (void) const
+{
+  return m_maxSnr;
+}
+
+void
+TableErrorRateModel::SetResolution (double resolution)
+{
+  SetSnrGrid (m_minSnr, m_maxSnr, resolution);
+}
+
+double
+TableErrorRateModel::GetResolution (void) const
+{
+  return m_resolution;
+}
+
+uint32_t
+TableErrorRateModel::GetNTables (void) const
+{
+  return m_tables.size ();
+}
+
+const TableErrorRateModel::Table &
+TableErrorRateModel::GetTable (WifiMode mode, WifiTxVector txVector) const
+{
+  //the rate of a mode, and thus the error rate of the YANS model,
+  //depends on the channel width, the guard interval and the number
+  //of spatial streams
+  uint64_t key = (static_cast<uint64_t> (mode.GetUid ()) << 40)
+    | (static_cast<uint64_t> (txVector.GetChannelWidth ()) << 24)
+    | (static_cast<uint64_t> (txVector.GetGuardInterval ()) << 8)
+    | txVector.GetNss ();
+  Tables::iterator it = m_tables.find (key);
+  if (it != m_tables.end ())
+    {
+      return it->second;
+    }
+
+  NS_LOG_DEBUG ("Computing table of " << mode << " with " << m_nPoints << " points");
+  Table &table = m_tables[key];
+  table.resize (m_nPoints);
+  for (uint32_t i = 0; i < m_nPoints; i++)
+    {
+      double snr = std::pow (10.0, (m_minSnr + i * m_resolution) / 10.0);
+      double psr = m_model->GetChunkSuccessRate (mode, txVector, snr, 1);
+      double q = psr >= 1.0 ? 0.0 : (psr <= 0.0 ? MAX_Q : std::min (-std::log (psr), MAX_Q));
+      table[i].q = q;
+      table[i].logQ = q > 0 ? std::log (q) : 0;
+    }
+  return table;
+}
+
+double
+TableErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector.GetMode () << snr << nbits);
+  NS_ASSERT_MSG (m_model != 0, "TableErrorRateModel needs an ErrorRateModel to tabulate");
+  if (snr <= 0 || m_nPoints < 2)
+    {
+      return m_model->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  double x = (10.0 * std::log10 (snr) - m_minSnr) / m_resolution;
+  if (x < 0 || x >= m_nPoints - 1)
+    {
+      return m_model->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  const Table &table = GetTable (mode, txVector);
+  uint32_t i = static_cast<uint32_t> (x);
+  double f = x - i;
+  const Point &a = table[i];
+  const Point &b = table[i + 1];
+  double q;
+  if (a.q > 0 && b.q > 0)
+    {
+      //-ln of the error rates spans many orders of magnitude
+      q = std::exp (a.logQ + (b.logQ - a.logQ) * f);
+    }
+  else
+    {
+      q = a.q + (b.q - a.q) * f;
+    }
+  return std::exp (-q * static_cast<double> (nbits));
+}
+
+} //namespace ns3
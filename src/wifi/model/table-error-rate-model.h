@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TABLE_ERROR_RATE_MODEL_H
+#define TABLE_ERROR_RATE_MODEL_H
+
+#include <map>
+#include <vector>
+#include "error-rate-model.h"
+
+namespace ns3 {
+
+class WifiTxVector;
+
+/**
+ * \ingroup wifi
+ *
+ * \brief An error rate model interpolating tables of another error rate model
+ *
+ * The NIST, YANS and DSSS error rate models evaluate erfc, binomial sums or
+ * long polynomials for every chunk of every received frame.  This model
+ * wraps one of them, set through the ErrorRateModel attribute: the first
+ * time a (mode, channel width, guard interval, number of spatial streams)
+ * combination is used, it evaluates the wrapped model on a grid of SNR
+ * values (in dB) between MinSnr and MaxSnr, spaced by Resolution, and
+ * stores -ln of the success rate of a single bit.  The success rate of a
+ * chunk is then interpolated (linearly in the log domain) and raised to the
+ * number of bits of the chunk.
+ *
+ * This is exact at the grid points for models whose chunk success rate is
+ * the single-bit success rate raised to the number of bits, which is the
+ * case of all the error rate models of this module.  The Resolution bounds
+ * the interpolation error in between; SNR values outside of the grid are
+ * passed to the wrapped model.
+ */
+class TableErrorRateModel : public ErrorRateModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TableErrorRateModel ();
+  virtual ~TableErrorRateModel ();
+
+  /**
+   * Set the wrapped error rate model and discard the tables.
+   *
+   * \param model the error rate model whose results are tabulated
+   */
+  void SetErrorRateModel (const Ptr<ErrorRateModel> model);
+  /**
+   * \return the wrapped error rate model
+   */
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+  /**
+   * Set the SNR grid of the tables and discard the tables.
+   *
+   * \param minSnr the lowest tabulated SNR (dB)
+   * \param maxSnr the highest tabulated SNR (dB)
+   * \param resolution the spacing of the tabulated SNR values (dB)
+   */
+  void SetSnrGrid (double minSnr, double maxSnr, double resolution);
+  /**
+   * \return the number of tables computed so far
+   */
+  uint32_t GetNTables (void) const;
+
+  double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * \brief A tabulated SNR value
+   */
+  struct Point
+  {
+    double q;    //!< -ln of the success rate of a single bit
+    double logQ; //!< ln of q, valid if q is positive
+  };
+  /// The table of a mode, from MinSnr to MaxSnr
+  typedef std::vector<Point> Table;
+  /// The tables, keyed by mode and by the TXVECTOR parameters the rate of the mode depends on
+  typedef std::map<uint64_t, Table> Tables;
+
+  /**
+   * \param minSnr the lowest tabulated SNR (dB)
+   */
+  void SetMinSnr (double minSnr);
+  /**
+   * \return the lowest tabulated SNR (dB)
+   */
+  double GetMinSnr (void) const;
+  /**
+   * \param maxSnr the highest tabulated SNR (dB)
+   */
+  void SetMaxSnr (double maxSnr);
+  /**
+   * \return the highest tabulated SNR (dB)
+   */
+  double GetMaxSnr (void) const;
+  /**
+   * \param resolution the spacing of the tabulated SNR values (dB)
+   */
+  void SetResolution (double resolution);
+  /**
+   * \return the spacing of the tabulated SNR values (dB)
+   */
+  double GetResolution (void) const;
+
+  /**
+   * Return the table of the given mode, computing it if needed.
+   *
+   * \param mode the Wi-Fi mode of the chunk
+   * \param txVector TXVECTOR of the overall transmission
+   *
+   * \return the table
+   */
+  const Table & GetTable (WifiMode mode, WifiTxVector txVector) const;
+
+  Ptr<ErrorRateModel> m_model; //!< the wrapped error rate model
+  double m_minSnr;             //!< the lowest tabulated SNR (dB)
+  double m_maxSnr;             //!< the highest tabulated SNR (dB)
+  double m_resolution;         //!< the spacing of the tabulated SNR values (dB)
+  uint32_t m_nPoints;          //!< the number of SNR values of each table
+  mutable Tables m_tables;     //!< the tables computed so far
+};
+
+} //namespace ns3
+
+#endif /* TABLE_ERROR_RATE_MODEL_H */
@@ -21,6 +21,8 @@
  *          Stefano Avallone <stavallo@unina.it>
  */
 
+#include <algorithm>
+#include <iterator>
 #include "ns3/simulator.h"
 #include "wifi-mac-queue.h"
 #include "qos-blocked-destinations.h"
@@ -90,6 +92,115 @@ WifiMacQueue::TtlExceeded (ConstIterator &it)
   return false;
 }
 
+void
+WifiMacQueue::RemoveExpired (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time now = Simulator::Now ();
+  if (m_timestamps.empty () || now <= m_timestamps.begin ()->first + m_maxDelay)
+    {
+      return;
+    }
+  // stale items are usually close to the head of the queue: stop looking
+  // for them as soon as all of them have been removed
+  uint32_t nExpired = 0;
+  for (auto ts = m_timestamps.begin (); ts != m_timestamps.end () && now > ts->first + m_maxDelay; ts++)
+    {
+      nExpired += ts->second;
+    }
+  for (auto it = Head (); it != Tail () && nExpired > 0; )
+    {
+      if (TtlExceeded (it))
+        {
+          nExpired--;
+        }
+      else
+        {
+          it++;
+        }
+    }
+}
+
+std::size_t
+WifiMacQueue::TidAddressHash::operator() (const TidAddress &key) const
+{
+  return Mac48AddressHash () (key.first) * 8 + key.second;
+}
+
+WifiMacQueue::SubQueue *
+WifiMacQueue::GetSubQueue (Ptr<const WifiMacQueueItem> item)
+{
+  if (!item->GetHeader ().IsQosData ())
+    {
+      return 0;
+    }
+  return &m_subQueues[TidAddress (item->GetDestinationAddress (), item->GetHeader ().GetQosTid ())];
+}
+
+bool
+WifiMacQueue::DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item)
+{
+  NS_ASSERT (pos == Head () || pos == Tail ());
+  bool atHead = (pos == Head ());
+  if (!Queue<WifiMacQueueItem>::DoEnqueue (pos, item))
+    {
+      return false;
+    }
+  SubQueue *subQueue = GetSubQueue (item);
+  if (subQueue != 0)
+    {
+      if (atHead)
+        {
+          subQueue->push_front (Head ());
+        }
+      else
+        {
+          subQueue->push_back (std::prev (Tail ()));
+        }
+    }
+  m_timestamps[item->GetTimeStamp ()]++;
+  return true;
+}
+
+void
+WifiMacQueue::Unindex (ConstIterator pos)
+{
+  SubQueue *subQueue = GetSubQueue (*pos);
+  if (subQueue != 0)
+    {
+      // the item is almost always the first one of its sub-queue
+      auto it = std::find (subQueue->begin (), subQueue->end (), pos);
+      NS_ASSERT (it != subQueue->end ());
+      subQueue->erase (it);
+    }
+  auto ts = m_timestamps.find ((*pos)->GetTimeStamp ());
+  NS_ASSERT (ts != m_timestamps.end ());
+  if (--ts->second == 0)
+    {
+      m_timestamps.erase (ts);
+    }
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoDequeue (ConstIterator pos)
+{
+  if (pos != Tail ())
+    {
+      Unindex (pos);
+    }
+  return Queue<WifiMacQueueItem>::DoDequeue (pos);
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoRemove (ConstIterator pos)
+{
+  if (pos != Tail ())
+    {
+      Unindex (pos);
+    }
+  return Queue<WifiMacQueueItem>::DoRemove (pos);
+}
+
 bool
 WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
 {
@@ -97,15 +208,11 @@ WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
   NS_ASSERT_MSG (GetMaxSize ().GetUnit () == QueueSizeUnit::PACKETS,
                  "WifiMacQueues must be in packet mode");
 
-  // if the queue is full, remove the first stale packet (if any) encountered
-  // starting from the head of the queue, in order to make room for the new packet.
+  // if the queue is full, remove the stale packets (if any), in order to
+  // make room for the new packet.
   if (QueueBase::GetNPackets () == GetMaxSize ().GetValue ())
     {
-      auto it = Head ();
-      while (it != Tail () && !TtlExceeded (it))
-        {
-          it++;
-        }
+      RemoveExpired ();
     }
 
   if (QueueBase::GetNPackets () == GetMaxSize ().GetValue () && m_dropPolicy == DROP_OLDEST)
@@ -124,15 +231,11 @@ WifiMacQueue::PushFront (Ptr<WifiMacQueueItem> item)
   NS_ASSERT_MSG (GetMaxSize ().GetUnit () == QueueSizeUnit::PACKETS,
                  "WifiMacQueues must be in packet mode");
 
-  // if the queue is full, remove the first stale packet (if any) encountered
-  // starting from the head of the queue, in order to make room for the new packet.
+  // if the queue is full, remove the stale packets (if any), in order to
+  // make room for the new packet.
   if (QueueBase::GetNPackets () == GetMaxSize ().GetValue ())
     {
-      auto it = Head ();
-      while (it != Tail () && !TtlExceeded (it))
-        {
-          it++;
-        }
+      RemoveExpired ();
     }
 
   if (QueueBase::GetNPackets () == GetMaxSize ().GetValue () && m_dropPolicy == DROP_OLDEST)
@@ -148,12 +251,10 @@ Ptr<WifiMacQueueItem>
 WifiMacQueue::Dequeue (void)
 {
   NS_LOG_FUNCTION (this);
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+  if (QueueBase::GetNPackets () > 0)
     {
-      if (!TtlExceeded (it))
-        {
-          return DoDequeue (it);
-        }
+      return DoDequeue (Head ());
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -184,18 +285,11 @@ Ptr<WifiMacQueueItem>
 WifiMacQueue::DequeueByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+  auto subQueue = m_subQueues.find (TidAddress (dest, tid));
+  if (subQueue != m_subQueues.end () && !subQueue->second.empty ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoDequeue (it);
-            }
-
-          it++;
-        }
+      return DoDequeue (subQueue->second.front ());
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -243,18 +337,11 @@ Ptr<const WifiMacQueueItem>
 WifiMacQueue::PeekByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+  auto subQueue = m_subQueues.find (TidAddress (dest, tid));
+  if (subQueue != m_subQueues.end () && !subQueue->second.empty ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoPeek (it);
-            }
-
-          it++;
-        }
+      return DoPeek (subQueue->second.front ());
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -285,13 +372,10 @@ Ptr<WifiMacQueueItem>
 WifiMacQueue::Remove (void)
 {
   NS_LOG_FUNCTION (this);
-
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+  if (QueueBase::GetNPackets () > 0)
     {
-      if (!TtlExceeded (it))
-        {
-          return DoRemove (it);
-        }
+      return DoRemove (Head ());
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -345,19 +429,12 @@ uint32_t
 WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
+  RemoveExpired ();
   uint32_t nPackets = 0;
-  for (auto it = Head (); it != Tail (); )
+  auto subQueue = m_subQueues.find (TidAddress (dest, tid));
+  if (subQueue != m_subQueues.end ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              nPackets++;
-            }
-
-          it++;
-        }
+      nPackets = subQueue->second.size ();
     }
   NS_LOG_DEBUG ("returns " << nPackets);
   return nPackets;
@@ -367,16 +444,10 @@ bool
 WifiMacQueue::IsEmpty (void)
 {
   NS_LOG_FUNCTION (this);
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          NS_LOG_DEBUG ("returns false");
-          return false;
-        }
-    }
-  NS_LOG_DEBUG ("returns true");
-  return true;
+  RemoveExpired ();
+  bool empty = (QueueBase::GetNPackets () == 0);
+  NS_LOG_DEBUG ("returns " << (empty ? "true" : "false"));
+  return empty;
 }
 
 uint32_t
@@ -384,13 +455,7 @@ WifiMacQueue::GetNPackets (void)
 {
   NS_LOG_FUNCTION (this);
   // remove packets that stayed in the queue for too long
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  RemoveExpired ();
   return QueueBase::GetNPackets ();
 }
 
@@ -399,13 +464,7 @@ WifiMacQueue::GetNBytes (void)
 {
   NS_LOG_FUNCTION (this);
   // remove packets that stayed in the queue for too long
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  RemoveExpired ();
   return QueueBase::GetNBytes ();
 }
 
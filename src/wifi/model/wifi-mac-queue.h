@@ -24,6 +24,9 @@
 #ifndef WIFI_MAC_QUEUE_H
 #define WIFI_MAC_QUEUE_H
 
+#include <deque>
+#include <map>
+#include <unordered_map>
 #include "wifi-mac-queue-item.h"
 
 namespace ns3 {
@@ -44,6 +47,12 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * The QoS data frames of each (receiver address, TID) pair are indexed
+ * in queue order, so that the per-destination operations used by block
+ * ack and aggregation do not scan the whole queue.  The number of queued
+ * packets per timestamp is kept sorted as well: stale packets are only
+ * looked for when the oldest packet in the queue has expired.
  */
 class WifiMacQueue : public Queue<WifiMacQueueItem>
 {
@@ -219,6 +228,21 @@ public:
   uint32_t GetNBytes (void);
 
 private:
+  /// (receiver address, TID) pair
+  typedef std::pair<Mac48Address, uint8_t> TidAddress;
+  /// The QoS data frames of a (receiver address, TID) pair, in queue order
+  typedef std::deque<ConstIterator> SubQueue;
+
+  /// Hash function for TidAddress
+  struct TidAddressHash
+  {
+    /**
+     * \param key the (receiver address, TID) pair
+     * \return the hash
+     */
+    std::size_t operator() (const TidAddress &key) const;
+  };
+
   /**
    * Remove the item pointed to by the iterator <i>it</i> if it has been in the
    * queue for too long. If the item is removed, the iterator is updated to
@@ -228,9 +252,55 @@ private:
    * \return true if the item is removed, false otherwise
    */
   bool TtlExceeded (ConstIterator &it);
+  /**
+   * Remove all the items that have been in the queue for too long.  This
+   * is a no-op unless the oldest item in the queue has expired.
+   */
+  void RemoveExpired (void);
+  /**
+   * \param item the item
+   * \return the sub-queue of the item, or null if the item is not a QoS
+   *         data frame
+   */
+  SubQueue * GetSubQueue (Ptr<const WifiMacQueueItem> item);
+
+  /**
+   * Insert an item and index it.  Hides the method of the base class.
+   *
+   * \param pos the position (Head () or Tail ()) before which the item is inserted
+   * \param item the item
+   * \return true if success, false if the item has been dropped
+   */
+  bool DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item);
+  /**
+   * Remove an item from the index and dequeue it.  Hides the method of
+   * the base class.
+   *
+   * \param pos the position of the item
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> DoDequeue (ConstIterator pos);
+  /**
+   * Remove an item from the index and drop it.  Hides the method of the
+   * base class.
+   *
+   * \param pos the position of the item
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> DoRemove (ConstIterator pos);
+  /**
+   * Remove the item at the given position from the index.
+   *
+   * \param pos the position of the item
+   */
+  void Unindex (ConstIterator pos);
 
   Time m_maxDelay;                          //!< Time to live for packets in the queue
   DropPolicy m_dropPolicy;                  //!< Drop behavior of queue
+  /// QoS data frames indexed by (receiver address, TID)
+  std::unordered_map<TidAddress, SubQueue, TidAddressHash> m_subQueues;
+  /// Number of queued items per timestamp
+  std::map<Time, uint32_t> m_timestamps;
 
   NS_LOG_TEMPLATE_DECLARE;                  //!< redefinition of the log component
 };
@@ -299,6 +299,12 @@ WifiPhy::GetTypeId (void)
                    MakeBooleanAccessor (&WifiPhy::GetShortPlcpPreambleSupported,
                                         &WifiPhy::SetShortPlcpPreambleSupported),
                    MakeBooleanChecker ())
+    .AddAttribute ("PayloadDurationCacheSize",
+                   "The maximum number of payload durations remembered by the PHY. "
+                   "The cache is emptied when full; zero disables it.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&WifiPhy::m_payloadDurationCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("FrameCaptureModel",
                    "Ptr to an object that implements the frame capture model",
                    PointerValue (),
@@ -372,6 +378,9 @@ WifiPhy::WifiPhy ()
     m_initialChannelNumber (0),
     m_totalAmpduSize (0),
     m_totalAmpduNumSymbols (0),
+    m_payloadDurationCacheSize (1024),
+    m_payloadDurationCacheHits (0),
+    m_payloadDurationCacheMisses (0),
     m_currentEvent (0),
     m_wifiRadioEnergyModel (0)
 {
@@ -395,6 +404,7 @@ WifiPhy::DoDispose (void)
   m_wifiRadioEnergyModel = 0;
   m_deviceRateSet.clear ();
   m_deviceMcsSet.clear ();
+  m_payloadDurationCache.clear ();
 }
 
 void
@@ -1202,7 +1212,7 @@ WifiPhy::SetFrequency (uint16_t frequency)
       DoFrequencySwitch (0);
       NS_LOG_DEBUG ("Setting frequency and channel number to zero");
       m_channelCenterFrequency = 0;
-      m_channelNumber = 0;
+      UpdateChannelNumber (0);
       return;
     }
   // If the user has configured both Frequency and ChannelNumber, Frequency
@@ -1216,7 +1226,7 @@ WifiPhy::SetFrequency (uint16_t frequency)
         {
           NS_LOG_DEBUG ("Channel frequency switched to " << frequency << "; channel number to " << +nch);
           m_channelCenterFrequency = frequency;
-          m_channelNumber = nch;
+          UpdateChannelNumber (nch);
         }
       else
         {
@@ -1230,7 +1240,7 @@ WifiPhy::SetFrequency (uint16_t frequency)
         {
           NS_LOG_DEBUG ("Channel frequency switched to " << frequency << "; channel number to " << 0);
           m_channelCenterFrequency = frequency;
-          m_channelNumber = 0;
+          UpdateChannelNumber (0);
         }
       else
         {
@@ -1379,7 +1389,7 @@ WifiPhy::SetChannelNumber (uint8_t nch)
       // DoChannelSwitch () because DoFrequencySwitch () should have been
       // called by the client
       NS_LOG_DEBUG ("Setting channel number to zero");
-      m_channelNumber = 0;
+      UpdateChannelNumber (0);
       return;
     }
 
@@ -1397,7 +1407,7 @@ WifiPhy::SetChannelNumber (uint8_t nch)
           NS_LOG_DEBUG ("Setting frequency to " << f.first << "; width to " << +f.second);
           m_channelCenterFrequency = f.first;
           SetChannelWidth (f.second);
-          m_channelNumber = nch;
+          UpdateChannelNumber (nch);
         }
       else
         {
@@ -1417,6 +1427,24 @@ WifiPhy::GetChannelNumber (void) const
   return m_channelNumber;
 }
 
+void
+WifiPhy::UpdateChannelNumber (uint8_t nch)
+{
+  NS_LOG_FUNCTION (this << +nch);
+  uint8_t oldChannelNumber = m_channelNumber;
+  m_channelNumber = nch;
+  if (nch != oldChannelNumber)
+    {
+      NotifyChannelNumberChange (oldChannelNumber);
+    }
+}
+
+void
+WifiPhy::NotifyChannelNumberChange (uint8_t oldChannelNumber)
+{
+  NS_LOG_FUNCTION (this << +oldChannelNumber);
+}
+
 bool
 WifiPhy::DoChannelSwitch (uint8_t nch)
 {
@@ -1940,6 +1968,62 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
 
 Time
 WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag)
+{
+  NS_LOG_FUNCTION (this << size << txVector.GetMode () << +mpdutype << +incFlag);
+  double numSymbols;
+  //the duration of the last MPDU of an A-MPDU depends on the previous ones
+  if (m_payloadDurationCacheSize == 0 || mpdutype == LAST_MPDU_IN_AGGREGATE)
+    {
+      return ComputePayloadDuration (size, txVector, frequency, mpdutype, incFlag, numSymbols);
+    }
+
+  WifiMode payloadMode = txVector.GetMode ();
+  uint64_t params = (static_cast<uint64_t> (payloadMode.GetUid ()) << 40)
+    | (static_cast<uint64_t> (txVector.GetChannelWidth ()) << 24)
+    | (static_cast<uint64_t> (txVector.GetGuardInterval ()) << 8)
+    | (static_cast<uint64_t> (txVector.GetNss ()) << 4)
+    | (static_cast<uint64_t> (txVector.IsStbc ()) << 3)
+    | (static_cast<uint64_t> (Is2_4Ghz (frequency)) << 2)
+    | (static_cast<uint64_t> (mpdutype));
+  std::pair<uint32_t, uint64_t> key = std::make_pair (size, (params << 8) | txVector.GetPreambleType ());
+  PayloadDurationCache::const_iterator it = m_payloadDurationCache.find (key);
+  if (it != m_payloadDurationCache.end ())
+    {
+      m_payloadDurationCacheHits++;
+      if (mpdutype == MPDU_IN_AGGREGATE && incFlag == 1)
+        {
+          m_totalAmpduSize += size;
+          m_totalAmpduNumSymbols += it->second.numSymbols;
+        }
+      return it->second.duration;
+    }
+
+  m_payloadDurationCacheMisses++;
+  if (m_payloadDurationCache.size () >= m_payloadDurationCacheSize)
+    {
+      m_payloadDurationCache.clear ();
+    }
+  PayloadDuration &entry = m_payloadDurationCache[key];
+  entry.duration = ComputePayloadDuration (size, txVector, frequency, mpdutype, incFlag, numSymbols);
+  entry.numSymbols = numSymbols;
+  return entry.duration;
+}
+
+uint64_t
+WifiPhy::GetPayloadDurationCacheHits (void) const
+{
+  return m_payloadDurationCacheHits;
+}
+
+uint64_t
+WifiPhy::GetPayloadDurationCacheMisses (void) const
+{
+  return m_payloadDurationCacheMisses;
+}
+
+Time
+WifiPhy::ComputePayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype,
+                                 uint8_t incFlag, double &numSymbols)
 {
   WifiMode payloadMode = txVector.GetMode ();
   WifiPreamble preamble = txVector.GetPreambleType ();
@@ -2113,7 +2197,7 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
 
   double numDataBitsPerSymbol = payloadMode.GetDataRate (txVector) * symbolDuration.GetNanoSeconds () / 1e9;
 
-  double numSymbols = 0;
+  numSymbols = 0;
   if (mpdutype == MPDU_IN_AGGREGATE && preamble != WIFI_PREAMBLE_NONE)
     {
       //First packet in an A-MPDU
@@ -2366,15 +2450,42 @@ WifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet, double rxPowerW, Tim
     }
 
   WifiTxVector txVector = tag.GetWifiTxVector ();
+  //Only the signals the PHY may synchronize on need an Event: the other ones
+  //are only recorded as interference power, without keeping a reference to
+  //the packet.
   Ptr<Event> event;
-  event = m_interference.Add (packet,
-                              txVector,
-                              rxDuration,
-                              rxPowerW);
+  bool captured = false;
+  WifiPhyState state = m_state->GetState ();
+  if (tag.GetFrameComplete () != 0)
+    {
+      if ((state == WifiPhyState::IDLE || state == WifiPhyState::CCA_BUSY)
+          && rxPowerW > m_edThresholdW)
+        {
+          event = Create<Event> (packet, txVector, rxDuration, rxPowerW);
+        }
+      else if (state == WifiPhyState::RX && m_frameCaptureModel != 0)
+        {
+          NS_ASSERT (m_currentEvent != 0);
+          Ptr<Event> newEvent = Create<Event> (packet, txVector, rxDuration, rxPowerW);
+          captured = m_frameCaptureModel->CaptureNewFrame (m_currentEvent, newEvent);
+          if (captured)
+            {
+              event = newEvent;
+            }
+        }
+    }
+  if (event != 0)
+    {
+      m_interference.Add (event);
+    }
+  else
+    {
+      m_interference.AddInterference (rxDuration, rxPowerW);
+    }
 
   //This function should be later split to check separately whether plcp preamble and plcp header can be successfully received.
   //Note: plcp preamble reception is not yet modeled.
-  if (m_state->GetState () == WifiPhyState::OFF)
+  if (state == WifiPhyState::OFF)
     {
       NS_LOG_DEBUG ("Cannot start RX because device is OFF");
       return;
@@ -2412,7 +2523,7 @@ WifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet, double rxPowerW, Tim
     }
 
   MpduType mpdutype = tag.GetMpduType ();
-  switch (m_state->GetState ())
+  switch (state)
     {
     case WifiPhyState::SWITCHING:
       NS_LOG_DEBUG ("drop packet because of channel switching");
@@ -2436,8 +2547,7 @@ WifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet, double rxPowerW, Tim
       break;
     case WifiPhyState::RX:
       NS_ASSERT (m_currentEvent != 0);
-      if (m_frameCaptureModel != 0
-          && m_frameCaptureModel->CaptureNewFrame (m_currentEvent, event))
+      if (captured)
         {
           AbortCurrentReception ();
           NS_LOG_DEBUG ("Switch to new packet");
@@ -2511,7 +2621,7 @@ WifiPhy::StartReceivePacket (Ptr<Packet> packet,
   WifiMode txMode = txVector.GetMode ();
 
   InterferenceHelper::SnrPer snrPer;
-  snrPer = m_interference.CalculatePlcpHeaderSnrPer (event);
+  snrPer = CalculatePlcpHeaderSnrPer (event);
 
   NS_LOG_DEBUG ("snr(dB)=" << RatioToDb (snrPer.snr) << ", per=" << snrPer.per);
 
@@ -2537,6 +2647,18 @@ WifiPhy::StartReceivePacket (Ptr<Packet> packet,
     }
 }
 
+InterferenceHelper::SnrPer
+WifiPhy::CalculatePlcpHeaderSnrPer (Ptr<Event> event) const
+{
+  return m_interference.CalculatePlcpHeaderSnrPer (event);
+}
+
+InterferenceHelper::SnrPer
+WifiPhy::CalculatePlcpPayloadSnrPer (Ptr<Event> event) const
+{
+  return m_interference.CalculatePlcpPayloadSnrPer (event);
+}
+
 void
 WifiPhy::EndReceive (Ptr<Packet> packet, WifiPreamble preamble, MpduType mpdutype, Ptr<Event> event)
 {
@@ -2545,7 +2667,7 @@ WifiPhy::EndReceive (Ptr<Packet> packet, WifiPreamble preamble, MpduType mpdutyp
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
 
   InterferenceHelper::SnrPer snrPer;
-  snrPer = m_interference.CalculatePlcpPayloadSnrPer (event);
+  snrPer = CalculatePlcpPayloadSnrPer (event);
   m_interference.NotifyRxEnd ();
   m_currentEvent = 0;
 
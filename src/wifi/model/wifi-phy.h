@@ -22,6 +22,7 @@
 #ifndef WIFI_PHY_H
 #define WIFI_PHY_H
 
+#include <map>
 #include "ns3/event-id.h"
 #include "wifi-mpdu-type.h"
 #include "wifi-phy-standard.h"
@@ -323,6 +324,15 @@ public:
    */
   Time GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag);
 
+  /**
+   * \return the number of payload durations found in the cache
+   */
+  uint64_t GetPayloadDurationCacheHits (void) const;
+  /**
+   * \return the number of payload durations computed because they were not in the cache
+   */
+  uint64_t GetPayloadDurationCacheMisses (void) const;
+
   /**
    * The WifiPhy::GetNModes() and WifiPhy::GetMode() methods are used
    * (e.g., by a WifiRemoteStationManager) to determine the set of
@@ -1486,6 +1496,34 @@ protected:
    * \see SetFrequency
    */
   bool DoFrequencySwitch (uint16_t frequency);
+  /**
+   * The default implementation does nothing.  This method is called
+   * whenever the channel number actually changes, whether through
+   * SetChannelNumber, SetFrequency or the configuration of the standard,
+   * after the new value has been stored.
+   *
+   * \brief Notify subclasses that the channel number has changed
+   * \param oldChannelNumber the previous channel number
+   */
+  virtual void NotifyChannelNumberChange (uint8_t oldChannelNumber);
+  /**
+   * The default implementation integrates the error rate of the PLCP header
+   * over every chunk of constant interference, through the InterferenceHelper.
+   *
+   * \brief Compute the SNR and PER of the PLCP header of a received frame
+   * \param event the event of the frame being received
+   * \return the SNR and PER
+   */
+  virtual InterferenceHelper::SnrPer CalculatePlcpHeaderSnrPer (Ptr<Event> event) const;
+  /**
+   * The default implementation integrates the error rate of the PLCP payload
+   * over every chunk of constant interference, through the InterferenceHelper.
+   *
+   * \brief Compute the SNR and PER of the PLCP payload of a received frame
+   * \param event the event of the frame being received
+   * \return the SNR and PER
+   */
+  virtual InterferenceHelper::SnrPer CalculatePlcpPayloadSnrPer (Ptr<Event> event) const;
 
   /**
    * Check if Phy state should move to CCA busy state based on current
@@ -1508,6 +1546,29 @@ protected:
   EventId m_endPlcpRxEvent;            //!< the end PLCP receive event
 
 private:
+  /**
+   * Store the channel number and call NotifyChannelNumberChange if it changed.
+   *
+   * \param nch the new channel number
+   */
+  void UpdateChannelNumber (uint8_t nch);
+
+  /**
+   * Compute the duration of the payload, updating the A-MPDU state if
+   * incFlag is 1.  The arguments are those of GetPayloadDuration.
+   *
+   * \param size the number of bytes in the packet to send
+   * \param txVector the TXVECTOR used for the transmission of this packet
+   * \param frequency the channel center frequency (MHz)
+   * \param mpdutype the type of the MPDU as defined in WifiPhy::MpduType.
+   * \param incFlag whether the A-MPDU state is to be updated
+   * \param numSymbols the number of symbols of the payload (output)
+   *
+   * \return the duration of the payload
+   */
+  Time ComputePayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype,
+                               uint8_t incFlag, double &numSymbols);
+
   /**
    * \brief post-construction setting of frequency and/or channel number
    *
@@ -1784,6 +1845,24 @@ private:
   uint32_t m_totalAmpduSize;     //!< Total size of the previously transmitted MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
   double m_totalAmpduNumSymbols; //!< Number of symbols previously transmitted for the MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
 
+  /**
+   * A cached payload duration
+   */
+  struct PayloadDuration
+  {
+    Time duration;     //!< the duration of the payload
+    double numSymbols; //!< the number of symbols of the payload
+  };
+  /**
+   * Payload durations, keyed by size and by the TXVECTOR parameters,
+   * MPDU type and band the duration depends on
+   */
+  typedef std::map<std::pair<uint32_t, uint64_t>, PayloadDuration> PayloadDurationCache;
+  PayloadDurationCache m_payloadDurationCache; //!< payload durations of non-final MPDUs
+  uint32_t m_payloadDurationCacheSize;         //!< maximum number of entries of m_payloadDurationCache
+  uint64_t m_payloadDurationCacheHits;         //!< number of payload durations found in the cache
+  uint64_t m_payloadDurationCacheMisses;       //!< number of payload durations not found in the cache
+
   Ptr<NetDevice>     m_device;   //!< Pointer to the device
   Ptr<MobilityModel> m_mobility; //!< Pointer to the mobility model
 
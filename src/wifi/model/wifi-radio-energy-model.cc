@@ -22,6 +22,7 @@
 #include "ns3/simulator.h"
 #include "ns3/pointer.h"
 #include "ns3/energy-source.h"
+#include "ns3/basic-energy-source.h"
 #include "wifi-radio-energy-model.h"
 #include "wifi-tx-current-model.h"
 
@@ -88,6 +89,7 @@ WifiRadioEnergyModel::GetTypeId (void)
 
 WifiRadioEnergyModel::WifiRadioEnergyModel ()
   : m_source (0),
+    m_basicSource (0),
     m_currentState (WifiPhyState::IDLE),
     m_lastUpdateTime (Seconds (0.0)),
     m_nPendingChangeState (0)
@@ -114,6 +116,7 @@ WifiRadioEnergyModel::SetEnergySource (const Ptr<EnergySource> source)
   NS_LOG_FUNCTION (this << source);
   NS_ASSERT (source != NULL);
   m_source = source;
+  m_basicSource = DynamicCast<BasicEnergySource> (source);
   m_switchToOffEvent.Cancel ();
   Time durationToOff = GetMaximumTimeInState (m_currentState);
   m_switchToOffEvent = Simulator::Schedule (durationToOff, &WifiRadioEnergyModel::ChangeState, this, WifiPhyState::OFF);
@@ -330,6 +333,19 @@ WifiRadioEnergyModel::ChangeState (int newState)
 {
   NS_LOG_FUNCTION (this << newState);
 
+  if (m_basicSource && m_nPendingChangeState == 0
+      && m_currentState != WifiPhyState::OFF && newState != WifiPhyState::OFF
+      && GetStateCurrentA (newState) == GetStateCurrentA (m_currentState)
+      && !m_basicSource->IsBatteryThresholdCrossed ())
+    {
+      // The total current drawn from the source, hence the remaining energy
+      // and the time at which it is depleted, do not change: the energy
+      // consumed since m_lastUpdateTime is integrated later.  An update that
+      // would report a depletion or a recharge is not skipped.
+      SetWifiRadioState ((WifiPhyState) newState);
+      return;
+    }
+
   m_nPendingChangeState++;
 
   if (m_nPendingChangeState > 1 && newState == WifiPhyState::OFF)
@@ -462,13 +478,20 @@ WifiRadioEnergyModel::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_source = NULL;
+  m_basicSource = 0;
   m_energyDepletionCallback.Nullify ();
 }
 
 double
 WifiRadioEnergyModel::DoGetCurrentA (void) const
 {
-  switch (m_currentState)
+  return GetStateCurrentA (m_currentState);
+}
+
+double
+WifiRadioEnergyModel::GetStateCurrentA (int state) const
+{
+  switch (state)
     {
     case WifiPhyState::IDLE:
       return m_idleCurrentA;
@@ -485,7 +508,7 @@ WifiRadioEnergyModel::DoGetCurrentA (void) const
     case WifiPhyState::OFF:
       return 0.0;
     default:
-      NS_FATAL_ERROR ("WifiRadioEnergyModel: undefined radio state " << m_currentState);
+      NS_FATAL_ERROR ("WifiRadioEnergyModel: undefined radio state " << state);
     }
 }
 
@@ -32,6 +32,7 @@
 namespace ns3 {
 
 class WifiTxCurrentModel;
+class BasicEnergySource;
 
 /**
  * \ingroup energy
@@ -359,6 +360,16 @@ public:
    * \param newState New state the wifi radio is in.
    *
    * Implements DeviceEnergyModel::ChangeState.
+   *
+   * Only the transitions between two states drawing the same current
+   * (e.g., IDLE and CCA_BUSY with the default currents) are lazy, and only
+   * when the energy source is a BasicEnergySource: neither the energy source
+   * nor the predicted depletion time is updated, since neither changes, and
+   * the energy consumed is integrated at the next update.  Any other
+   * transition still updates the energy source, which integrates the total
+   * current of all its device energy models and harvesters, and notifies
+   * them of the energy change.  A LiIonEnergySource is always updated, as
+   * its supply voltage depends on the remaining energy.
    */
   void ChangeState (int newState);
 
@@ -406,6 +417,13 @@ private:
    */
   double DoGetCurrentA (void) const;
 
+  /**
+   * \param state the wifi state
+   *
+   * \returns the current drawn in that state.
+   */
+  double GetStateCurrentA (int state) const;
+
   /**
    * \param state New state the radio device is currently in.
    *
@@ -415,6 +433,7 @@ private:
   void SetWifiRadioState (const WifiPhyState state);
 
   Ptr<EnergySource> m_source; ///< energy source
+  Ptr<BasicEnergySource> m_basicSource; ///< the source, if it is a BasicEnergySource, whose supply voltage is constant
 
   // Member variables for current draw in different radio modes.
   double m_txCurrentA; ///< transmit current
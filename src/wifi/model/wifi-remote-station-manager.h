@@ -21,6 +21,7 @@
 #ifndef WIFI_REMOTE_STATION_MANAGER_H
 #define WIFI_REMOTE_STATION_MANAGER_H
 
+#include <unordered_map>
 #include "ns3/traced-callback.h"
 #include "ns3/object.h"
 #include "ns3/nstime.h"
@@ -1401,6 +1402,14 @@ private:
    * A vector of WifiRemoteStationStates
    */
   typedef std::vector <WifiRemoteStationState *> StationStates;
+  /**
+   * The state of each known station, by address
+   */
+  typedef std::unordered_map <Mac48Address, WifiRemoteStationState *, Mac48AddressHash> StationStateIndex;
+  /**
+   * The WifiRemoteStations (one per TID) of each known station, by address
+   */
+  typedef std::unordered_map <Mac48Address, Stations, Mac48AddressHash> StationIndex;
 
   /**
    * This is a pointer to the WifiPhy associated with this
@@ -1433,6 +1442,8 @@ private:
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
+  StationStateIndex m_stateIndex; //!< m_states by address
+  StationIndex m_stationIndex;    //!< m_stations by address
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
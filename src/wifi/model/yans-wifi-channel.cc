@@ -18,10 +18,14 @@
  * Author: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/propagation-loss-model.h"
@@ -52,11 +56,28 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("RxSensitivityCull",
+                   "Receive power (dBm, including the receiver RX gain) below which a "
+                   "transmission is not delivered to a receiver at all: no event is "
+                   "scheduled, so the receiver does not see it even as interference.",
+                   DoubleValue (-std::numeric_limits<double>::max ()),
+                   MakeDoubleAccessor (&YansWifiChannel::m_rxSensitivityCull),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SpatialIndexRange",
+                   "Distance (m) beyond which receivers are never considered. When "
+                   "strictly positive, stationary receivers are kept in a uniform grid "
+                   "with this cell size, so that only nearby receivers are visited. "
+                   "Zero disables the index.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::SetSpatialIndexRange,
+                                       &YansWifiChannel::GetSpatialIndexRange),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_indexRange (0.0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -67,6 +88,51 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_index.size (); i++)
+    {
+      if (m_index[i].mobility != 0)
+        {
+          m_index[i].mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                              MakeBoundCallback (&YansWifiChannel::CourseChanged,
+                                                                                 this, i));
+        }
+    }
+  m_index.clear ();
+  m_cells.clear ();
+  m_moving.clear ();
+  m_unindexed.clear ();
+  m_channelBuckets.clear ();
+  m_phyList.clear ();
+  Channel::DoDispose ();
+}
+
+void
+YansWifiChannel::SetSpatialIndexRange (double range)
+{
+  NS_LOG_FUNCTION (this << range);
+  m_indexRange = range;
+  //rebuild the grid with the new cell size
+  m_cells.clear ();
+  m_moving.clear ();
+  for (uint32_t i = 0; i < m_index.size (); i++)
+    {
+      if (m_index[i].mobility != 0)
+        {
+          Insert (i);
+        }
+    }
+}
+
+double
+YansWifiChannel::GetSpatialIndexRange (void) const
+{
+  return m_indexRange;
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (const Ptr<PropagationLossModel> loss)
 {
@@ -87,40 +153,167 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
   NS_LOG_FUNCTION (this << sender << packet << txPowerDbm << duration.GetSeconds ());
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+  if (m_indexRange > 0)
     {
-      if (sender != (*i))
+      UpdateIndex ();
+      GetCandidates (senderMobility->GetPosition ());
+      for (std::vector<uint32_t>::const_iterator i = m_candidates.begin (); i != m_candidates.end (); i++)
         {
-          //For now don't account for inter channel interference nor channel bonding
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          Ptr<YansWifiPhy> receiver = m_phyList[*i];
+          if (m_index[*i].mobility != 0
+              && senderMobility->GetDistanceFrom (m_index[*i].mobility) > m_indexRange)
             {
               continue;
             }
+          Deliver (sender, senderMobility, receiver, packet, txPowerDbm, duration);
+        }
+      return;
+    }
+  ChannelBuckets::const_iterator bucket = m_channelBuckets.find (sender->GetChannelNumber ());
+  NS_ASSERT (bucket != m_channelBuckets.end ());
+  for (std::vector<uint32_t>::const_iterator i = bucket->second.begin (); i != bucket->second.end (); i++)
+    {
+      Deliver (sender, senderMobility, m_phyList[*i], packet, txPowerDbm, duration);
+    }
+}
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
+void
+YansWifiChannel::Deliver (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility, Ptr<YansWifiPhy> receiver,
+                          Ptr<const Packet> packet, double txPowerDbm, Time duration) const
+{
+  if (sender == receiver)
+    {
+      return;
+    }
+  //For now don't account for inter channel interference nor channel bonding
+  if (receiver->GetChannelNumber () != sender->GetChannelNumber ())
+    {
+      return;
+    }
+
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+  double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+  if (rxPowerDbm + receiver->GetRxGain () < m_rxSensitivityCull)
+    {
+      NS_LOG_DEBUG ("culled: rxPower=" << rxPowerDbm << "dbm, " <<
+                    "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m");
+      return;
+    }
+  Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+  NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+  Ptr<Packet> copy = packet->Copy ();
+  Ptr<NetDevice> dstNetDevice = receiver->GetDevice ();
+  uint32_t dstNode;
+  if (dstNetDevice == 0)
+    {
+      dstNode = 0xffffffff;
+    }
+  else
+    {
+      dstNode = dstNetDevice->GetNode ()->GetId ();
+    }
+
+  Simulator::ScheduleWithContext (dstNode,
+                                  delay, &YansWifiChannel::Receive,
+                                  receiver, copy, rxPowerDbm, duration);
+}
+
+void
+YansWifiChannel::GetCandidates (const Vector &position) const
+{
+  m_candidates.clear ();
+  Cell center = GetCell (position);
+  for (int64_t x = center.first - 1; x <= center.first + 1; x++)
+    {
+      for (int64_t y = center.second - 1; y <= center.second + 1; y++)
+        {
+          CellMap::const_iterator cell = m_cells.find (Cell (x, y));
+          if (cell != m_cells.end ())
             {
-              dstNode = dstNetDevice->GetNode ()->GetId ();
+              m_candidates.insert (m_candidates.end (), cell->second.begin (), cell->second.end ());
             }
+        }
+    }
+  m_candidates.insert (m_candidates.end (), m_moving.begin (), m_moving.end ());
+  m_candidates.insert (m_candidates.end (), m_unindexed.begin (), m_unindexed.end ());
+  //deliver in the order of m_phyList, as without the index
+  std::sort (m_candidates.begin (), m_candidates.end ());
+}
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive,
-                                          (*i), copy, rxPowerDbm, duration);
+void
+YansWifiChannel::UpdateIndex (void) const
+{
+  for (std::vector<uint32_t>::iterator i = m_unindexed.begin (); i != m_unindexed.end (); )
+    {
+      Ptr<MobilityModel> mobility = m_phyList[*i]->GetMobility ();
+      if (mobility == 0)
+        {
+          i++;
+          continue;
         }
+      m_index[*i].mobility = mobility;
+      mobility->TraceConnectWithoutContext ("CourseChange",
+                                            MakeBoundCallback (&YansWifiChannel::CourseChanged, this, *i));
+      Insert (*i);
+      i = m_unindexed.erase (i);
     }
 }
 
+YansWifiChannel::Cell
+YansWifiChannel::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int64_t> (std::floor (position.x / m_indexRange)),
+               static_cast<int64_t> (std::floor (position.y / m_indexRange)));
+}
+
+void
+YansWifiChannel::Insert (uint32_t i) const
+{
+  IndexEntry &entry = m_index[i];
+  Vector velocity = entry.mobility->GetVelocity ();
+  entry.moving = velocity.x != 0 || velocity.y != 0 || velocity.z != 0;
+  if (entry.moving || m_indexRange <= 0)
+    {
+      m_moving.push_back (i);
+    }
+  else
+    {
+      entry.cell = GetCell (entry.mobility->GetPosition ());
+      m_cells[entry.cell].push_back (i);
+    }
+}
+
+void
+YansWifiChannel::Remove (uint32_t i) const
+{
+  IndexEntry &entry = m_index[i];
+  std::vector<uint32_t> *list = &m_moving;
+  CellMap::iterator cell = m_cells.end ();
+  if (!entry.moving && m_indexRange > 0)
+    {
+      cell = m_cells.find (entry.cell);
+      NS_ASSERT (cell != m_cells.end ());
+      list = &cell->second;
+    }
+  std::vector<uint32_t>::iterator it = std::find (list->begin (), list->end (), i);
+  NS_ASSERT (it != list->end ());
+  *it = list->back ();
+  list->pop_back ();
+  if (cell != m_cells.end () && list->empty ())
+    {
+      m_cells.erase (cell);
+    }
+}
+
+void
+YansWifiChannel::CourseChanged (const YansWifiChannel *channel, uint32_t i, Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (channel << i << mobility);
+  channel->Remove (i);
+  channel->Insert (i);
+}
+
 void
 YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<Packet> packet, double rxPowerDbm, Time duration)
 {
@@ -144,9 +337,34 @@ void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
+  IndexEntry entry;
+  entry.moving = false;
+  m_index.push_back (entry);
+  m_unindexed.push_back (m_phyList.size ());
+  m_channelBuckets[phy->GetChannelNumber ()].push_back (m_phyList.size ());
   m_phyList.push_back (phy);
 }
 
+void
+YansWifiChannel::NotifyChannelNumberChange (Ptr<YansWifiPhy> phy, uint8_t oldChannelNumber)
+{
+  NS_LOG_FUNCTION (this << phy << +oldChannelNumber);
+  uint32_t index = std::find (m_phyList.begin (), m_phyList.end (), phy) - m_phyList.begin ();
+  NS_ASSERT (index < m_phyList.size ());
+
+  ChannelBuckets::iterator bucket = m_channelBuckets.find (oldChannelNumber);
+  NS_ASSERT (bucket != m_channelBuckets.end ());
+  bucket->second.erase (std::find (bucket->second.begin (), bucket->second.end (), index));
+  if (bucket->second.empty ())
+    {
+      m_channelBuckets.erase (bucket);
+    }
+
+  //keep each bucket sorted, so that receivers are visited in m_phyList order
+  std::vector<uint32_t> &newBucket = m_channelBuckets[phy->GetChannelNumber ()];
+  newBucket.insert (std::lower_bound (newBucket.begin (), newBucket.end (), index), index);
+}
+
 int64_t
 YansWifiChannel::AssignStreams (int64_t stream)
 {
@@ -21,7 +21,10 @@
 #ifndef YANS_WIFI_CHANNEL_H
 #define YANS_WIFI_CHANNEL_H
 
+#include <map>
+#include <vector>
 #include "ns3/channel.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -31,6 +34,7 @@ class PropagationDelayModel;
 class YansWifiPhy;
 class Packet;
 class Time;
+class MobilityModel;
 
 /**
  * \brief a channel to interconnect ns3::YansWifiPhy objects.
@@ -40,6 +44,26 @@ class Time;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * By default, every transmission is delivered to every other PHY on the
+ * channel.  Two optional mechanisms reduce this cost in large topologies:
+ *  - the SpatialIndexRange attribute keeps stationary receivers in a
+ *    uniform grid whose cell size is that range, kept up to date through
+ *    the CourseChange trace of their mobility models.  Only receivers in
+ *    the sender's cell and the adjacent cells, and within the range, are
+ *    considered.  Receivers with a non-zero velocity are always considered,
+ *    since they move without course change notifications.
+ *  - the RxSensitivityCull attribute drops, before any event is scheduled,
+ *    the receptions whose power is below the given threshold.
+ * Culled receivers do not see the signal at all, not even as
+ * interference, so the range and threshold must be chosen below anything
+ * the receivers could detect.
+ *
+ * Since signals are only delivered to PHYs operating on the sender's
+ * channel number, the PHYs are also kept in one bucket per channel number,
+ * updated by YansWifiPhy whenever its channel number changes.  Without the
+ * spatial index, Send only visits the sender's bucket.  A model of
+ * adjacent channel leakage would visit the neighbouring buckets as well.
  */
 class YansWifiChannel : public Channel
 {
@@ -53,6 +77,16 @@ public:
   YansWifiChannel ();
   virtual ~YansWifiChannel ();
 
+  /**
+   * \param range the maximum distance (m) at which a receiver is considered;
+   *        zero disables the spatial index
+   */
+  void SetSpatialIndexRange (double range);
+  /**
+   * \return the spatial index range (m), zero if disabled
+   */
+  double GetSpatialIndexRange (void) const;
+
   //inherited from Channel.
   virtual std::size_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
@@ -64,6 +98,16 @@ public:
    */
   void Add (Ptr<YansWifiPhy> phy);
 
+  /**
+   * Move a PHY to the bucket of its new channel number.  This method should
+   * not be invoked by normal users; it is invoked by YansWifiPhy when its
+   * channel number changes.
+   *
+   * \param phy the YansWifiPhy whose channel number changed
+   * \param oldChannelNumber the previous channel number of the PHY
+   */
+  void NotifyChannelNumberChange (Ptr<YansWifiPhy> phy, uint8_t oldChannelNumber);
+
   /**
    * \param loss the new propagation loss model.
    */
@@ -98,12 +142,85 @@ public:
   int64_t AssignStreams (int64_t stream);
 
 
+protected:
+  virtual void DoDispose (void);
+
 private:
   /**
    * A vector of pointers to YansWifiPhy.
    */
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
 
+  /// The PHYs (indices into m_phyList, in ascending order) using each channel number
+  typedef std::map<uint8_t, std::vector<uint32_t> > ChannelBuckets;
+
+  /// A grid cell, identified by its x and y indices
+  typedef std::pair<int64_t, int64_t> Cell;
+  /// The PHYs (indices into m_phyList) located in each cell
+  typedef std::map<Cell, std::vector<uint32_t> > CellMap;
+
+  /**
+   * Spatial index state of a PHY
+   */
+  struct IndexEntry
+  {
+    Ptr<MobilityModel> mobility;  //!< the mobility model, null until it is known
+    bool moving;                  //!< true if the PHY is in m_moving instead of a cell
+    Cell cell;                    //!< the cell holding the PHY, if not moving
+  };
+
+  /**
+   * Deliver a transmission to one PHY, unless it is the sender, it is on a
+   * different channel or its receive power is below RxSensitivityCull.
+   *
+   * \param sender the phy object from which the packet is originating
+   * \param senderMobility the mobility model of the sender
+   * \param receiver the phy object to deliver the packet to
+   * \param packet the packet to send
+   * \param txPowerDbm the tx power associated to the packet, in dBm
+   * \param duration the transmission duration associated with the packet
+   */
+  void Deliver (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility, Ptr<YansWifiPhy> receiver,
+                Ptr<const Packet> packet, double txPowerDbm, Time duration) const;
+
+  /**
+   * Collect, in ascending order, the indices of the PHYs which may be
+   * within the spatial index range of the given position.
+   *
+   * \param position the position of the sender
+   */
+  void GetCandidates (const Vector &position) const;
+  /**
+   * Add to the spatial index the PHYs whose mobility model was unknown so far.
+   */
+  void UpdateIndex (void) const;
+  /**
+   * Insert a PHY in the cell matching its current position, or in the list
+   * of moving PHYs.
+   *
+   * \param i the index of the PHY
+   */
+  void Insert (uint32_t i) const;
+  /**
+   * Remove a PHY from its cell or from the list of moving PHYs.
+   *
+   * \param i the index of the PHY
+   */
+  void Remove (uint32_t i) const;
+  /**
+   * \param position a position
+   * \return the grid cell containing the position
+   */
+  Cell GetCell (const Vector &position) const;
+  /**
+   * Course change trace sink, moving a PHY to its new cell.
+   *
+   * \param channel the channel
+   * \param i the index of the PHY
+   * \param mobility the mobility model which changed course
+   */
+  static void CourseChanged (const YansWifiChannel *channel, uint32_t i, Ptr<const MobilityModel> mobility);
+
   /**
    * This method is scheduled by Send for each associated YansWifiPhy.
    * The method then calls the corresponding YansWifiPhy that the first
@@ -119,6 +236,15 @@ private:
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  ChannelBuckets m_channelBuckets;     //!< PHYs by channel number
+  double m_rxSensitivityCull;          //!< receive power (dBm) below which receptions are dropped
+  double m_indexRange;                 //!< spatial index cell size and range (m), zero if disabled
+
+  mutable std::vector<IndexEntry> m_index;     //!< spatial index state, parallel to m_phyList
+  mutable CellMap m_cells;                     //!< stationary PHYs, by cell
+  mutable std::vector<uint32_t> m_moving;      //!< moving PHYs
+  mutable std::vector<uint32_t> m_unindexed;   //!< PHYs without a known mobility model
+  mutable std::vector<uint32_t> m_candidates;  //!< scratch space for GetCandidates
 };
 
 } //namespace ns3
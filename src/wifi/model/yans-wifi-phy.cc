@@ -66,6 +66,16 @@ YansWifiPhy::GetChannel (void) const
   return m_channel;
 }
 
+void
+YansWifiPhy::NotifyChannelNumberChange (uint8_t oldChannelNumber)
+{
+  NS_LOG_FUNCTION (this << +oldChannelNumber);
+  if (m_channel != 0)
+    {
+      m_channel->NotifyChannelNumberChange (this, oldChannelNumber);
+    }
+}
+
 void
 YansWifiPhy::SetChannel (const Ptr<YansWifiChannel> channel)
 {
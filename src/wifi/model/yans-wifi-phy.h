@@ -78,6 +78,7 @@ public:
 protected:
   // Inherited
   virtual void DoDispose (void);
+  virtual void NotifyChannelNumberChange (uint8_t oldChannelNumber);
 
 
 private:
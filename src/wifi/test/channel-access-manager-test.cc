@@ -264,6 +264,19 @@ private:
    * \param duration the duration
    */
   void AddRxStartEvt (uint64_t at, uint64_t duration);
+  /**
+   * Add a check of the access timeout counters of the ChannelAccessManager
+   * \param at the event time
+   * \param nSchedules the expected number of access timeouts scheduled
+   * \param nAvoided the expected number of avoided reschedules
+   */
+  void AddAccessTimeoutCheck (uint64_t at, uint64_t nSchedules, uint64_t nAvoided);
+  /**
+   * Check the access timeout counters of the ChannelAccessManager
+   * \param nSchedules the expected number of access timeouts scheduled
+   * \param nAvoided the expected number of avoided reschedules
+   */
+  void DoAccessTimeoutCheck (uint64_t nSchedules, uint64_t nAvoided);
 
   typedef std::vector<Ptr<TxopTest> > TxopTests; //!< the TXOP tests typedef
 
@@ -587,6 +600,21 @@ ChannelAccessManagerTest::AddRxStartEvt (uint64_t at, uint64_t duration)
                        MicroSeconds (duration));
 }
 
+void
+ChannelAccessManagerTest::AddAccessTimeoutCheck (uint64_t at, uint64_t nSchedules, uint64_t nAvoided)
+{
+  Simulator::Schedule (MicroSeconds (at) - Now (),
+                       &ChannelAccessManagerTest::DoAccessTimeoutCheck, this,
+                       nSchedules, nAvoided);
+}
+
+void
+ChannelAccessManagerTest::DoAccessTimeoutCheck (uint64_t nSchedules, uint64_t nAvoided)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_ChannelAccessManager->GetNAccessTimeoutSchedules (), nSchedules, "Unexpected number of access timeouts");
+  NS_TEST_EXPECT_MSG_EQ (m_ChannelAccessManager->GetNAvoidedReschedules (), nAvoided, "Unexpected number of avoided reschedules");
+}
+
 void
 ChannelAccessManagerTest::DoRun (void)
 {
@@ -922,6 +950,30 @@ ChannelAccessManagerTest::DoRun (void)
   AddAccessRequest (101, 2, 110, 0);
   ExpectCollision (101, 0, 0); //backoff: 0 slots
   EndTest ();
+
+  // Check that the access timeout scheduled for the first backoff end is
+  // kept when a second DCF requests access with a later backoff end, and
+  // that it is only rescheduled when the earliest backoff end changes.
+  //
+  //  20          60     66      70   72     78      82       86   88
+  //   |    rx     | sifs | aifsn | tx | sifs | aifsn | bslot0 | tx |
+  //        |    |
+  //       30    40 access requests: backoff slots 0 and 1
+  //
+  // The access timeout is scheduled at 30 (for 70) and kept at 40.  At 70,
+  // it is scheduled for the end of the ACK timeout started by the first
+  // transmission, then rescheduled at 72, when the ACK timeout is reset.
+  StartTest (4, 6, 10);
+  AddDcfState (1);
+  AddDcfState (1);
+  AddRxOkEvt (20, 40);
+  AddAccessRequest (30, 2, 70, 0);
+  ExpectCollision (30, 0, 0); //backoff: 0 slots
+  AddAccessRequest (40, 2, 86, 1);
+  ExpectCollision (40, 1, 1); //backoff: 1 slot
+  AddAccessTimeoutCheck (50, 1, 1);
+  AddAccessTimeoutCheck (100, 3, 1);
+  EndTest ();
 }
 
 
@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/yans-wifi-phy.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -426,6 +427,91 @@ TxDurationTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (retval, true, "an 802.11ax duration failed");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Payload duration cache test
+ *
+ * The same sequence of single MPDUs and A-MPDUs is timed, twice, by a PHY
+ * with the payload duration cache and by a PHY without it.  The durations
+ * must be identical, including those of the last MPDUs of the A-MPDUs,
+ * which depend on the A-MPDU state updated for the preceding MPDUs.
+ */
+class TxDurationCacheTest : public TestCase
+{
+public:
+  TxDurationCacheTest ();
+  virtual ~TxDurationCacheTest ();
+  virtual void DoRun (void);
+};
+
+TxDurationCacheTest::TxDurationCacheTest ()
+  : TestCase ("Wifi payload duration cache")
+{
+}
+
+TxDurationCacheTest::~TxDurationCacheTest ()
+{
+}
+
+void
+TxDurationCacheTest::DoRun (void)
+{
+  Ptr<YansWifiPhy> cached = CreateObject<YansWifiPhy> ();
+  Ptr<YansWifiPhy> reference = CreateObject<YansWifiPhy> ();
+  reference->SetAttribute ("PayloadDurationCacheSize", UintegerValue (0));
+
+  WifiTxVector txVectors[4];
+  txVectors[0].SetMode (WifiPhy::GetOfdmRate54Mbps ());
+  txVectors[0].SetPreambleType (WIFI_PREAMBLE_LONG);
+  txVectors[1].SetMode (WifiPhy::GetHtMcs7 ());
+  txVectors[1].SetPreambleType (WIFI_PREAMBLE_HT_MF);
+  txVectors[1].SetGuardInterval (400);
+  txVectors[2].SetMode (WifiPhy::GetVhtMcs9 ());
+  txVectors[2].SetPreambleType (WIFI_PREAMBLE_VHT);
+  txVectors[2].SetChannelWidth (80);
+  txVectors[3].SetMode (WifiPhy::GetHeMcs11 ());
+  txVectors[3].SetPreambleType (WIFI_PREAMBLE_HE_SU);
+  txVectors[3].SetGuardInterval (3200);
+  uint32_t sizes[3] = {14, 1536, 3839};
+
+  for (uint32_t pass = 0; pass < 2; pass++)
+    {
+      for (uint32_t t = 0; t < 4; t++)
+        {
+          for (uint32_t s = 0; s < 3; s++)
+            {
+              uint16_t frequency = (s == 1) ? CHANNEL_1_MHZ : CHANNEL_36_MHZ;
+              WifiTxVector txVector = txVectors[t];
+              NS_TEST_EXPECT_MSG_EQ (cached->CalculateTxDuration (sizes[s], txVector, frequency),
+                                     reference->CalculateTxDuration (sizes[s], txVector, frequency),
+                                     "Wrong duration of a single MPDU");
+              if (txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_OFDM)
+                {
+                  continue;
+                }
+              //an A-MPDU of four MPDUs, where each MPDU is timed twice, as MacLow does
+              for (uint32_t i = 0; i < 4; i++)
+                {
+                  MpduType mpdutype = (i == 3) ? LAST_MPDU_IN_AGGREGATE : MPDU_IN_AGGREGATE;
+                  for (uint8_t incFlag = 0; incFlag < 2; incFlag++)
+                    {
+                      NS_TEST_EXPECT_MSG_EQ (cached->GetPayloadDuration (sizes[s] + i, txVector, frequency, mpdutype, incFlag),
+                                             reference->GetPayloadDuration (sizes[s] + i, txVector, frequency, mpdutype, incFlag),
+                                             "Wrong duration of MPDU " << i << " of an A-MPDU");
+                    }
+                  txVector.SetPreambleType (WIFI_PREAMBLE_NONE);
+                }
+            }
+        }
+    }
+
+  NS_TEST_EXPECT_MSG_GT (cached->GetPayloadDurationCacheHits (), 0, "Expected durations found in the cache");
+  NS_TEST_EXPECT_MSG_EQ (cached->GetPayloadDurationCacheMisses (), 4 * 3 + 3 * 3 * 3, "Unexpected number of cache misses");
+  NS_TEST_EXPECT_MSG_EQ (reference->GetPayloadDurationCacheHits (), 0, "Expected no cache");
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -442,6 +528,7 @@ TxDurationTestSuite::TxDurationTestSuite ()
   : TestSuite ("devices-wifi-tx-duration", UNIT)
 {
   AddTestCase (new TxDurationTest, TestCase::QUICK);
+  AddTestCase (new TxDurationCacheTest, TestCase::QUICK);
 }
 
 static TxDurationTestSuite g_txDurationTestSuite; ///< the test suite
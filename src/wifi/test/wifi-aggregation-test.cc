@@ -28,6 +28,7 @@
 #include "ns3/mac-tx-middle.h"
 #include "ns3/msdu-aggregator.h"
 #include "ns3/mpdu-aggregator.h"
+#include "ns3/ampdu-subframe-header.h"
 #include "ns3/mgt-headers.h"
 #include "ns3/wifi-remote-station-manager.h"
 
@@ -404,6 +405,68 @@ TwoLevelAggregationTest::DoRun (void)
   m_txop = 0;
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief MPDU Deaggregation Test
+ */
+class MpduDeaggregationTest : public TestCase
+{
+public:
+  MpduDeaggregationTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpduDeaggregationTest::MpduDeaggregationTest ()
+  : TestCase ("Check the correctness of MPDU deaggregation")
+{
+}
+
+void
+MpduDeaggregationTest::DoRun (void)
+{
+  Ptr<MpduAggregator> mpduAggregator = CreateObject<MpduAggregator> ();
+  mpduAggregator->SetMaxAmpduSize (65535);
+
+  /*
+   * Deaggregate an A-MPDU made of three MPDUs, the first two being padded.
+   */
+  uint32_t sizes[] = {101, 50, 203};
+  Ptr<Packet> ampdu = Create<Packet> ();
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      bool result = mpduAggregator->Aggregate (Create<Packet> (sizes[i]), ampdu);
+      NS_TEST_EXPECT_MSG_EQ (result, true, "MPDU not aggregated");
+    }
+  NS_TEST_EXPECT_MSG_EQ (ampdu->GetSize (), 4 + 101 + 3 + 4 + 50 + 2 + 4 + 203, "A-MPDU size is not correct");
+
+  MpduAggregator::DeaggregatedMpdus mpdus = MpduAggregator::Deaggregate (ampdu);
+  NS_TEST_ASSERT_MSG_EQ (mpdus.size (), 3, "wrong number of deaggregated MPDUs");
+  uint32_t i = 0;
+  for (MpduAggregator::DeaggregatedMpdusCI it = mpdus.begin (); it != mpdus.end (); it++, i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (it->first->GetSize (), sizes[i], "wrong size of MPDU " << i);
+      NS_TEST_EXPECT_MSG_EQ (it->second.GetLength (), sizes[i], "wrong length in subframe header " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (mpdus.back ().first, ampdu, "the last MPDU should not be copied");
+
+  /*
+   * Deaggregate a single padded A-MPDU subframe, as delivered by the PHY.
+   */
+  Ptr<Packet> subframe = Create<Packet> (101);
+  mpduAggregator->AddHeaderAndPad (subframe, false, false);
+  NS_TEST_EXPECT_MSG_EQ (subframe->GetSize (), 4 + 101 + 3, "A-MPDU subframe size is not correct");
+
+  mpdus = MpduAggregator::Deaggregate (subframe);
+  NS_TEST_ASSERT_MSG_EQ (mpdus.size (), 1, "wrong number of deaggregated MPDUs");
+  NS_TEST_EXPECT_MSG_EQ (mpdus.front ().first, subframe, "the MPDU should not be copied");
+  NS_TEST_EXPECT_MSG_EQ (subframe->GetSize (), 101, "padding not removed");
+  NS_TEST_EXPECT_MSG_EQ (mpdus.front ().second.GetEof (), false, "wrong EOF field");
+}
+
 
 /**
  * \ingroup wifi-test
@@ -422,6 +485,7 @@ WifiAggregationTestSuite::WifiAggregationTestSuite ()
 {
   AddTestCase (new AmpduAggregationTest, TestCase::QUICK);
   AddTestCase (new TwoLevelAggregationTest, TestCase::QUICK);
+  AddTestCase (new MpduDeaggregationTest, TestCase::QUICK);
 }
 
 static WifiAggregationTestSuite g_wifiAggregationTestSuite; ///< the test suite
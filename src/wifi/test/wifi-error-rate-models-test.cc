@@ -22,6 +22,10 @@
 #include "ns3/test.h"
 #include "ns3/nist-error-rate-model.h"
 #include "ns3/dsss-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/table-error-rate-model.h"
+#include "ns3/pointer.h"
+#include "ns3/double.h"
 #include "ns3/wifi-tx-vector.h"
 
 using namespace ns3;
@@ -291,6 +295,144 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models Test Case Table
+ *
+ * Compare the chunk success rates interpolated by a TableErrorRateModel
+ * with the ones of the NIST and YANS models it wraps, for OFDM, HT and
+ * DSSS modes, at SNR values in between the grid points.
+ */
+class WifiErrorRateModelsTestCaseTable : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTable ();
+  virtual ~WifiErrorRateModelsTestCaseTable ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check a table against the model it wraps
+   * \param model the wrapped model
+   * \param mode the mode to check
+   * \param channelWidth the channel width
+   */
+  void CheckModel (Ptr<ErrorRateModel> model, WifiMode mode, uint16_t channelWidth);
+};
+
+WifiErrorRateModelsTestCaseTable::WifiErrorRateModelsTestCaseTable ()
+  : TestCase ("WifiErrorRateModel test case table")
+{
+}
+
+WifiErrorRateModelsTestCaseTable::~WifiErrorRateModelsTestCaseTable ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTable::CheckModel (Ptr<ErrorRateModel> model, WifiMode mode, uint16_t channelWidth)
+{
+  uint64_t nbits = 2000 * 8;
+  WifiTxVector txVector;
+  txVector.SetMode (mode);
+  txVector.SetChannelWidth (channelWidth);
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  table->SetAttribute ("ErrorRateModel", PointerValue (model));
+
+  for (double snrDb = -12.0; snrDb < 45.0; snrDb += 0.13)
+    {
+      double snr = std::pow (10.0, snrDb / 10.0);
+      double expected = model->GetChunkSuccessRate (mode, txVector, snr, nbits);
+      double actual = table->GetChunkSuccessRate (mode, txVector, snr, nbits);
+      NS_TEST_EXPECT_MSG_EQ_TOL (actual, expected, 0.001, "Wrong success rate of " << mode << " at " << snrDb << " dB");
+      if (snrDb < -10.0 || snrDb > 40.0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (actual, expected, "SNR values out of the table should use the wrapped model");
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (table->GetNTables (), 1, "Expected a single table");
+
+  //changing the grid discards the tables
+  table->SetAttribute ("Resolution", DoubleValue (0.1));
+  NS_TEST_EXPECT_MSG_EQ (table->GetNTables (), 0, "Expected the tables to be discarded");
+}
+
+void
+WifiErrorRateModelsTestCaseTable::DoRun (void)
+{
+  Ptr<ErrorRateModel> models[2] = {CreateObject<NistErrorRateModel> (), CreateObject<YansErrorRateModel> ()};
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      CheckModel (models[i], WifiMode ("OfdmRate6Mbps"), 20);
+      CheckModel (models[i], WifiMode ("OfdmRate24Mbps"), 20);
+      CheckModel (models[i], WifiMode ("OfdmRate54Mbps"), 20);
+      CheckModel (models[i], WifiMode ("HtMcs7"), 40);
+      CheckModel (models[i], WifiMode ("DsssRate1Mbps"), 22);
+      CheckModel (models[i], WifiMode ("DsssRate11Mbps"), 22);
+    }
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models Test Case Table SNR
+ *
+ * Check that the minimum SNRs cached by ErrorRateModel::CalculateSnr are
+ * discarded when the grid or the wrapped model of a TableErrorRateModel
+ * change.
+ */
+class WifiErrorRateModelsTestCaseTableSnr : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTableSnr ();
+  virtual ~WifiErrorRateModelsTestCaseTableSnr ();
+
+private:
+  virtual void DoRun (void);
+};
+
+WifiErrorRateModelsTestCaseTableSnr::WifiErrorRateModelsTestCaseTableSnr ()
+  : TestCase ("WifiErrorRateModel test case table SNR")
+{
+}
+
+WifiErrorRateModelsTestCaseTableSnr::~WifiErrorRateModelsTestCaseTableSnr ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTableSnr::DoRun (void)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (WifiMode ("OfdmRate6Mbps"));
+  txVector.SetChannelWidth (20);
+  double ber = 1e-6;
+
+  //a coarse grid, so that the interpolated SNR differs from the exact one
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  table->SetAttribute ("ErrorRateModel", PointerValue (CreateObject<YansErrorRateModel> ()));
+  table->SetAttribute ("Resolution", DoubleValue (5.0));
+  double interpolated = table->CalculateSnr (txVector, ber);
+
+  //above the minimum SNR, the wrapped model is used
+  table->SetAttribute ("MinSnr", DoubleValue (30.0));
+  Ptr<TableErrorRateModel> expected = CreateObject<TableErrorRateModel> ();
+  expected->SetAttribute ("ErrorRateModel", PointerValue (CreateObject<YansErrorRateModel> ()));
+  expected->SetAttribute ("Resolution", DoubleValue (5.0));
+  expected->SetAttribute ("MinSnr", DoubleValue (30.0));
+  double exact = table->CalculateSnr (txVector, ber);
+  NS_TEST_EXPECT_MSG_EQ (exact, expected->CalculateSnr (txVector, ber), "Changing MinSnr must discard the cached SNR");
+  NS_TEST_EXPECT_MSG_NE (exact, interpolated, "The interpolated SNR should differ from the exact one");
+
+  //changing the wrapped model discards the cached SNR too
+  table->SetAttribute ("ErrorRateModel", PointerValue (CreateObject<NistErrorRateModel> ()));
+  double nist = CreateObject<NistErrorRateModel> ()->CalculateSnr (txVector, ber);
+  NS_TEST_EXPECT_MSG_EQ (table->CalculateSnr (txVector, ber), nist, "Changing the model must discard the cached SNR");
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -308,6 +450,8 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
 {
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTable, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTableSnr, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite; ///< the test suite
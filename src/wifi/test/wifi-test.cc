@@ -43,6 +43,24 @@
 #include "ns3/wifi-phy-tag.h"
 #include "ns3/yans-wifi-phy.h"
 #include "ns3/mgt-headers.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/double.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/abstract-wifi-phy.h"
+#include "ns3/abstract-wifi-channel.h"
+#include "ns3/table-error-rate-model.h"
+#include "ns3/interference-helper.h"
+#include "ns3/mac-low.h"
+#include "ns3/ampdu-subframe-header.h"
+#include "ns3/athstats-helper.h"
+#include "ns3/basic-energy-source.h"
+#include "ns3/wifi-radio-energy-model.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/simple-frame-capture-model.h"
+#include "ns3/wifi-mac-trailer.h"
+#include "ns3/wifi-utils.h"
+#include <fstream>
 
 using namespace ns3;
 
@@ -1690,6 +1708,1257 @@ StaWifiMacScanningTestCase::DoRun (void)
   }
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief YansWifiChannel spatial index and receive power culling test
+ *
+ * Three stationary PHYs are placed at 0, 100 and 1000 m, with a fixed
+ * receive power so that every PHY could decode every transmission.  With a
+ * 300 m SpatialIndexRange only the PHY at 100 m receives, until the far PHY
+ * is moved to 200 m; RxSensitivityCull above the receive power then stops
+ * every delivery.
+ */
+class YansWifiChannelIndexTest : public TestCase
+{
+public:
+  YansWifiChannelIndexTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Send a packet from the first PHY
+   */
+  void Send (void);
+  /**
+   * Receive callback
+   * \param test the test case
+   * \param index the index of the receiving PHY
+   * \param p the packet
+   * \param snr the SNR
+   * \param txVector the wifi transmit vector
+   */
+  static void Receive (YansWifiChannelIndexTest *test, uint32_t index, Ptr<Packet> p, double snr, WifiTxVector txVector);
+  /**
+   * Check the number of packets received by each PHY and reset the counters
+   * \param near number of packets expected at the PHY at 100 m
+   * \param far number of packets expected at the far PHY
+   */
+  void CheckReceived (uint32_t near, uint32_t far);
+
+  Ptr<YansWifiPhy> m_phys[3]; ///< the PHYs
+  uint32_t m_received[3];     ///< number of packets received by each PHY
+};
+
+YansWifiChannelIndexTest::YansWifiChannelIndexTest ()
+  : TestCase ("Test YansWifiChannel spatial index and RxSensitivityCull")
+{
+}
+
+void
+YansWifiChannelIndexTest::Send (void)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (WifiMode ("OfdmRate6Mbps"));
+  txVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+  txVector.SetTxPowerLevel (0);
+  txVector.SetChannelWidth (20);
+  txVector.SetNss (1);
+  m_phys[0]->SendPacket (Create<Packet> (1000), txVector);
+}
+
+void
+YansWifiChannelIndexTest::Receive (YansWifiChannelIndexTest *test, uint32_t index, Ptr<Packet> p, double snr, WifiTxVector txVector)
+{
+  test->m_received[index]++;
+}
+
+void
+YansWifiChannelIndexTest::CheckReceived (uint32_t near, uint32_t far)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_received[1], near, "Unexpected number of packets at the near PHY");
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], far, "Unexpected number of packets at the far PHY");
+  m_received[1] = 0;
+  m_received[2] = 0;
+}
+
+void
+YansWifiChannelIndexTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  Ptr<FixedRssLossModel> loss = CreateObject<FixedRssLossModel> ();
+  loss->SetRss (-50);
+  channel->SetPropagationLossModel (loss);
+  channel->SetAttribute ("SpatialIndexRange", DoubleValue (300));
+
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  double x[3] = {0, 100, 1000};
+  Ptr<MobilityModel> mobility[3];
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_received[i] = 0;
+      mobility[i] = CreateObject<ConstantPositionMobilityModel> ();
+      mobility[i]->SetPosition (Vector (x[i], 0.0, 0.0));
+      m_phys[i] = CreateObject<YansWifiPhy> ();
+      m_phys[i]->SetErrorRateModel (error);
+      m_phys[i]->SetChannel (channel);
+      m_phys[i]->SetMobility (mobility[i]);
+      m_phys[i]->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      m_phys[i]->SetReceiveOkCallback (MakeBoundCallback (&YansWifiChannelIndexTest::Receive, this, i));
+    }
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelIndexTest::Send, this);
+  Simulator::Schedule (Seconds (1.5), &YansWifiChannelIndexTest::CheckReceived, this, 1, 0);
+  Simulator::Schedule (Seconds (2.0), &MobilityModel::SetPosition, mobility[2], Vector (200.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (3.0), &YansWifiChannelIndexTest::Send, this);
+  Simulator::Schedule (Seconds (3.5), &YansWifiChannelIndexTest::CheckReceived, this, 1, 1);
+  Simulator::Schedule (Seconds (4.0), &ObjectBase::SetAttribute, channel, "RxSensitivityCull", DoubleValue (-40));
+  Simulator::Schedule (Seconds (5.0), &YansWifiChannelIndexTest::Send, this);
+  Simulator::Schedule (Seconds (5.5), &YansWifiChannelIndexTest::CheckReceived, this, 0, 0);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief YansWifiChannel channel number buckets test
+ *
+ * Three PHYs share a channel; the first two operate on channel 36 and the
+ * third one on channel 40, so a transmission of the first PHY only reaches
+ * the second one.  Once the third PHY switches to channel 36, it receives
+ * the transmissions too, and stops again after switching back.
+ */
+class YansWifiChannelBucketTest : public TestCase
+{
+public:
+  YansWifiChannelBucketTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Send a packet from the first PHY
+   */
+  void Send (void);
+  /**
+   * Receive callback
+   * \param test the test case
+   * \param index the index of the receiving PHY
+   * \param p the packet
+   * \param snr the SNR
+   * \param txVector the wifi transmit vector
+   */
+  static void Receive (YansWifiChannelBucketTest *test, uint32_t index, Ptr<Packet> p, double snr, WifiTxVector txVector);
+  /**
+   * Check the number of packets received by each PHY and reset the counters
+   * \param second number of packets expected at the second PHY
+   * \param third number of packets expected at the third PHY
+   */
+  void CheckReceived (uint32_t second, uint32_t third);
+
+  Ptr<YansWifiPhy> m_phys[3]; ///< the PHYs
+  uint32_t m_received[3];     ///< number of packets received by each PHY
+};
+
+YansWifiChannelBucketTest::YansWifiChannelBucketTest ()
+  : TestCase ("Test YansWifiChannel channel number buckets")
+{
+}
+
+void
+YansWifiChannelBucketTest::Send (void)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (WifiMode ("OfdmRate6Mbps"));
+  txVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+  txVector.SetTxPowerLevel (0);
+  txVector.SetChannelWidth (20);
+  txVector.SetNss (1);
+  m_phys[0]->SendPacket (Create<Packet> (1000), txVector);
+}
+
+void
+YansWifiChannelBucketTest::Receive (YansWifiChannelBucketTest *test, uint32_t index, Ptr<Packet> p, double snr, WifiTxVector txVector)
+{
+  test->m_received[index]++;
+}
+
+void
+YansWifiChannelBucketTest::CheckReceived (uint32_t second, uint32_t third)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_received[1], second, "Unexpected number of packets at the second PHY");
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], third, "Unexpected number of packets at the third PHY");
+  m_received[1] = 0;
+  m_received[2] = 0;
+}
+
+void
+YansWifiChannelBucketTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  Ptr<FixedRssLossModel> loss = CreateObject<FixedRssLossModel> ();
+  loss->SetRss (-50);
+  channel->SetPropagationLossModel (loss);
+
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  uint8_t channelNumber[3] = {36, 36, 40};
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_received[i] = 0;
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (i * 10.0, 0.0, 0.0));
+      m_phys[i] = CreateObject<YansWifiPhy> ();
+      m_phys[i]->SetErrorRateModel (error);
+      m_phys[i]->SetMobility (mobility);
+      m_phys[i]->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      m_phys[i]->SetChannelNumber (channelNumber[i]);
+      m_phys[i]->SetChannel (channel);
+      m_phys[i]->SetReceiveOkCallback (MakeBoundCallback (&YansWifiChannelBucketTest::Receive, this, i));
+    }
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelBucketTest::Send, this);
+  Simulator::Schedule (Seconds (1.5), &YansWifiChannelBucketTest::CheckReceived, this, 1, 0);
+  Simulator::Schedule (Seconds (2.0), &WifiPhy::SetChannelNumber, m_phys[2], 36);
+  Simulator::Schedule (Seconds (3.0), &YansWifiChannelBucketTest::Send, this);
+  Simulator::Schedule (Seconds (3.5), &YansWifiChannelBucketTest::CheckReceived, this, 1, 1);
+  Simulator::Schedule (Seconds (4.0), &WifiPhy::SetChannelNumber, m_phys[2], 40);
+  Simulator::Schedule (Seconds (5.0), &YansWifiChannelBucketTest::Send, this);
+  Simulator::Schedule (Seconds (5.5), &YansWifiChannelBucketTest::CheckReceived, this, 1, 0);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief WifiMacQueue (receiver address, TID) index test
+ *
+ * QoS data frames for two receivers and two TIDs, and a non-QoS frame, are
+ * enqueued.  The per-(receiver, TID) operations must return the frames in
+ * queue order, also after a frame is dequeued and pushed back to the
+ * front, and the per-(receiver, TID) counts must be exact.  Once the
+ * lifetime of the first frames has elapsed, they must no longer be counted
+ * or returned.
+ */
+class WifiMacQueueIndexTest : public TestCase
+{
+public:
+  WifiMacQueueIndexTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Create a queue item
+   * \param dest the receiver address
+   * \param tid the TID, or 8 for a non-QoS data frame
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> CreateItem (Mac48Address dest, uint8_t tid);
+  /**
+   * Enqueue the frames and check the index before the frames expire
+   */
+  void EnqueueAndCheck (void);
+  /**
+   * Enqueue a frame before the first frames expire
+   */
+  void EnqueueLater (void);
+  /**
+   * Check the index after the first frames expired
+   */
+  void CheckExpired (void);
+
+  Ptr<WifiMacQueue> m_queue; ///< the queue
+  Mac48Address m_a;          ///< first receiver
+  Mac48Address m_b;          ///< second receiver
+  Ptr<const Packet> m_later; ///< the packet enqueued later
+};
+
+WifiMacQueueIndexTest::WifiMacQueueIndexTest ()
+  : TestCase ("Test WifiMacQueue (receiver address, TID) index")
+{
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueueIndexTest::CreateItem (Mac48Address dest, uint8_t tid)
+{
+  WifiMacHeader header;
+  if (tid < 8)
+    {
+      header.SetType (WIFI_MAC_QOSDATA);
+      header.SetQosTid (tid);
+    }
+  else
+    {
+      header.SetType (WIFI_MAC_DATA);
+    }
+  header.SetAddr1 (dest);
+  return Create<WifiMacQueueItem> (Create<Packet> (100), header);
+}
+
+void
+WifiMacQueueIndexTest::EnqueueAndCheck (void)
+{
+  Ptr<WifiMacQueueItem> a0First = CreateItem (m_a, 0);
+  Ptr<WifiMacQueueItem> b0 = CreateItem (m_b, 0);
+  Ptr<WifiMacQueueItem> a0Second = CreateItem (m_a, 0);
+  m_queue->Enqueue (a0First);
+  m_queue->Enqueue (b0);
+  m_queue->Enqueue (a0Second);
+  m_queue->Enqueue (CreateItem (m_a, 1));
+  m_queue->Enqueue (CreateItem (m_a, 8));
+
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (), 5, "Unexpected number of packets");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_a), 2, "Unexpected number of packets for (A, 0)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (1, m_a), 1, "Unexpected number of packets for (A, 1)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_b), 1, "Unexpected number of packets for (B, 0)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (1, m_b), 0, "Unexpected number of packets for (B, 1)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (0, m_a)->GetPacket (), a0First->GetPacket (), "Unexpected first packet for (A, 0)");
+
+  Ptr<WifiMacQueueItem> item = m_queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ (item->GetPacket (), a0First->GetPacket (), "Unexpected head of the queue");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (0, m_a)->GetPacket (), a0Second->GetPacket (), "Unexpected first packet for (A, 0)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_a), 1, "Unexpected number of packets for (A, 0)");
+
+  m_queue->PushFront (item);
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (0, m_a)->GetPacket (), a0First->GetPacket (), "Unexpected first packet for (A, 0)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_a), 2, "Unexpected number of packets for (A, 0)");
+
+  item = m_queue->DequeueByTidAndAddress (0, m_b);
+  NS_TEST_EXPECT_MSG_EQ (item->GetPacket (), b0->GetPacket (), "Unexpected packet for (B, 0)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_b), 0, "Unexpected number of packets for (B, 0)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (0, m_b), 0, "Unexpected packet for (B, 0)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (), 4, "Unexpected number of packets");
+}
+
+void
+WifiMacQueueIndexTest::EnqueueLater (void)
+{
+  Ptr<WifiMacQueueItem> item = CreateItem (m_a, 0);
+  m_later = item->GetPacket ();
+  m_queue->Enqueue (item);
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_a), 3, "Unexpected number of packets for (A, 0)");
+}
+
+void
+WifiMacQueueIndexTest::CheckExpired (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_a), 1, "Unexpected number of packets for (A, 0)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (1, m_a), 0, "Unexpected number of packets for (A, 1)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (0, m_a)->GetPacket (), m_later, "Unexpected first packet for (A, 0)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (), 1, "Unexpected number of packets");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (0, m_a)->GetPacket (), m_later, "Unexpected packet for (A, 0)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->IsEmpty (), true, "The queue should be empty");
+}
+
+void
+WifiMacQueueIndexTest::DoRun (void)
+{
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxDelay (MilliSeconds (500));
+  m_a = Mac48Address ("00:00:00:00:00:01");
+  m_b = Mac48Address ("00:00:00:00:00:02");
+
+  Simulator::Schedule (Seconds (1.0), &WifiMacQueueIndexTest::EnqueueAndCheck, this);
+  Simulator::Schedule (Seconds (1.3), &WifiMacQueueIndexTest::EnqueueLater, this);
+  Simulator::Schedule (Seconds (1.6), &WifiMacQueueIndexTest::CheckExpired, this);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_queue = 0;
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief AbstractWifiPhy and AbstractWifiChannel test
+ *
+ * Two stationary PHYs are 10 m apart on an AbstractWifiChannel.  Several
+ * transmissions are received while the path loss is evaluated once.  Moving
+ * the receiver 5 km away discards the cached path loss, and no packet is
+ * received until it comes back.  Replacing the propagation loss model
+ * through its attribute discards the cached path loss too.  The receiver
+ * uses the tables of its TableErrorRateModel.
+ */
+class AbstractWifiPhyTest : public TestCase
+{
+public:
+  AbstractWifiPhyTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Send a packet from the first PHY
+   */
+  void Send (void);
+  /**
+   * Replace the propagation loss model of the channel through its attribute
+   * with one under which no packet is received
+   */
+  void ChangeLossModel (void);
+  /**
+   * Receive callback
+   * \param p the packet
+   * \param snr the SNR
+   * \param txVector the wifi transmit vector
+   */
+  void Receive (Ptr<Packet> p, double snr, WifiTxVector txVector);
+  /**
+   * Check the number of packets received and of path loss evaluations, and
+   * reset the number of packets received
+   * \param received number of packets expected at the receiver
+   * \param evaluations expected number of path loss evaluations
+   */
+  void Check (uint32_t received, uint64_t evaluations);
+
+  Ptr<AbstractWifiChannel> m_channel; ///< the channel
+  Ptr<AbstractWifiPhy> m_phys[2];     ///< the PHYs
+  uint32_t m_received;                ///< number of packets received
+};
+
+AbstractWifiPhyTest::AbstractWifiPhyTest ()
+  : TestCase ("Test AbstractWifiPhy and the path loss cache of AbstractWifiChannel")
+{
+}
+
+void
+AbstractWifiPhyTest::Send (void)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (WifiMode ("OfdmRate6Mbps"));
+  txVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+  txVector.SetTxPowerLevel (0);
+  txVector.SetChannelWidth (20);
+  txVector.SetNss (1);
+  m_phys[0]->SendPacket (Create<Packet> (1000), txVector);
+}
+
+void
+AbstractWifiPhyTest::ChangeLossModel (void)
+{
+  Ptr<FixedRssLossModel> loss = CreateObject<FixedRssLossModel> ();
+  loss->SetRss (-200);
+  m_channel->SetAttribute ("PropagationLossModel", PointerValue (loss));
+}
+
+void
+AbstractWifiPhyTest::Receive (Ptr<Packet> p, double snr, WifiTxVector txVector)
+{
+  m_received++;
+}
+
+void
+AbstractWifiPhyTest::Check (uint32_t received, uint64_t evaluations)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_received, received, "Unexpected number of packets received");
+  NS_TEST_EXPECT_MSG_EQ (m_channel->GetNPathLossEvaluations (), evaluations, "Unexpected number of path loss evaluations");
+  m_received = 0;
+}
+
+void
+AbstractWifiPhyTest::DoRun (void)
+{
+  m_received = 0;
+  m_channel = CreateObject<AbstractWifiChannel> ();
+  m_channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  m_channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  Ptr<TableErrorRateModel> error = CreateObject<TableErrorRateModel> ();
+  error->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  Ptr<MobilityModel> mobility[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      mobility[i] = CreateObject<ConstantPositionMobilityModel> ();
+      mobility[i]->SetPosition (Vector (i * 10.0, 0.0, 0.0));
+      m_phys[i] = CreateObject<AbstractWifiPhy> ();
+      m_phys[i]->SetErrorRateModel (error);
+      m_phys[i]->SetChannel (m_channel);
+      m_phys[i]->SetMobility (mobility[i]);
+      m_phys[i]->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      m_phys[i]->Initialize ();
+    }
+  m_phys[1]->SetReceiveOkCallback (MakeCallback (&AbstractWifiPhyTest::Receive, this));
+
+  Simulator::Schedule (Seconds (1.0), &AbstractWifiPhyTest::Send, this);
+  Simulator::Schedule (Seconds (1.1), &AbstractWifiPhyTest::Send, this);
+  Simulator::Schedule (Seconds (1.2), &AbstractWifiPhyTest::Send, this);
+  Simulator::Schedule (Seconds (1.5), &AbstractWifiPhyTest::Check, this, 3, 1);
+  Simulator::Schedule (Seconds (2.0), &MobilityModel::SetPosition, mobility[1], Vector (5000.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (3.0), &AbstractWifiPhyTest::Send, this);
+  Simulator::Schedule (Seconds (3.1), &AbstractWifiPhyTest::Send, this);
+  Simulator::Schedule (Seconds (3.5), &AbstractWifiPhyTest::Check, this, 0, 2);
+  Simulator::Schedule (Seconds (4.0), &MobilityModel::SetPosition, mobility[1], Vector (10.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (5.0), &AbstractWifiPhyTest::Send, this);
+  Simulator::Schedule (Seconds (5.5), &AbstractWifiPhyTest::Check, this, 1, 3);
+  Simulator::Schedule (Seconds (6.0), &AbstractWifiPhyTest::ChangeLossModel, this);
+  Simulator::Schedule (Seconds (6.1), &AbstractWifiPhyTest::Send, this);
+  Simulator::Schedule (Seconds (6.5), &AbstractWifiPhyTest::Check, this, 0, 4);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_GT (error->GetNTables (), 0, "The error rate tables were not used");
+  m_channel = 0;
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Effective SINR and PER of the abstract PHY
+ *
+ * A frame is received once without interference and once while a shorter
+ * signal overlaps its payload.  The test checks that the SINR and the PER
+ * returned by InterferenceHelper::CalculateEffectivePlcpPayloadSnrPer, on
+ * which AbstractWifiPhy relies, are those of the payload as a single chunk
+ * at the peak of the noise and interference power, and that they are never
+ * more optimistic than the chunk-by-chunk evaluation.
+ */
+class AbstractWifiPhyInterferenceTest : public TestCase
+{
+public:
+  AbstractWifiPhyInterferenceTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Start the reception of the frame
+   */
+  void AddFrame (void);
+  /**
+   * Check the effective SINR and PER of the last frame
+   * \param interferenceW the power of the overlapping signal (W)
+   */
+  void Check (double interferenceW);
+
+  InterferenceHelper m_interference; ///< the interference helper
+  Ptr<ErrorRateModel> m_error;       ///< the error rate model
+  WifiTxVector m_txVector;           ///< the TXVECTOR of the frame
+  Time m_duration;                   ///< the duration of the frame
+  double m_signalW;                  ///< the received power of the frame (W)
+  double m_noiseW;                   ///< the noise floor (W)
+  Ptr<Event> m_event;                ///< the last frame
+};
+
+AbstractWifiPhyInterferenceTest::AbstractWifiPhyInterferenceTest ()
+  : TestCase ("Test the effective SINR and PER of AbstractWifiPhy with an overlapping interferer"),
+    m_signalW (1e-10)
+{
+}
+
+void
+AbstractWifiPhyInterferenceTest::AddFrame (void)
+{
+  m_event = m_interference.Add (Create<Packet> (1000), m_txVector, m_duration, m_signalW);
+  //as WifiPhy does, so that the signals received meanwhile are kept
+  m_interference.NotifyRxStart ();
+}
+
+void
+AbstractWifiPhyInterferenceTest::Check (double interferenceW)
+{
+  m_interference.NotifyRxEnd ();
+  InterferenceHelper::SnrPer effective = m_interference.CalculateEffectivePlcpPayloadSnrPer (m_event);
+  double snr = m_signalW / (m_noiseW + interferenceW);
+  Time payload = m_duration - WifiPhy::CalculatePlcpPreambleAndHeaderDuration (m_txVector);
+  uint64_t nbits = static_cast<uint64_t> (m_txVector.GetMode ().GetPhyRate (m_txVector) * payload.GetSeconds ());
+  double per = 1 - m_error->GetChunkSuccessRate (m_txVector.GetMode (), m_txVector, snr, nbits);
+  NS_TEST_EXPECT_MSG_EQ_TOL (effective.snr, snr, snr * 1e-9, "Wrong effective SINR");
+  NS_TEST_EXPECT_MSG_EQ_TOL (effective.per, per, 1e-9, "Wrong effective PER");
+
+  InterferenceHelper::SnrPer chunks = m_interference.CalculatePlcpPayloadSnrPer (m_event);
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (effective.per + 1e-12, chunks.per, "The effective PER must not be optimistic");
+  if (interferenceW > 0)
+    {
+      NS_TEST_EXPECT_MSG_GT (effective.per, chunks.per, "The interferer only overlaps part of the payload");
+    }
+}
+
+void
+AbstractWifiPhyInterferenceTest::DoRun (void)
+{
+  double noiseFigure = std::pow (10.0, 7.0 / 10.0);
+  m_noiseW = 1.3803e-23 * 290 * 20e6 * noiseFigure;
+  m_error = CreateObject<YansErrorRateModel> ();
+  m_interference.SetNoiseFigure (noiseFigure);
+  m_interference.SetErrorRateModel (m_error);
+  m_interference.SetNumberOfReceiveAntennas (1);
+
+  m_txVector.SetMode (WifiMode ("OfdmRate6Mbps"));
+  m_txVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+  m_txVector.SetChannelWidth (20);
+  m_txVector.SetNss (1);
+  m_duration = MicroSeconds (1364); // about 1000 bytes at 6 Mbit/s
+
+  //the interference power brings the SINR from about 24 dB down to 3 dB,
+  //where a 1000-byte frame at 6 Mbit/s is lost with a non-trivial probability
+  double interferenceW = m_signalW / 2 - m_noiseW;
+
+  Simulator::Schedule (Seconds (1.0), &AbstractWifiPhyInterferenceTest::AddFrame, this);
+  Simulator::Schedule (Seconds (1.1), &AbstractWifiPhyInterferenceTest::Check, this, 0.0);
+  Simulator::Schedule (Seconds (2.0), &AbstractWifiPhyInterferenceTest::AddFrame, this);
+  Simulator::Schedule (Seconds (2.0) + MicroSeconds (500), &InterferenceHelper::AddInterference,
+                       &m_interference, MicroSeconds (100), interferenceW);
+  Simulator::Schedule (Seconds (2.1), &AbstractWifiPhyInterferenceTest::Check, this, interferenceW);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_event = 0;
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Beacon body cache test
+ *
+ * An 802.11b station associates with an 802.11g AP, whose beacons are
+ * built once and then reused until the BSS changes.  The test checks that
+ * the beacons announce non-ERP stations from the association of the
+ * 802.11b station onwards, and that the station stays associated while it
+ * only parses the beacons which differ from the previous ones.
+ */
+class BeaconCacheTest : public TestCase
+{
+public:
+  BeaconCacheTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Callback triggered when the AP starts a transmission
+   * \param p the transmitted packet
+   */
+  void TxCallback (Ptr<const Packet> p);
+  /**
+   * Callback triggered when the station associates
+   * \param bssid the BSSID
+   */
+  void AssocCallback (Mac48Address bssid);
+  /**
+   * Callback triggered when the station loses its association
+   * \param bssid the BSSID
+   */
+  void DeAssocCallback (Mac48Address bssid);
+
+  uint32_t m_assoc;         ///< number of associations
+  uint32_t m_deAssoc;       ///< number of association losses
+  uint32_t m_erpBeacons;    ///< number of beacons announcing no non-ERP stations
+  uint32_t m_nonErpBeacons; ///< number of beacons announcing non-ERP stations
+  bool m_erpAfterNonErp;    ///< whether a beacon announced no non-ERP stations after one did
+};
+
+BeaconCacheTest::BeaconCacheTest ()
+  : TestCase ("Test that cached beacon bodies follow the state of the BSS"),
+    m_assoc (0),
+    m_deAssoc (0),
+    m_erpBeacons (0),
+    m_nonErpBeacons (0),
+    m_erpAfterNonErp (false)
+{
+}
+
+void
+BeaconCacheTest::TxCallback (Ptr<const Packet> p)
+{
+  Ptr<Packet> packet = p->Copy ();
+  WifiMacHeader hdr;
+  packet->RemoveHeader (hdr);
+  if (hdr.IsBeacon ())
+    {
+      MgtBeaconHeader beacon;
+      packet->RemoveHeader (beacon);
+      if (beacon.GetErpInformation ().GetNonErpPresent ())
+        {
+          m_nonErpBeacons++;
+        }
+      else
+        {
+          m_erpBeacons++;
+          m_erpAfterNonErp |= (m_nonErpBeacons > 0);
+        }
+    }
+}
+
+void
+BeaconCacheTest::AssocCallback (Mac48Address bssid)
+{
+  m_assoc++;
+}
+
+void
+BeaconCacheTest::DeAssocCallback (Mac48Address bssid)
+{
+  m_deAssoc++;
+}
+
+void
+BeaconCacheTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi;
+  WifiMacHelper mac;
+  Ssid ssid = Ssid ("cache");
+
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211g);
+  mac.SetType ("ns3::ApWifiMac",
+               "Ssid", SsidValue (ssid),
+               "EnableBeaconJitter", BooleanValue (false));
+  NetDeviceContainer apDevice = wifi.Install (phy, mac, nodes.Get (0));
+
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211b);
+  mac.SetType ("ns3::StaWifiMac",
+               "Ssid", SsidValue (ssid));
+  NetDeviceContainer staDevice = wifi.Install (phy, mac, nodes.Get (1));
+
+  MobilityHelper mobility;
+  mobility.Install (nodes);
+
+  Ptr<WifiNetDevice> apDev = DynamicCast<WifiNetDevice> (apDevice.Get (0));
+  apDev->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&BeaconCacheTest::TxCallback, this));
+  Ptr<WifiMac> staMac = DynamicCast<WifiNetDevice> (staDevice.Get (0))->GetMac ();
+  staMac->TraceConnectWithoutContext ("Assoc", MakeCallback (&BeaconCacheTest::AssocCallback, this));
+  staMac->TraceConnectWithoutContext ("DeAssoc", MakeCallback (&BeaconCacheTest::DeAssocCallback, this));
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_GT (m_erpBeacons, 0, "No beacon sent before the association");
+  NS_TEST_EXPECT_MSG_GT (m_nonErpBeacons, 10, "The association of the 802.11b station was not announced");
+  NS_TEST_EXPECT_MSG_EQ (m_erpAfterNonErp, false, "A stale beacon body was sent");
+  NS_TEST_EXPECT_MSG_EQ (m_assoc, 1, "The station did not associate");
+  NS_TEST_EXPECT_MSG_EQ (m_deAssoc, 0, "The station lost its association");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief MacLow NAV filter test
+ *
+ * Frames are handed to MacLow::NotifyNavIfNotForMe, on their own and as
+ * A-MPDU subframes.  The test checks that the NAV is only set by the data
+ * and management frames addressed to another station, with the duration
+ * they carry.
+ */
+class MacLowNavTest : public TestCase
+{
+public:
+  MacLowNavTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Build a frame
+   * \param type the type of the frame
+   * \param addr1 the receiver address
+   * \param duration the Duration/ID field of the frame
+   * \param subframe whether to prepend an A-MPDU subframe header
+   * \return the frame
+   */
+  Ptr<Packet> CreateFrame (WifiMacType type, Mac48Address addr1, Time duration, bool subframe);
+};
+
+MacLowNavTest::MacLowNavTest ()
+  : TestCase ("Test that MacLow only sets the NAV for frames addressed to other stations")
+{
+}
+
+Ptr<Packet>
+MacLowNavTest::CreateFrame (WifiMacType type, Mac48Address addr1, Time duration, bool subframe)
+{
+  Ptr<Packet> packet = Create<Packet> (100);
+  WifiMacHeader hdr;
+  hdr.SetType (type);
+  hdr.SetAddr1 (addr1);
+  hdr.SetAddr2 (Mac48Address ("00:00:00:00:00:03"));
+  hdr.SetAddr3 (Mac48Address ("00:00:00:00:00:03"));
+  hdr.SetDuration (duration);
+  packet->AddHeader (hdr);
+  if (subframe)
+    {
+      AmpduSubframeHeader subframeHdr;
+      subframeHdr.SetLength (packet->GetSize ());
+      packet->AddHeader (subframeHdr);
+    }
+  return packet;
+}
+
+void
+MacLowNavTest::DoRun (void)
+{
+  Mac48Address self ("00:00:00:00:00:01");
+  Mac48Address other ("00:00:00:00:00:02");
+  uint32_t offset = AmpduSubframeHeader ().GetSerializedSize ();
+  Ptr<MacLow> low = CreateObject<MacLow> ();
+  low->SetAddress (self);
+
+  NS_TEST_EXPECT_MSG_EQ (low->NotifyNavIfNotForMe (CreateFrame (WIFI_MAC_QOSDATA, self, MicroSeconds (100), false), 0),
+                         false, "A data frame for this station was filtered");
+  NS_TEST_EXPECT_MSG_EQ (low->NotifyNavIfNotForMe (CreateFrame (WIFI_MAC_MGT_ACTION, self, MicroSeconds (100), true), offset),
+                         false, "A management frame for this station was filtered");
+  NS_TEST_EXPECT_MSG_EQ (low->NotifyNavIfNotForMe (CreateFrame (WIFI_MAC_QOSDATA, Mac48Address::GetBroadcast (), MicroSeconds (100), false), 0),
+                         false, "A broadcast frame was filtered");
+  NS_TEST_EXPECT_MSG_EQ (low->NotifyNavIfNotForMe (CreateFrame (WIFI_MAC_CTL_ACK, other, MicroSeconds (100), false), 0),
+                         false, "A control frame was filtered");
+  NS_TEST_EXPECT_MSG_EQ (low->m_lastNavDuration, Seconds (0), "The NAV was set by a frame which is not filtered");
+
+  NS_TEST_EXPECT_MSG_EQ (low->NotifyNavIfNotForMe (CreateFrame (WIFI_MAC_QOSDATA, other, MicroSeconds (100), false), 0),
+                         true, "A data frame for another station was not filtered");
+  NS_TEST_EXPECT_MSG_EQ (low->m_lastNavDuration, MicroSeconds (100), "The NAV was not set by a data frame for another station");
+  NS_TEST_EXPECT_MSG_EQ (low->NotifyNavIfNotForMe (CreateFrame (WIFI_MAC_MGT_ACTION, other, MicroSeconds (300), true), offset),
+                         true, "A management subframe for another station was not filtered");
+  NS_TEST_EXPECT_MSG_EQ (low->m_lastNavDuration, MicroSeconds (300), "The NAV was not set by a management subframe for another station");
+
+  low->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Athstats binary output test
+ *
+ * Records are written with AthstatsBinaryWriter, then read back.  The
+ * test also checks that AthstatsHelper uses the default value of the
+ * interval attribute of the trace sinks unless SetInterval is called.
+ */
+class AthstatsBinaryTest : public TestCase
+{
+public:
+  AthstatsBinaryTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Read an unsigned integer in little endian byte order
+   * \param is the input stream
+   * \param size the number of bytes to read
+   * \return the integer
+   */
+  uint64_t ReadLittleEndian (std::istream &is, uint32_t size);
+  /**
+   * Read the header of a binary file
+   * \param is the input stream
+   * \return the interval between two reports, in nanoseconds
+   */
+  uint64_t ReadHeader (std::istream &is);
+};
+
+AthstatsBinaryTest::AthstatsBinaryTest ()
+  : TestCase ("Test that the records written by AthstatsBinaryWriter can be read back")
+{
+}
+
+uint64_t
+AthstatsBinaryTest::ReadLittleEndian (std::istream &is, uint32_t size)
+{
+  uint8_t bytes[8];
+  is.read (reinterpret_cast<char *> (bytes), size);
+  uint64_t value = 0;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      value |= static_cast<uint64_t> (bytes[i]) << (8 * i);
+    }
+  return value;
+}
+
+uint64_t
+AthstatsBinaryTest::ReadHeader (std::istream &is)
+{
+  char magic[8];
+  is.read (magic, 8);
+  NS_TEST_EXPECT_MSG_EQ (std::string (magic, 8), "NS3ATHST", "Wrong magic string");
+  NS_TEST_EXPECT_MSG_EQ (ReadLittleEndian (is, 4), 1, "Wrong version");
+  NS_TEST_EXPECT_MSG_EQ (ReadLittleEndian (is, 4), AthstatsBinaryWriter::RECORD_SIZE, "Wrong record size");
+  return ReadLittleEndian (is, 8);
+}
+
+void
+AthstatsBinaryTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("athstats-binary-test.athstats");
+  uint32_t run = static_cast<uint32_t> (RngSeedManager::GetRun ());
+
+  {
+    Ptr<AthstatsBinaryWriter> writer = Create<AthstatsBinaryWriter> (filename, MilliSeconds (250));
+    uint32_t first[AthstatsBinaryWriter::N_COUNTERS] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint32_t second[AthstatsBinaryWriter::N_COUNTERS] = {0, 0xffffffff, 0, 70000, 0, 0, 1, 0};
+    writer->Write (3, 1, 0, first);
+    writer->Write (4, 2, 1, second);
+    writer->Close ();
+    //the file is closed: this record is dropped
+    writer->Write (5, 0, 2, first);
+
+    std::ifstream is (filename.c_str (), std::ios_base::binary);
+    NS_TEST_ASSERT_MSG_EQ (is.good (), true, "Cannot open " << filename);
+    NS_TEST_EXPECT_MSG_EQ (ReadHeader (is), 250000000, "Wrong interval");
+    uint32_t fields[2][4] = {{run, 3, 1, 0}, {run, 4, 2, 1}};
+    const uint32_t *counters[2] = {first, second};
+    for (uint32_t i = 0; i < 2; i++)
+      {
+        for (uint32_t j = 0; j < 4; j++)
+          {
+            NS_TEST_EXPECT_MSG_EQ (ReadLittleEndian (is, 4), fields[i][j], "Wrong field " << j << " in record " << i);
+          }
+        for (uint32_t j = 0; j < AthstatsBinaryWriter::N_COUNTERS; j++)
+          {
+            NS_TEST_EXPECT_MSG_EQ (ReadLittleEndian (is, 4), counters[i][j], "Wrong counter " << j << " in record " << i);
+          }
+      }
+    is.peek ();
+    NS_TEST_EXPECT_MSG_EQ (is.eof (), true, "Unexpected data after the records");
+  }
+
+  //a device reporting every 0.5 s, as set by the default value of the interval
+  Config::SetDefault ("ns3::AthstatsWifiTraceSink::Interval", TimeValue (MilliSeconds (500)));
+  NodeContainer nodes;
+  nodes.Create (1);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  WifiHelper wifi;
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  AthstatsHelper athstats;
+  athstats.EnableAthstatsBinary (filename, devices);
+  Simulator::Stop (Seconds (1.2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::AthstatsWifiTraceSink::Interval", TimeValue (Seconds (1)));
+
+  std::ifstream is (filename.c_str (), std::ios_base::binary);
+  NS_TEST_ASSERT_MSG_EQ (is.good (), true, "Cannot open " << filename);
+  NS_TEST_EXPECT_MSG_EQ (ReadHeader (is), 500000000, "Wrong interval");
+  uint32_t nRecords = 0;
+  while (is.peek () != EOF)
+    {
+      NS_TEST_EXPECT_MSG_EQ (ReadLittleEndian (is, 4), run, "Wrong run number");
+      NS_TEST_EXPECT_MSG_EQ (ReadLittleEndian (is, 4), nodes.Get (0)->GetId (), "Wrong node ID");
+      NS_TEST_EXPECT_MSG_EQ (ReadLittleEndian (is, 4), devices.Get (0)->GetIfIndex (), "Wrong device ID");
+      NS_TEST_EXPECT_MSG_EQ (ReadLittleEndian (is, 4), nRecords, "Wrong report index");
+      for (uint32_t j = 0; j < AthstatsBinaryWriter::N_COUNTERS; j++)
+        {
+          ReadLittleEndian (is, 4);
+        }
+      nRecords++;
+    }
+  //reports at 0, 0.5 and 1 s
+  NS_TEST_EXPECT_MSG_EQ (nRecords, 3, "Wrong number of reports");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Deferred energy updates test
+ *
+ * A WifiRadioEnergyModel fed by a BasicEnergySource switches every 10 ms
+ * between IDLE and CCA_BUSY, which draw the same current, until the
+ * source is depleted.  The remaining energy, the energy consumption and
+ * the depletion time are compared with those of a run where the source is
+ * updated at every state change.
+ */
+class WifiEnergyDeferredUpdateTest : public TestCase
+{
+public:
+  WifiEnergyDeferredUpdateTest ();
+  virtual void DoRun (void);
+
+private:
+  /// Results of a run
+  struct Results
+  {
+    double remainingJ;   ///< remaining energy of the source after 300 ms
+    double consumedJ;    ///< energy consumed by the radio after 300 ms
+    Time depletionTime;  ///< time at which the source is depleted
+  };
+
+  /**
+   * Run the scenario
+   * \param deferred whether the source updates are left to the energy model
+   * \return the results of the run
+   */
+  Results Run (bool deferred);
+  /**
+   * Change the state of the radio
+   * \param state the new state
+   * \param deferred whether the source updates are left to the energy model
+   */
+  void ChangeState (WifiPhyState state, bool deferred);
+  /// Sample the remaining and consumed energies
+  void Sample (void);
+  /// Callback triggered when the source is depleted
+  void Depleted (void);
+
+  Ptr<BasicEnergySource> m_source;   ///< energy source
+  Ptr<WifiRadioEnergyModel> m_model; ///< energy model
+  Results m_results;                 ///< results of the current run
+};
+
+WifiEnergyDeferredUpdateTest::WifiEnergyDeferredUpdateTest ()
+  : TestCase ("Test that deferring the energy updates of states drawing the same current changes no result")
+{
+}
+
+void
+WifiEnergyDeferredUpdateTest::ChangeState (WifiPhyState state, bool deferred)
+{
+  if (!m_results.depletionTime.IsZero ())
+    {
+      return;
+    }
+  m_model->ChangeState (state);
+  if (!deferred)
+    {
+      m_source->UpdateEnergySource ();
+    }
+}
+
+void
+WifiEnergyDeferredUpdateTest::Sample (void)
+{
+  m_results.remainingJ = m_source->GetRemainingEnergy ();
+  m_results.consumedJ = m_model->GetTotalEnergyConsumption ();
+}
+
+void
+WifiEnergyDeferredUpdateTest::Depleted (void)
+{
+  m_results.depletionTime = Simulator::Now ();
+}
+
+WifiEnergyDeferredUpdateTest::Results
+WifiEnergyDeferredUpdateTest::Run (bool deferred)
+{
+  m_results.remainingJ = 0;
+  m_results.consumedJ = 0;
+  m_results.depletionTime = Seconds (0);
+  m_source = CreateObject<BasicEnergySource> ();
+  m_source->SetInitialEnergy (1.0);
+  m_source->SetSupplyVoltage (3.0);
+  m_model = CreateObject<WifiRadioEnergyModel> ();
+  m_model->SetEnergySource (m_source);
+  m_model->SetEnergyDepletionCallback (MakeCallback (&WifiEnergyDeferredUpdateTest::Depleted, this));
+  m_source->AppendDeviceEnergyModel (m_model);
+  m_source->Initialize ();
+
+  for (uint32_t i = 1; i < 200; i++)
+    {
+      WifiPhyState state = (i % 2) ? WifiPhyState::CCA_BUSY : WifiPhyState::IDLE;
+      Simulator::Schedule (MilliSeconds (10 * i), &WifiEnergyDeferredUpdateTest::ChangeState, this, state, deferred);
+    }
+  Simulator::Schedule (MilliSeconds (305), &WifiEnergyDeferredUpdateTest::Sample, this);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_model = 0;
+  m_source = 0;
+  return m_results;
+}
+
+void
+WifiEnergyDeferredUpdateTest::DoRun (void)
+{
+  Results deferred = Run (true);
+  Results updated = Run (false);
+
+  //0.273 A at 3 V drain 0.9 J, down to the low battery threshold, in 1.0989 s;
+  //the depletion is reported by the first update after that, at 1.1 s
+  NS_TEST_EXPECT_MSG_EQ_TOL (updated.remainingJ, 1.0 - 0.305 * 0.273 * 3, 1e-9, "Wrong remaining energy");
+  NS_TEST_EXPECT_MSG_EQ_TOL (deferred.remainingJ, updated.remainingJ, 1e-12, "Remaining energy differs");
+  NS_TEST_EXPECT_MSG_EQ_TOL (deferred.consumedJ, updated.consumedJ, 1e-12, "Energy consumption differs");
+  NS_TEST_EXPECT_MSG_EQ (updated.depletionTime, MilliSeconds (1100), "Wrong depletion time");
+  NS_TEST_EXPECT_MSG_EQ (deferred.depletionTime, updated.depletionTime, "Depletion time differs");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Interference of the signals a PHY does not receive
+ *
+ * The signals below the energy detection threshold and the signals
+ * arriving while the PHY is receiving another frame are only recorded as
+ * interference power.  The test checks that they still lower the SINR of
+ * a concurrent reception, make it fail when they are strong enough, and
+ * that a frame captured by the frame capture model is still received.
+ */
+class WifiPhyInterferenceOnlyTest : public TestCase
+{
+public:
+  WifiPhyInterferenceOnlyTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Inject a signal into the PHY
+   * \param mode the mode of the frame
+   * \param size the size of the payload of the frame
+   * \param rxPowerDbm the reception power (dBm)
+   */
+  void SendSignal (WifiMode mode, uint32_t size, double rxPowerDbm);
+  /**
+   * Callback triggered when a frame is received
+   * \param p the packet
+   * \param snr the SNR
+   * \param txVector the transmit vector
+   */
+  void RxSuccess (Ptr<Packet> p, double snr, WifiTxVector txVector);
+  /**
+   * Callback triggered when the reception of a frame fails
+   * \param p the packet
+   * \param snr the SNR
+   */
+  void RxFailure (Ptr<Packet> p, double snr);
+  /**
+   * Check the receptions of a scenario
+   * \param scenario the scenario, i.e. the second at which it started
+   * \param size the size of the payload of the frame expected to be received
+   * \param ok whether its reception is expected to succeed
+   * \param snr the SNR expected for a successful reception, or 0
+   */
+  void CheckRx (uint32_t scenario, uint32_t size, bool ok, double snr);
+
+  /// Reception of a frame
+  struct Rx
+  {
+    uint32_t scenario; ///< the scenario
+    uint32_t size;     ///< the size of the payload of the frame
+    bool ok;           ///< whether the reception succeeded
+    double snr;        ///< the SNR
+  };
+
+  Ptr<YansWifiPhy> m_phy; ///< PHY
+  std::vector<Rx> m_rx;   ///< receptions
+};
+
+WifiPhyInterferenceOnlyTest::WifiPhyInterferenceOnlyTest ()
+  : TestCase ("Test that the signals a PHY does not receive still interfere")
+{
+}
+
+void
+WifiPhyInterferenceOnlyTest::SendSignal (WifiMode mode, uint32_t size, double rxPowerDbm)
+{
+  WifiTxVector txVector = WifiTxVector (mode, 0, WIFI_PREAMBLE_LONG, 800, 1, 1, 0, 20, false, false);
+  Ptr<Packet> pkt = Create<Packet> (size);
+  WifiMacHeader hdr;
+  WifiMacTrailer trailer;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  pkt->AddHeader (hdr);
+  pkt->AddTrailer (trailer);
+  Time txDuration = m_phy->CalculateTxDuration (pkt->GetSize (), txVector, m_phy->GetFrequency ());
+  WifiPhyTag tag (txVector, NORMAL_MPDU, 1);
+  pkt->AddPacketTag (tag);
+  m_phy->StartReceivePreambleAndHeader (pkt, DbmToW (rxPowerDbm), txDuration);
+}
+
+void
+WifiPhyInterferenceOnlyTest::RxSuccess (Ptr<Packet> p, double snr, WifiTxVector txVector)
+{
+  Rx rx = {static_cast<uint32_t> (Simulator::Now ().GetSeconds ()), p->GetSize (), true, snr};
+  m_rx.push_back (rx);
+}
+
+void
+WifiPhyInterferenceOnlyTest::RxFailure (Ptr<Packet> p, double snr)
+{
+  Rx rx = {static_cast<uint32_t> (Simulator::Now ().GetSeconds ()), p->GetSize (), false, snr};
+  m_rx.push_back (rx);
+}
+
+void
+WifiPhyInterferenceOnlyTest::CheckRx (uint32_t scenario, uint32_t size, bool ok, double snr)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  uint32_t count = 0;
+  for (std::vector<Rx>::const_iterator it = m_rx.begin (); it != m_rx.end (); ++it)
+    {
+      if (it->scenario != scenario)
+        {
+          continue;
+        }
+      count++;
+      NS_TEST_EXPECT_MSG_EQ (it->size, size + hdr.GetSize () + WIFI_MAC_FCS_LENGTH, "Wrong frame received in scenario " << scenario);
+      NS_TEST_EXPECT_MSG_EQ (it->ok, ok, "Wrong reception result in scenario " << scenario);
+      if (ok && snr > 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ_TOL (it->snr, snr, snr * 0.01, "Wrong SNR in scenario " << scenario);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (count, 1, "Wrong number of receptions in scenario " << scenario);
+}
+
+void
+WifiPhyInterferenceOnlyTest::DoRun (void)
+{
+  m_phy = CreateObject<YansWifiPhy> ();
+  m_phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  m_phy->SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  m_phy->SetEdThreshold (-70);
+  m_phy->SetReceiveOkCallback (MakeCallback (&WifiPhyInterferenceOnlyTest::RxSuccess, this));
+  m_phy->SetReceiveErrorCallback (MakeCallback (&WifiPhyInterferenceOnlyTest::RxFailure, this));
+
+  WifiMode slow = WifiPhy::GetOfdmRate6Mbps ();
+  WifiMode fast = WifiPhy::GetOfdmRate54Mbps ();
+  //noise power with the default noise figure of 7 dB (W)
+  double noiseW = 1.3803e-23 * 290 * 20e6 * std::pow (10.0, 0.7);
+  double frameW = DbmToW (-65);
+
+  //1: a frame alone
+  Simulator::Schedule (Seconds (1), &WifiPhyInterferenceOnlyTest::SendSignal, this, fast, 1000, -65);
+  //2 and 3: a frame arriving during a signal below the energy detection
+  //threshold, strong enough to make it fail, or weak enough to let it succeed
+  Simulator::Schedule (Seconds (2), &WifiPhyInterferenceOnlyTest::SendSignal, this, slow, 1500, -72);
+  Simulator::Schedule (Seconds (2) + MicroSeconds (100), &WifiPhyInterferenceOnlyTest::SendSignal, this, fast, 1000, -65);
+  Simulator::Schedule (Seconds (3), &WifiPhyInterferenceOnlyTest::SendSignal, this, slow, 1500, -95);
+  Simulator::Schedule (Seconds (3) + MicroSeconds (100), &WifiPhyInterferenceOnlyTest::SendSignal, this, fast, 1000, -65);
+  //4 and 5: a signal arriving during the reception of a frame, strong enough
+  //to make it fail, or weak enough to let it succeed
+  Simulator::Schedule (Seconds (4), &WifiPhyInterferenceOnlyTest::SendSignal, this, fast, 1000, -65);
+  Simulator::Schedule (Seconds (4) + MicroSeconds (20), &WifiPhyInterferenceOnlyTest::SendSignal, this, slow, 1500, -68);
+  Simulator::Schedule (Seconds (5), &WifiPhyInterferenceOnlyTest::SendSignal, this, fast, 1000, -65);
+  Simulator::Schedule (Seconds (5) + MicroSeconds (20), &WifiPhyInterferenceOnlyTest::SendSignal, this, slow, 1500, -90);
+  //6 and 7: the same with frame capture, for a frame strong enough to be
+  //captured, and for a frame which is not
+  Ptr<SimpleFrameCaptureModel> capture = CreateObject<SimpleFrameCaptureModel> ();
+  capture->SetMargin (5);
+  Simulator::Schedule (Seconds (5.5), &WifiPhy::SetFrameCaptureModel, m_phy, capture);
+  Simulator::Schedule (Seconds (6), &WifiPhyInterferenceOnlyTest::SendSignal, this, fast, 1000, -65);
+  Simulator::Schedule (Seconds (6) + MicroSeconds (10), &WifiPhyInterferenceOnlyTest::SendSignal, this, slow, 500, -55);
+  Simulator::Schedule (Seconds (7), &WifiPhyInterferenceOnlyTest::SendSignal, this, fast, 1000, -65);
+  Simulator::Schedule (Seconds (7) + MicroSeconds (10), &WifiPhyInterferenceOnlyTest::SendSignal, this, slow, 500, -63);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  CheckRx (1, 1000, true, frameW / noiseW);
+  CheckRx (2, 1000, false, 0);
+  CheckRx (3, 1000, true, frameW / (noiseW + DbmToW (-95)));
+  CheckRx (4, 1000, false, 0);
+  CheckRx (5, 1000, true, 0);
+  CheckRx (6, 500, true, DbmToW (-55) / (noiseW + frameW));
+  CheckRx (7, 1000, false, 0);
+  m_phy->Dispose ();
+  m_phy = 0;
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -1715,6 +2984,16 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug2483TestCase, TestCase::QUICK); //Bug 2483
   AddTestCase (new Bug2831TestCase, TestCase::QUICK); //Bug 2831
   AddTestCase (new StaWifiMacScanningTestCase, TestCase::QUICK); //Bug 2399
+  AddTestCase (new YansWifiChannelIndexTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelBucketTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueIndexTest, TestCase::QUICK);
+  AddTestCase (new AbstractWifiPhyTest, TestCase::QUICK);
+  AddTestCase (new AbstractWifiPhyInterferenceTest, TestCase::QUICK);
+  AddTestCase (new BeaconCacheTest, TestCase::QUICK);
+  AddTestCase (new MacLowNavTest, TestCase::QUICK);
+  AddTestCase (new AthstatsBinaryTest, TestCase::QUICK);
+  AddTestCase (new WifiEnergyDeferredUpdateTest, TestCase::QUICK);
+  AddTestCase (new WifiPhyInterferenceOnlyTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite; ///< the test suite
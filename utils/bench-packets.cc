@@ -19,13 +19,18 @@
  */
 
 // This program can be used to benchmark packet serialization/deserialization
-// operations using Headers and Tags, for various numbers of packets 'n'
+// operations using Headers and Tags, for various numbers of packets 'n'.
+// For each benchmark, the number of Packet objects and buffer/tag blocks
+// requested per packet is reported, together with how many of those
+// requests had to go to the heap because the PacketPool free lists were
+// empty.
 // Sample usage:  ./waf --run 'bench-packets --n=10000'
 
 #include "ns3/command-line.h"
 #include "ns3/system-wall-clock-ms.h"
 #include "ns3/packet.h"
 #include "ns3/packet-metadata.h"
+#include "ns3/packet-pool.h"
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -343,18 +348,28 @@ static void
 runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char const *name)
 {
   uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+  PacketPool::ResetStats ();
   for (uint32_t i = 0; i < minIterations; i++)
     {
       uint64_t delay = runBenchOneIteration(bench, n);
       minDelay = std::min(minDelay, delay);
     }
+  PacketPool::Stats stats = PacketPool::GetStats ();
+  double total = static_cast<double> (n) * minIterations;
   double ps = n;
   ps *= 1000;
-  ps /= minDelay;
+  ps /= std::max<uint64_t> (minDelay, 1);
   std::cout << ps << " packets/s"
             << " (" << minDelay << " ms elapsed)\t"
             << name
             << std::endl;
+  std::cout << "  per packet: "
+            << (stats.nPacketAllocs + stats.nBlockAllocs) / total << " allocations, "
+            << (stats.nPacketHeapAllocs + stats.nBlockHeapAllocs) / total << " from the heap"
+            << " (packets " << stats.nPacketAllocs / total << "/" << stats.nPacketHeapAllocs / total
+            << ", blocks " << stats.nBlockAllocs / total << "/" << stats.nBlockHeapAllocs / total
+            << ")"
+            << std::endl;
 }
 
 int main (int argc, char *argv[])